@@ -0,0 +1,108 @@
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32) || defined(__linux__)
+#include <malloc.h>
+#endif
+
+namespace sevens {
+
+namespace {
+
+thread_local AllocationCounts counts;
+
+// Taille réelle du bloc, pour que les octets libérés se comparent aux octets alloués
+std::size_t blockSize(void* ptr, std::size_t requested) {
+#ifdef __linux__
+    (void)requested;
+    return malloc_usable_size(ptr);
+#else
+    (void)ptr;
+    return requested;
+#endif
+}
+
+void countFree(void* ptr) {
+#ifdef __linux__
+    if (ptr) {
+        counts.freedBytes += malloc_usable_size(ptr);
+    }
+#else
+    (void)ptr;
+#endif
+}
+
+void* countedAlloc(std::size_t size) {
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        ++counts.allocations;
+        counts.bytes += blockSize(ptr, size);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    // aligned_alloc exige une taille multiple de l'alignement
+    const std::size_t rounded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+    void* ptr = _aligned_malloc(rounded, alignment);
+#else
+    void* ptr = std::aligned_alloc(alignment, rounded);
+#endif
+    if (ptr) {
+        ++counts.allocations;
+        counts.bytes += blockSize(ptr, size);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void countedFree(void* ptr) {
+    countFree(ptr);
+    std::free(ptr);
+}
+
+void alignedFree(void* ptr) {
+    countFree(ptr);
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+} // namespace
+
+AllocationCounts threadAllocations() {
+    return counts;
+}
+
+} // namespace sevens
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Remplacement global de operator new/delete : toutes les allocations du programme passent par ici
+
+void* operator new(std::size_t size) { return sevens::countedAlloc(size); }
+void* operator new[](std::size_t size) { return sevens::countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return sevens::countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return sevens::countedAlignedAlloc(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return sevens::countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return sevens::countedAlloc(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { sevens::countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { sevens::countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { sevens::countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { sevens::countedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { sevens::alignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { sevens::alignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { sevens::alignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { sevens::alignedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { sevens::countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { sevens::countedFree(ptr); }
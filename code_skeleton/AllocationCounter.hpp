@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * Heap allocation counters, fed by the global operator new/delete
+ * replacements of AllocationCounter.cpp (linked into sevens_game).
+ * Counters are per thread, so reading them costs nothing and needs no lock.
+ */
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t freedBytes = 0; // Linux only (malloc_usable_size), 0 elsewhere
+};
+
+// Allocations made by the calling thread since it started
+AllocationCounts threadAllocations();
+
+} // namespace sevens
@@ -0,0 +1,327 @@
+#include "Analyzer.hpp"
+#include "CommandLine.hpp"
+#include "ResultsStore.hpp"
+#include "Simulator.hpp"
+#include "TranspositionTable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+template <class P, size_t>
+using SeatPolicy = P;
+
+template <class P, size_t... I>
+Simulator<SeatPolicy<P, I>...> uniformSimulator(std::index_sequence<I...>);
+
+// Continuations of the analysis: every seat plays the noisy MySmart heuristic
+template <uint64_t N>
+using Playout = decltype(uniformSimulator<policy::Explore<policy::Neighbour>>(std::make_index_sequence<N>{}));
+
+constexpr uint64_t kMaxCandidates = kNumSuits * kNumRanks + 1; // toutes les cartes, plus le passe
+
+// Value of each candidate move of `state`: mean number of cards the mover still holds at the end of the round
+template <uint64_t N>
+void evaluateCandidates(const GameState& state, const Move* candidates, uint64_t count, uint64_t key,
+                        uint64_t rollouts, double* values) {
+    const Playout<N> simulator;
+    const uint64_t mover = state.current;
+    for (uint64_t c = 0; c < count; ++c) {
+        GameState child = state;
+        child.apply(candidates[c]);
+        uint64_t cards = 0;
+        for (uint64_t r = 0; r < rollouts; ++r) {
+            // Mêmes flux aléatoires pour tous les candidats : seules leurs différences comptent
+            Xoshiro256 rng(key + r);
+            GameState playout = child;
+            simulator.rollout(playout, rng);
+            cards += cardCount(playout.hands[mover]);
+        }
+        values[c] = static_cast<double>(cards) / static_cast<double>(rollouts);
+    }
+}
+
+void evaluate(const GameState& state, const Move* candidates, uint64_t count, uint64_t key, uint64_t rollouts,
+              double* values) {
+    switch (state.numPlayers) {
+        case 3: return evaluateCandidates<3>(state, candidates, count, key, rollouts, values);
+        case 4: return evaluateCandidates<4>(state, candidates, count, key, rollouts, values);
+        case 5: return evaluateCandidates<5>(state, candidates, count, key, rollouts, values);
+        case 6: return evaluateCandidates<6>(state, candidates, count, key, rollouts, values);
+        case 7: return evaluateCandidates<7>(state, candidates, count, key, rollouts, values);
+        default: throw std::runtime_error("[Analyzer] Number of players must be between 3 and 7.");
+    }
+}
+
+// Keeps the `limit` costliest decisions of `worst`, costliest first
+void keepWorst(std::vector<DecisionLoss>& worst, const DecisionLoss& decision, uint64_t limit) {
+    if (worst.size() == limit && (limit == 0 || decision.loss <= worst.back().loss)) {
+        return;
+    }
+    const auto at = std::upper_bound(worst.begin(), worst.end(), decision,
+                                     [](const DecisionLoss& a, const DecisionLoss& b) { return a.loss > b.loss; });
+    worst.insert(at, decision);
+    if (worst.size() > limit) {
+        worst.pop_back();
+    }
+}
+
+// "rank/suit" (Ace = 1) or "pass"
+std::string moveName(int8_t card) {
+    if (card < 0) {
+        return "pass";
+    }
+    return std::to_string(card % kSuitStride + 1) + "/" + std::to_string(card / kSuitStride);
+}
+
+} // namespace
+
+void StrategyAnalysis::merge(const StrategyAnalysis& other) {
+    seatGames += other.seatGames;
+    decisions += other.decisions;
+    forced += other.forced;
+    optimal += other.optimal;
+    blunders += other.blunders;
+    loss += other.loss;
+}
+
+void AnalysisResults::merge(const AnalysisResults& other, uint64_t worstCount) {
+    if (strategies.size() < other.strategies.size()) {
+        strategies.resize(other.strategies.size());
+    }
+    for (size_t id = 0; id < other.strategies.size(); ++id) {
+        strategies[id].merge(other.strategies[id]);
+    }
+    for (const DecisionLoss& decision : other.worst) {
+        keepWorst(worst, decision, worstCount);
+    }
+    games += other.games;
+    rollouts += other.rollouts;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+Analyzer::Analyzer(const AnalyzeOptions& options) : options(options) {
+    games = readGameLog(options.log, rules);
+    if (options.games > 0 && games.size() > options.games) {
+        games.resize(options.games);
+    }
+    names = readStrategyNames(options.log);
+    for (const LoggedGame& game : games) {
+        for (uint64_t seat = 0; seat < game.numPlayers; ++seat) {
+            while (names.size() <= game.strategy[seat]) {
+                names.push_back("strategy-" + std::to_string(names.size()));
+            }
+        }
+    }
+    if (this->options.threads == 0) {
+        this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->options.rollouts < 2) {
+        this->options.rollouts = 2;
+    }
+}
+
+void Analyzer::analyzeGame(uint64_t index, AnalysisResults& local) const {
+    const LoggedGame& game = games[index];
+    for (uint64_t seat = 0; seat < game.numPlayers; ++seat) {
+        ++local.strategies[game.strategy[seat]].seatGames;
+    }
+    ++local.games;
+
+    uint64_t currentRound = 0;
+    uint64_t turn = 0;
+    replayGame(game, rules, [&](const GameState& state, Move move, uint64_t round) {
+        if (round != currentRound) {
+            currentRound = round;
+            turn = 0;
+        }
+        ++turn;
+        StrategyAnalysis& stats = local.strategies[game.strategy[move.player]];
+        const uint64_t legal = state.legalMoves();
+        if (!legal || (rules.fastForward && !(legal & (legal - 1)))) {
+            ++stats.forced; // aucun choix (ou coup joué par le moteur)
+            return;
+        }
+
+        // Candidats : chaque carte jouable, et le passe (permis même avec une carte jouable)
+        Move candidates[kMaxCandidates];
+        uint64_t count = 0;
+        uint64_t played = 0;
+        for (uint64_t rest = legal; rest; rest &= rest - 1) {
+            candidates[count] = Move::play(move.player, lowestCard(rest));
+            played = candidates[count].card == move.card ? count : played;
+            ++count;
+        }
+        candidates[count] = Move::pass(move.player);
+        played = move.isPass() ? count : played;
+        ++count;
+
+        // La moitié des continuations choisit le meilleur coup, l'autre moitié mesure l'écart :
+        // le minimum de valeurs bruitées, lui, serait biaisé vers le bas
+        const uint64_t key = splitMix64(options.seed ^ stateHash(state));
+        const uint64_t selection = options.rollouts / 2;
+        double values[kMaxCandidates];
+        evaluate(state, candidates, count, key, selection, values);
+        const uint64_t best = static_cast<uint64_t>(std::min_element(values, values + count) - values);
+        double loss = 0;
+        if (best != played) {
+            const Move pair[2] = {candidates[played], candidates[best]};
+            evaluate(state, pair, 2, key + selection, options.rollouts - selection, values);
+            loss = values[0] - values[1];
+            local.rollouts += 2 * (options.rollouts - selection);
+        }
+        local.rollouts += count * selection;
+
+        ++stats.decisions;
+        stats.loss += loss;
+        stats.optimal += best == played;
+        stats.blunders += loss >= 1;
+
+        DecisionLoss decision;
+        decision.game = index;
+        decision.round = static_cast<uint16_t>(round);
+        decision.turn = static_cast<uint16_t>(turn);
+        decision.seat = move.player;
+        decision.strategy = game.strategy[move.player];
+        decision.played = move.card;
+        decision.best = candidates[best].card;
+        decision.loss = static_cast<float>(loss);
+        keepWorst(local.worst, decision, options.worst);
+    });
+}
+
+AnalysisResults Analyzer::run() {
+    std::atomic<uint64_t> nextGame{0};
+    const uint64_t workers = std::max<uint64_t>(1, std::min<uint64_t>(options.threads, games.size()));
+    std::vector<AnalysisResults> partial(workers);
+    std::vector<std::thread> threads;
+    for (uint64_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            AnalysisResults& local = partial[w];
+            local.strategies.resize(names.size());
+            for (uint64_t g = nextGame++; g < games.size(); g = nextGame++) {
+                // Une partie qui ne se rejoue pas est ignorée en entier
+                AnalysisResults single;
+                single.strategies.resize(names.size());
+                try {
+                    analyzeGame(g, single);
+                } catch (const std::exception& e) {
+                    std::cerr << "[Analyzer] Game " << g << " skipped: " << e.what() << "\n";
+                    continue;
+                }
+                local.merge(single, options.worst);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    AnalysisResults results;
+    results.strategies.resize(names.size());
+    for (const auto& part : partial) {
+        results.merge(part, options.worst);
+    }
+    return results;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void Analyzer::printResults(const AnalysisResults& results, double seconds) const {
+    uint64_t decisions = 0;
+    for (const StrategyAnalysis& stats : results.strategies) {
+        decisions += stats.decisions;
+    }
+    std::cout << "[analyze] " << results.games << " games, " << decisions << " decisions graded with "
+              << options.rollouts << " rollouts per candidate move: " << results.rollouts << " rollouts in "
+              << std::fixed << std::setprecision(1) << seconds << " s (" << std::setprecision(0)
+              << results.rollouts / std::max(seconds, 1e-9) << " rollouts/s, " << options.threads << " threads)\n";
+    // "loss sum/game" additionne les pertes de toutes les décisions d'une partie, chacune mesurée
+    // seule contre le meilleur coup : un ordre de grandeur, pas les points réellement perdus par partie
+    std::cout << "  strategy                   decisions   best move   pts lost/move   loss sum/game   blunders   forced\n";
+    for (size_t id = 0; id < results.strategies.size(); ++id) {
+        const StrategyAnalysis& stats = results.strategies[id];
+        if (stats.seatGames == 0) {
+            continue;
+        }
+        const double graded = stats.decisions ? static_cast<double>(stats.decisions) : 1.0;
+        std::cout << "  " << std::left << std::setw(26) << names[id] << std::right << std::setw(10) << stats.decisions
+                  << std::setw(11) << std::setprecision(1) << 100.0 * stats.optimal / graded << "%" << std::setw(16)
+                  << std::setprecision(3) << stats.loss / graded << std::setw(16) << std::setprecision(2)
+                  << stats.loss / static_cast<double>(stats.seatGames) << std::setw(10) << std::setprecision(1)
+                  << 100.0 * stats.blunders / graded << "%" << std::setw(9) << stats.forced << "\n";
+    }
+
+    if (!results.worst.empty()) {
+        std::cout << "  Costliest decisions (card = rank/suit, Ace = 1):\n";
+        for (const DecisionLoss& decision : results.worst) {
+            std::cout << "    game " << decision.game << " (seed " << games[decision.game].seed << ") round "
+                      << decision.round + 1 << " turn " << decision.turn << ": " << names[decision.strategy] << "-"
+                      << static_cast<int>(decision.seat) << " played " << moveName(decision.played) << ", best "
+                      << moveName(decision.best) << ", " << std::setprecision(2) << decision.loss << " points lost\n";
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runAnalyzeMode(int argc, char* argv[]) {
+    AnalyzeOptions options;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--rollouts" && i + 1 < argc) {
+            if (!cli::parseCount("[analyze]", arg, argv[++i], options.rollouts)) {
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!cli::parseCount("[analyze]", arg, argv[++i], options.threads)) {
+                return 1;
+            }
+        } else if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[analyze]", arg, argv[++i], options.games)) {
+                return 1;
+            }
+        } else if (arg == "--worst" && i + 1 < argc) {
+            if (!cli::parseCount("[analyze]", arg, argv[++i], options.worst)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[analyze]", arg, argv[++i], options.seed)) {
+                return 1;
+            }
+        } else if (options.log.empty()) {
+            options.log = arg;
+        } else {
+            std::cerr << "[main] Unknown analyze option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (options.log.empty()) {
+        std::cerr << "[main] Usage: ./sevens_game analyze <game log> [--rollouts R] [--threads T] [--games N] [--worst K]"
+                     " [--seed S]\n"
+                  << "       (record a game log with ./sevens_game tournament --record <file> ...)\n";
+        return 1;
+    }
+
+    try {
+        Analyzer analyzer(options);
+        const auto start = std::chrono::steady_clock::now();
+        const AnalysisResults results = analyzer.run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        analyzer.printResults(results, seconds);
+    } catch (const std::exception& e) {
+        std::cerr << "[main] Analysis failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace sevens
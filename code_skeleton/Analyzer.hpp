@@ -0,0 +1,92 @@
+#pragma once
+
+#include "GameLog.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Settings of a decision-quality analysis ("analyze" mode of sevens_game).
+ */
+struct AnalyzeOptions {
+    std::string log;        // game log written by "tournament --record"
+    uint64_t rollouts = 32; // sampled continuations per candidate move (at least 2)
+    uint64_t threads = 0;   // 0 = one per core
+    uint64_t games = 0;     // analyse the first N games only (0 = all)
+    uint64_t worst = 10;    // costliest decisions listed
+    uint64_t seed = 0;      // seeds the continuations
+};
+
+/**
+ * One analysed decision: the move played and the best alternative found, with the
+ * expected penalty points of the round the player gave away by not playing it.
+ */
+struct DecisionLoss {
+    uint64_t game = 0; // index in the log
+    uint16_t round = 0;
+    uint16_t turn = 0; // turn of the round
+    uint8_t seat = 0;
+    uint16_t strategy = 0;
+    int8_t played = -1; // card index, -1 = pass
+    int8_t best = -1;
+    float loss = 0;
+};
+
+// Sums per strategy, merged exactly across threads
+struct StrategyAnalysis {
+    uint64_t seatGames = 0;
+    uint64_t decisions = 0;
+    uint64_t forced = 0;   // turns without any choice, not analysed
+    uint64_t optimal = 0;  // the move played was the best found
+    uint64_t blunders = 0; // loss of a point or more
+    double loss = 0;
+
+    void merge(const StrategyAnalysis& other);
+};
+
+struct AnalysisResults {
+    std::vector<StrategyAnalysis> strategies; // indexed by strategy id of the log
+    std::vector<DecisionLoss> worst;          // costliest first
+    uint64_t games = 0;
+    uint64_t rollouts = 0;
+
+    void merge(const AnalysisResults& other, uint64_t worstCount);
+};
+
+/**
+ * Replays recorded games and grades every decision that had a choice.
+ *
+ * Positions are rebuilt exactly (every hand is known), so the search is perfect-information:
+ * each candidate move (every legal card, and the pass) is followed by `rollouts` sampled
+ * continuations to the end of the round, played by the MySmart heuristic with one random move in
+ * 16 (policy::Explore<policy::Neighbour>). Its value is the mean number of cards the mover is left
+ * with. Half of the rollouts pick the best candidate; the other half value the move played against
+ * it, with the same random streams for both (common random numbers). The loss of a decision is
+ * that difference: the minimum of noisy values would be biased low, this estimate is not, so losses
+ * of strategies analysed with the same settings compare fairly.
+ * Games are spread over all cores; they are independent, so threads never synchronise.
+ */
+class Analyzer {
+public:
+    // @throws std::runtime_error if the log cannot be read.
+    explicit Analyzer(const AnalyzeOptions& options);
+
+    AnalysisResults run();
+
+    void printResults(const AnalysisResults& results, double seconds) const;
+
+private:
+    void analyzeGame(uint64_t index, AnalysisResults& local) const;
+
+    AnalyzeOptions options;
+    RoundRules rules;
+    std::vector<LoggedGame> games;
+    std::vector<std::string> names;
+};
+
+// Entry point of "./sevens_game analyze <game log> [--rollouts R] [--threads T] [--games N] [--worst K] [--seed S]"
+int runAnalyzeMode(int argc, char* argv[]);
+
+} // namespace sevens
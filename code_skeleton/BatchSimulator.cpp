@@ -0,0 +1,311 @@
+#include "BatchSimulator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEVENS_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sevens {
+
+uint64_t batchGameSeed(uint64_t masterSeed, uint64_t gameIndex) {
+    const uint64_t z = gameSeed(masterSeed, gameIndex);
+    return z ? z : 0x9E3779B97F4A7C15ULL; // xorshift ne doit jamais partir de 0
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+uint64_t greedyPick(uint64_t playable) {
+    // Rangs jouables toutes couleurs confondues, sans l'As (GreedyStrategy ne le joue jamais)
+    const uint64_t ranks = (playable | playable >> 16 | playable >> 32 | playable >> 48) & 0x1FFEULL;
+    if (!ranks) {
+        return 0;
+    }
+    const uint64_t rank = 63 - static_cast<uint64_t>(__builtin_clzll(ranks));
+    const uint64_t candidates = playable & (suitLanes(1ULL) << rank);
+    return candidates & (0 - candidates); // plus petite couleur
+}
+
+uint64_t randomPick(uint64_t playable, XorShift64& rng) {
+    if (!playable) {
+        return 0;
+    }
+    const uint64_t draw = rng() >> 32;
+    uint64_t k = (draw * cardCount(playable)) >> 32;
+    for (; k; --k) {
+        playable &= playable - 1;
+    }
+    return playable & (0 - playable);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+BatchSimulator::BatchSimulator(uint64_t numPlayers, uint64_t lanes, const std::vector<BatchPolicy>& policies, uint64_t masterSeed,
+                               uint64_t stallLimit)
+    : numPlayers(numPlayers), lanes(lanes), policies(policies), masterSeed(masterSeed), stallLimit(stallLimit) {
+    if (numPlayers < kMinPlayers || numPlayers > kMaxPlayers) {
+        throw std::runtime_error("[BatchSimulator] Number of players must be between 3 and 7.");
+    }
+    if (policies.size() != numPlayers) {
+        throw std::runtime_error("[BatchSimulator] One policy per seat is required.");
+    }
+    // Un multiple de 4 lanes pour que le noyau AVX2 n'ait pas de reste à traiter
+    this->lanes = std::max<uint64_t>(4, (lanes + 3) & ~3ULL);
+
+    table.assign(this->lanes, 0);
+    hands.assign(numPlayers * this->lanes, 0);
+    active.assign(this->lanes, 0);
+    rng.assign(this->lanes, 0);
+    points.assign(numPlayers * this->lanes, 0);
+    gameOfLane.assign(this->lanes, 0);
+    status.assign(this->lanes, Idle);
+    idleTurns.assign(this->lanes, 0);
+    before.assign(this->lanes, 0);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool BatchSimulator::simdAvailable() {
+#ifdef SEVENS_BATCH_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void BatchSimulator::startGame(uint64_t lane, uint64_t gameIndex) {
+    gameOfLane[lane] = gameIndex;
+    rng[lane] = batchGameSeed(masterSeed, gameIndex);
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        points[p * lanes + lane] = 0;
+    }
+    dealRound(lane);
+}
+
+void BatchSimulator::dealRound(uint64_t lane) {
+    GameState state;
+    state.reset(numPlayers);
+    XorShift64 generator{rng[lane]};
+    state.deal(kFullDeck, generator);
+    rng[lane] = generator.state;
+
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        hands[p * lanes + lane] = state.hands[p];
+    }
+    table[lane] = state.table;
+    idleTurns[lane] = 0;
+    status[lane] = Waiting;
+    active[lane] = 0;
+}
+
+void BatchSimulator::finishRound(uint64_t lane) {
+    bool gameOver = false;
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        uint16_t& score = points[p * lanes + lane];
+        score = static_cast<uint16_t>(score + cardCount(hands[p * lanes + lane]));
+        gameOver |= score >= kEndScore;
+    }
+    if (!gameOver) {
+        dealRound(lane);
+        return;
+    }
+
+    const uint64_t game = gameOfLane[lane];
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        results[game * numPlayers + p] = points[p * lanes + lane];
+    }
+    if (nextGame < totalGames) {
+        startGame(lane, nextGame++);
+    } else {
+        status[lane] = Idle;
+        active[lane] = 0;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void BatchSimulator::stepScalar(uint64_t seat) {
+    uint64_t* seatHands = hands.data() + seat * lanes;
+    const bool greedy = policies[seat] == BatchPolicy::Greedy;
+
+    for (uint64_t lane = 0; lane < lanes; ++lane) {
+        const uint64_t playable = playableMask(seatHands[lane], table[lane]) & active[lane];
+        uint64_t chosen;
+        if (greedy) {
+            chosen = greedyPick(playable);
+        } else {
+            XorShift64 generator{rng[lane]};
+            chosen = randomPick(playable, generator);
+            rng[lane] = generator.state;
+        }
+        seatHands[lane] &= ~chosen;
+        table[lane] |= chosen;
+    }
+}
+
+#ifdef SEVENS_BATCH_AVX2
+
+namespace {
+
+__attribute__((target("avx2"))) inline __m256i popcount64(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+    const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi64(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline __m256i lowestBit(__m256i v) {
+    return _mm256_and_si256(v, _mm256_sub_epi64(_mm256_setzero_si256(), v));
+}
+
+} // namespace
+
+__attribute__((target("avx2"))) void BatchSimulator::stepAvx2(uint64_t seat) {
+    uint64_t* seatHands = hands.data() + seat * lanes;
+    const bool greedy = policies[seat] == BatchPolicy::Greedy;
+
+    const __m256i fullDeck = _mm256_set1_epi64x(static_cast<long long>(kFullDeck));
+    const __m256i sevens = _mm256_set1_epi64x(static_cast<long long>(kSevensMask));
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (uint64_t lane = 0; lane < lanes; lane += 4) {
+        const __m256i hand = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seatHands + lane));
+        const __m256i tbl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(table.data() + lane));
+        const __m256i on = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(active.data() + lane));
+
+        // playableMask() sur 4 parties à la fois
+        const __m256i neighbours = _mm256_and_si256(
+            _mm256_or_si256(_mm256_slli_epi64(tbl, 1), _mm256_srli_epi64(tbl, 1)), fullDeck);
+        const __m256i closedSevens = _mm256_andnot_si256(tbl, sevens);
+        const __m256i playable = _mm256_and_si256(_mm256_and_si256(hand, _mm256_or_si256(neighbours, closedSevens)), on);
+
+        __m256i chosen;
+        if (greedy) {
+            // Rang le plus haut : exposant du double exact 2^52 + ranks
+            __m256i ranks = _mm256_or_si256(playable, _mm256_srli_epi64(playable, 16));
+            ranks = _mm256_or_si256(ranks, _mm256_srli_epi64(playable, 32));
+            ranks = _mm256_or_si256(ranks, _mm256_srli_epi64(playable, 48));
+            ranks = _mm256_and_si256(ranks, _mm256_set1_epi64x(0x1FFE));
+            const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL);
+            const __m256d asDouble = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(ranks, magic)),
+                                                   _mm256_castsi256_pd(magic));
+            const __m256i rank = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(asDouble), 52),
+                                                  _mm256_set1_epi64x(1023));
+            // ranks == 0 --> rank négatif --> décalage hors limites --> aucune carte
+            const __m256i column = _mm256_sllv_epi64(_mm256_set1_epi64x(static_cast<long long>(suitLanes(1ULL))), rank);
+            chosen = lowestBit(_mm256_and_si256(playable, column));
+        } else {
+            __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rng.data() + lane));
+            __m256i next = _mm256_xor_si256(state, _mm256_slli_epi64(state, 13));
+            next = _mm256_xor_si256(next, _mm256_srli_epi64(next, 7));
+            next = _mm256_xor_si256(next, _mm256_slli_epi64(next, 17));
+            // Le générateur n'avance que si la partie avait un coup à jouer
+            const __m256i draws = _mm256_andnot_si256(_mm256_cmpeq_epi64(playable, zero), _mm256_set1_epi64x(-1));
+            // Sélection explicite par masque : même résultat que le scalaire quel que soit le -march
+            state = _mm256_or_si256(_mm256_and_si256(draws, next), _mm256_andnot_si256(draws, state));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rng.data() + lane), state);
+
+            const __m256i k = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(next, 32), popcount64(playable)), 32);
+            __m256i rest = playable;
+            for (long long i = 0; i < static_cast<long long>(kNumRanks) - 1; ++i) {
+                const __m256i skip = _mm256_cmpgt_epi64(k, _mm256_set1_epi64x(i));
+                const __m256i dropped = _mm256_and_si256(rest, _mm256_sub_epi64(rest, _mm256_set1_epi64x(1)));
+                rest = _mm256_or_si256(_mm256_and_si256(skip, dropped), _mm256_andnot_si256(skip, rest));
+            }
+            chosen = lowestBit(rest);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(seatHands + lane), _mm256_andnot_si256(chosen, hand));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(table.data() + lane), _mm256_or_si256(tbl, chosen));
+    }
+}
+
+#else
+
+void BatchSimulator::stepAvx2(uint64_t seat) {
+    stepScalar(seat);
+}
+
+#endif
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+const std::vector<uint16_t>& BatchSimulator::run(uint64_t games, bool useSimd) {
+    const bool simd = useSimd && simdAvailable();
+    results.assign(games * numPlayers, 0);
+    totalGames = games;
+    nextGame = 0;
+    turns = 0;
+
+    std::fill(status.begin(), status.end(), Idle);
+    std::fill(active.begin(), active.end(), 0);
+    for (uint64_t lane = 0; lane < lanes && nextGame < totalGames; ++lane) {
+        startGame(lane, nextGame++);
+    }
+
+    uint64_t running = std::count(status.begin(), status.end(), Waiting);
+    for (uint64_t seat = 0; running > 0; seat = (seat + 1) % numPlayers) {
+        // Les manches commencent toutes au joueur 0
+        if (seat == 0) {
+            for (uint64_t lane = 0; lane < lanes; ++lane) {
+                if (status[lane] == Waiting) {
+                    status[lane] = Active;
+                    active[lane] = ~0ULL;
+                }
+            }
+        }
+
+        const uint64_t* seatHands = hands.data() + seat * lanes;
+        std::copy(seatHands, seatHands + lanes, before.begin());
+        if (simd) {
+            stepAvx2(seat);
+        } else {
+            stepScalar(seat);
+        }
+
+        running = 0;
+        for (uint64_t lane = 0; lane < lanes; ++lane) {
+            if (status[lane] == Active) {
+                ++turns;
+                idleTurns[lane] = seatHands[lane] != before[lane] ? 0 : idleTurns[lane] + 1;
+                // Fin de manche : main vide, ou manche bloquée (comptée comme une manche normale)
+                if (seatHands[lane] == 0 || (stallLimit && idleTurns[lane] >= stallLimit)) {
+                    finishRound(lane);
+                }
+            }
+            running += status[lane] != Idle;
+        }
+    }
+    return results;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+std::array<uint16_t, kMaxPlayers> BatchSimulator::playReference(uint64_t numPlayers, const std::vector<BatchPolicy>& policies,
+                                                                uint64_t masterSeed, uint64_t gameIndex, uint64_t stallLimit) {
+    XorShift64 generator{batchGameSeed(masterSeed, gameIndex)};
+    GameState state;
+    state.reset(numPlayers);
+
+    while (!state.isGameOver()) {
+        state.deal(kFullDeck, generator);
+        uint64_t idleTurns = 0;
+        while (!state.isTerminal() && !(stallLimit && idleTurns >= stallLimit)) {
+            const uint64_t playable = state.legalMoves();
+            const uint64_t chosen = policies[state.current] == BatchPolicy::Greedy
+                                        ? greedyPick(playable)
+                                        : randomPick(playable, generator);
+            state.apply(chosen ? Move::play(state.current, lowestCard(chosen)) : Move::pass(state.current));
+            idleTurns = chosen ? 0 : idleTurns + 1;
+        }
+        state.settleRound();
+    }
+    return state.points;
+}
+
+} // namespace sevens
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Built-in policies understood by the batch simulator. They mirror the
+ * decision rules of GreedyStrategy and RandomStrategy on card masks.
+ */
+enum class BatchPolicy : uint8_t {
+    Greedy,  // highest playable rank (Aces excluded, like GreedyStrategy), lowest suit on ties
+    Random   // uniform among playable cards
+};
+
+/**
+ * Tiny xorshift64 generator: one 64-bit word of state per game, cheap
+ * enough to be advanced in SIMD registers. Usable as a URBG (std::shuffle).
+ */
+struct XorShift64 {
+    using result_type = uint64_t;
+    uint64_t state;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// Seed of the generator of game `gameIndex` (independent of batch size and lane)
+uint64_t batchGameSeed(uint64_t masterSeed, uint64_t gameIndex);
+
+// Scalar policy kernels: choose a card bit among `playable` (0 = pass)
+uint64_t greedyPick(uint64_t playable);
+uint64_t randomPick(uint64_t playable, XorShift64& rng);
+
+/**
+ * Plays many games in lockstep, stored in structure-of-arrays layout:
+ *   table[lane], hands[seat * lanes + lane], points[seat * lanes + lane], rng[lane]
+ *
+ * Every step advances all lanes by one turn of the same seat, so the hands of
+ * the seat to move are contiguous and the legal-move / policy kernels run on
+ * 4 games per AVX2 instruction (scalar fallback elsewhere). A lane whose round
+ * ends is dealt again and waits for seat 0, which keeps all lanes on the same
+ * seat without changing the rules. A round in which `stallLimit` consecutive
+ * turns pass without a card played is settled as stalled, as in Engine
+ * (Greedy never plays its Aces, so an all-Greedy line-up needs it); 0 = no limit.
+ */
+class BatchSimulator {
+public:
+    BatchSimulator(uint64_t numPlayers, uint64_t lanes, const std::vector<BatchPolicy>& policies, uint64_t masterSeed,
+                   uint64_t stallLimit = kDefaultStallLimit);
+
+    // Plays games 0..games-1; returns the final points, numPlayers entries per game
+    const std::vector<uint16_t>& run(uint64_t games, bool useSimd = true);
+
+    // Number of decisions (turns) taken during the last run
+    uint64_t getTurns() const { return turns; }
+
+    static bool simdAvailable();
+
+    // Scalar reference: game `gameIndex` played on a GameState, one turn at a time
+    static std::array<uint16_t, kMaxPlayers> playReference(uint64_t numPlayers, const std::vector<BatchPolicy>& policies,
+                                                           uint64_t masterSeed, uint64_t gameIndex,
+                                                           uint64_t stallLimit = kDefaultStallLimit);
+
+private:
+    enum LaneStatus : uint8_t { Idle, Waiting, Active };
+
+    void startGame(uint64_t lane, uint64_t gameIndex);
+    void dealRound(uint64_t lane);
+    void finishRound(uint64_t lane);
+    void stepScalar(uint64_t seat);
+    void stepAvx2(uint64_t seat);
+
+    uint64_t numPlayers;
+    uint64_t lanes;
+    std::vector<BatchPolicy> policies;
+    uint64_t masterSeed;
+    uint64_t stallLimit;
+
+    // Structure of arrays
+    std::vector<uint64_t> table;
+    std::vector<uint64_t> hands;
+    std::vector<uint64_t> active;  // ~0 if the lane takes part in the current step, 0 otherwise
+    std::vector<uint64_t> rng;
+    std::vector<uint16_t> points;
+    std::vector<uint64_t> gameOfLane;
+    std::vector<uint8_t> status;
+    std::vector<uint64_t> idleTurns; // tours consécutifs sans carte jouée dans la manche
+    std::vector<uint64_t> before;    // mains du siège qui joue, avant le pas
+
+    std::vector<uint16_t> results;
+    uint64_t nextGame = 0;
+    uint64_t totalGames = 0;
+    uint64_t turns = 0;
+};
+
+} // namespace sevens
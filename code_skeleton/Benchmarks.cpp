@@ -0,0 +1,925 @@
+#include "Benchmarks.hpp"
+
+#ifdef STATIC_BUILD
+
+#include "AllocationCounter.hpp"
+#include "BatchSimulator.hpp"
+#include "CoroutineEngine.hpp"
+#include "Deal.hpp"
+#include "Engine.hpp"
+#include "Variant.hpp"
+#include "MyGameMapper.hpp"
+#include "RandomStrategy.hpp"
+#include "Simulator.hpp"
+#include "TranspositionTable.hpp"
+#include "GreedyStrategy.hpp"
+#include "HandAnalysis.hpp"
+#include "NeuralNet.hpp"
+#include "NeuralStrategy.hpp"
+#include "Dataset.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Seat 0 plays Random, the others Greedy (same line-up as the demo mode)
+std::vector<std::shared_ptr<PlayerStrategy>> builtInLineUp(uint64_t numPlayers) {
+    std::vector<std::shared_ptr<PlayerStrategy>> lineUp;
+    lineUp.push_back(std::make_shared<RandomStrategy>());
+    for (uint64_t p = 1; p < numPlayers; ++p) {
+        lineUp.push_back(std::make_shared<GreedyStrategy>());
+    }
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        lineUp[p]->initialize(p);
+    }
+    return lineUp;
+}
+
+// MyGameMapper (GameState driver) vs Engine<N> through the runtime dispatcher
+int benchEngine(uint64_t games) {
+    std::cout << "[bench] engine: " << games << " games per player count\n";
+    std::cout << "  players   mapper games/s   Engine<N> games/s   speedup\n";
+
+    for (uint64_t numPlayers = kMinPlayers; numPlayers <= kMaxPlayers; ++numPlayers) {
+        auto lineUp = builtInLineUp(numPlayers);
+
+        MyGameMapper mapper;
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            mapper.registerStrategy(p, lineUp[p]);
+        }
+        mapper.seed(42);
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t g = 0; g < games; ++g) {
+            mapper.compute_game_progress(numPlayers);
+        }
+        const double mapperSeconds = secondsSince(start);
+
+        std::vector<PlayerStrategy*> seats;
+        for (auto& strategy : lineUp) {
+            seats.push_back(strategy.get());
+        }
+        Xoshiro256 rng(42);
+        start = std::chrono::steady_clock::now();
+        for (uint64_t g = 0; g < games; ++g) {
+            playGame(seats, kFullDeck, rng);
+        }
+        const double engineSeconds = secondsSince(start);
+
+        std::cout << "  " << std::setw(7) << numPlayers
+                  << std::setw(17) << std::fixed << std::setprecision(0) << games / mapperSeconds
+                  << std::setw(20) << games / engineSeconds
+                  << std::setw(9) << std::setprecision(2) << mapperSeconds / engineSeconds << "x\n";
+    }
+    return 0;
+}
+
+// Greedy kernel must take the same decision as GreedyStrategy on the same position
+bool greedyKernelMatchesStrategy(uint64_t positions) {
+    GreedyStrategy strategy;
+    strategy.initialize(0);
+    XorShift64 generator{batchGameSeed(7, 0)};
+    std::vector<Card> hand;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+
+    for (uint64_t i = 0; i < positions; ++i) {
+        const uint64_t table = (generator() & kFullDeck) | kSevensMask;
+        const uint64_t cards = generator() & kFullDeck & ~table;
+        handToCards(cards, hand);
+        tableToLayout(table, layout);
+
+        const int index = strategy.selectCardToPlay(hand, layout);
+        const uint64_t expected = index < 0 ? 0 : cardBit(hand[index].suit, hand[index].rank);
+        if (greedyPick(playableMask(cards, table)) != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Greedy only: nobody plays the Aces, rounds end on the stall limit, in the batch as in the reference
+bool stalledRoundsMatch(uint64_t lanes) {
+    const std::vector<BatchPolicy> greedyOnly(3, BatchPolicy::Greedy);
+    const uint64_t games = 200, stallLimit = 50;
+    BatchSimulator batch(3, lanes, greedyOnly, 2024, stallLimit);
+    const std::vector<uint16_t>& results = batch.run(games);
+    bool same = true;
+    for (uint64_t g = 0; g < games; ++g) {
+        const auto reference = BatchSimulator::playReference(3, greedyOnly, 2024, g, stallLimit);
+        same &= std::equal(reference.begin(), reference.begin() + 3, results.begin() + g * 3);
+    }
+    std::cout << "  3 x Greedy, stall limit " << stallLimit << ": " << games << " games == GameState reference : "
+              << (same ? "yes" : "NO") << "\n";
+    return same;
+}
+
+// SoA batch simulator: scalar fallback vs AVX2, checked against the GameState reference
+int benchBatch(uint64_t games, uint64_t lanes) {
+    const uint64_t numPlayers = 4;
+    const std::vector<BatchPolicy> policies = {BatchPolicy::Random, BatchPolicy::Greedy, BatchPolicy::Greedy, BatchPolicy::Greedy};
+    const uint64_t seed = 2024;
+    std::cout << "[bench] batch: " << games << " games, " << lanes << " lanes, Random + 3 x Greedy\n";
+    std::cout << "  greedy kernel == GreedyStrategy : " << (greedyKernelMatchesStrategy(100000) ? "yes" : "NO") << "\n";
+
+    BatchSimulator scalar(numPlayers, lanes, policies, seed);
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<uint16_t> scalarResults = scalar.run(games, false);
+    const double scalarSeconds = secondsSince(start);
+    std::cout << "  scalar : " << std::fixed << std::setprecision(1) << scalar.getTurns() / scalarSeconds / 1e6
+              << " M moves/s, " << std::setprecision(0) << games / scalarSeconds << " games/s\n";
+
+    const uint64_t checked = std::min<uint64_t>(games, 2000);
+    bool sameAsReference = true;
+    for (uint64_t g = 0; g < checked; ++g) {
+        const auto reference = BatchSimulator::playReference(numPlayers, policies, seed, g);
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            sameAsReference &= reference[p] == scalarResults[g * numPlayers + p];
+        }
+    }
+    std::cout << "  first " << checked << " games == GameState reference : " << (sameAsReference ? "yes" : "NO") << "\n";
+
+    if (!BatchSimulator::simdAvailable()) {
+        std::cout << "  AVX2 not available on this machine, scalar fallback only\n";
+        const bool stalledSame = stalledRoundsMatch(lanes);
+        return sameAsReference && stalledSame ? 0 : 1;
+    }
+    BatchSimulator simd(numPlayers, lanes, policies, seed);
+    start = std::chrono::steady_clock::now();
+    const std::vector<uint16_t>& simdResults = simd.run(games, true);
+    const double simdSeconds = secondsSince(start);
+    std::cout << "  AVX2   : " << std::setprecision(1) << simd.getTurns() / simdSeconds / 1e6
+              << " M moves/s, " << std::setprecision(0) << games / simdSeconds << " games/s\n";
+    const bool sameAsScalar = simdResults == scalarResults;
+    std::cout << "  AVX2 results == scalar results : " << (sameAsScalar ? "yes" : "NO") << "\n";
+    const bool stalledSame = stalledRoundsMatch(lanes); // toujours exécuté, même si un contrôle a échoué
+    return sameAsReference && sameAsScalar && stalledSame ? 0 : 1;
+}
+
+// Seat 0 Random, the others Greedy: a Random seat keeps Greedy's unplayed Aces from stalling a round
+std::vector<BatchPolicy> variantPolicies(uint64_t numPlayers) {
+    std::vector<BatchPolicy> policies(numPlayers, BatchPolicy::Greedy);
+    policies[0] = BatchPolicy::Random;
+    return policies;
+}
+
+template <class V, class Seats>
+void benchVariant(uint64_t games, const Seats& seats, const char* label) {
+    VariantEngine<V> engine(seats);
+    uint64_t rounds = 0;
+    uint64_t turns = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t g = 0; g < games; ++g) {
+        XorShift64 generator{batchGameSeed(2024, g)};
+        const auto outcome = engine.play(generator);
+        rounds += outcome.rounds;
+        turns += outcome.turns;
+    }
+    const double seconds = secondsSince(start);
+    std::cout << "  " << std::left << std::setw(22) << V::describe() << std::setw(11) << label << std::right
+              << std::setw(8) << seats.size() << std::setw(7) << V::kWords << std::setw(12) << std::fixed
+              << std::setprecision(0) << games / seconds << std::setw(12) << std::setprecision(1)
+              << turns / seconds / 1e6 << std::setw(12) << std::setprecision(2) << static_cast<double>(rounds) / games
+              << "\n";
+}
+
+template <class V>
+void benchVariant(uint64_t games, uint64_t numPlayers) {
+    benchVariant<V>(games, variantPolicies(numPlayers), "policies");
+}
+
+// Same line-up as variantPolicies(), as PlayerStrategy instances
+template <class V>
+void benchVariantStrategies(uint64_t games, uint64_t numPlayers) {
+    std::vector<std::shared_ptr<PlayerStrategy>> lineUp = builtInLineUp(numPlayers);
+    std::vector<PlayerStrategy*> seats;
+    for (auto& strategy : lineUp) {
+        seats.push_back(strategy.get());
+    }
+    benchVariant<V>(games, seats, "strategies");
+}
+
+// All-Greedy line-ups stall: policies must match playReference, GreedyStrategy seats must match playGame
+bool stalledVariantsMatch(uint64_t games) {
+    const uint64_t stallLimit = 50;
+    RoundRules rules;
+    rules.stallLimit = stallLimit;
+    const std::vector<BatchPolicy> policies(kMinPlayers, BatchPolicy::Greedy);
+    VariantEngine<StandardVariant> engine(policies, rules);
+    bool samePolicies = true;
+    uint64_t stalled = 0;
+    for (uint64_t g = 0; g < games; ++g) {
+        const auto reference = BatchSimulator::playReference(kMinPlayers, policies, 2024, g, stallLimit);
+        XorShift64 generator{batchGameSeed(2024, g)};
+        const auto outcome = engine.play(generator);
+        samePolicies &= std::equal(outcome.points.begin(), outcome.points.begin() + kMinPlayers, reference.begin());
+        stalled += outcome.stalledRounds;
+    }
+
+    std::vector<std::shared_ptr<PlayerStrategy>> lineUp;
+    std::vector<PlayerStrategy*> seats;
+    for (uint64_t p = 0; p < 4; ++p) {
+        lineUp.push_back(std::make_shared<GreedyStrategy>());
+        seats.push_back(lineUp.back().get());
+    }
+    VariantEngine<StandardVariant> strategyEngine(seats, rules);
+    bool sameStrategies = true;
+    for (uint64_t g = 0; g < games; ++g) {
+        Xoshiro256 engineRng(gameSeed(2024, g));
+        const GameOutcome expected = playGame(seats, kFullDeck, engineRng, rules);
+        Xoshiro256 variantRng(gameSeed(2024, g));
+        const auto outcome = strategyEngine.play(variantRng);
+        sameStrategies &= outcome.rounds == expected.rounds && outcome.stalledRounds == expected.stalledRounds &&
+                          std::equal(outcome.points.begin(), outcome.points.begin() + 4, expected.points.begin()) &&
+                          std::equal(outcome.rank.begin(), outcome.rank.begin() + 4, expected.rank.begin());
+        stalled += outcome.stalledRounds;
+    }
+    std::cout << "  all Greedy, stall limit " << stallLimit << " (" << stalled << " stalled rounds): 3 policies == "
+              << "GameState reference : " << (samePolicies ? "yes" : "NO") << ", 4 GreedyStrategy == playGame : "
+              << (sameStrategies ? "yes" : "NO") << "\n";
+    return samePolicies && sameStrategies;
+}
+
+// Variant engine: standard game against the hand-written GameState loop, then scaling with deck size and players
+int benchVariants(uint64_t games) {
+    const uint64_t numPlayers = 4;
+    const std::vector<BatchPolicy> policies = variantPolicies(numPlayers);
+    std::cout << "[bench] variants: " << games << " games per configuration, seat 0 Random, others Greedy\n";
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::array<uint16_t, kMaxPlayers>> reference(games);
+    for (uint64_t g = 0; g < games; ++g) {
+        reference[g] = BatchSimulator::playReference(numPlayers, policies, 2024, g);
+    }
+    const double referenceSeconds = secondsSince(start);
+
+    VariantEngine<StandardVariant> engine(policies);
+    bool same = true;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t g = 0; g < games; ++g) {
+        XorShift64 generator{batchGameSeed(2024, g)};
+        const auto outcome = engine.play(generator);
+        same &= std::equal(outcome.points.begin(), outcome.points.begin() + numPlayers, reference[g].begin());
+    }
+    const double variantSeconds = secondsSince(start);
+    std::cout << "  standard 4 players: GameState loop " << std::fixed << std::setprecision(0) << games / referenceSeconds
+              << " games/s, VariantEngine<StandardVariant> " << games / variantSeconds << " games/s ("
+              << std::setprecision(2) << referenceSeconds / variantSeconds << "x), identical results: "
+              << (same ? "yes" : "NO") << "\n";
+
+    const bool stalledSame = stalledVariantsMatch(std::min<uint64_t>(games, 200));
+
+    std::cout << "  variant               seats       players  words     games/s   M moves/s  rounds/game\n";
+    for (uint64_t players : {3, 5, 7}) {
+        benchVariant<StandardVariant>(games, players);
+    }
+    benchVariantStrategies<StandardVariant>(games, 4);
+    for (uint64_t players : {4, 8, 16}) {
+        benchVariant<Variant<4, 13, 2, 16>>(games, players);
+    }
+    benchVariantStrategies<Variant<4, 13, 2, 16>>(games, 8);
+    for (uint64_t players : {8, 16}) {
+        benchVariant<Variant<4, 13, 4, 16>>(games, players);
+    }
+    benchVariant<Variant<6, 15, 2, 16>>(games, 16);
+    benchVariantStrategies<Variant<6, 15, 2, 16>>(games / 4, 16);
+    benchVariant<Variant<8, 15, 4, 16, 7, 100>>(games / 4, 16);
+    return same && stalledSame ? 0 : 1;
+}
+
+// Round deal: the original vector<Card> path, std::shuffle into masks, then dealInto with both generators
+int benchDeal(uint64_t deals) {
+    const uint64_t numPlayers = 4;
+    std::cout << "[bench] deal: " << deals << " deals of 52 cards to " << numPlayers << " players\n";
+    uint64_t checksum = 0;
+
+    std::vector<Card> cards;
+    for (uint64_t suit = 0; suit < kNumSuits; ++suit) {
+        for (uint64_t rank = 0; rank < kNumRanks; ++rank) {
+            cards.emplace_back(suit, rank);
+        }
+    }
+    std::unordered_map<uint64_t, std::vector<Card>> playerHands;
+    std::mt19937 mersenne(42);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t d = 0; d < deals; ++d) {
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            playerHands[p].clear();
+        }
+        std::shuffle(cards.begin(), cards.end(), mersenne);
+        for (size_t i = 0; i < cards.size(); ++i) {
+            playerHands[i % numPlayers].push_back(cards[i]);
+        }
+        checksum += playerHands[0].front().rank;
+    }
+    const double vectorSeconds = secondsSince(start);
+
+    std::array<uint64_t, kMaxPlayers> hands{};
+    start = std::chrono::steady_clock::now();
+    for (uint64_t d = 0; d < deals; ++d) {
+        uint8_t order[64];
+        uint64_t count = 0;
+        for (uint64_t rest = kFullDeck; rest; rest &= rest - 1) {
+            order[count++] = static_cast<uint8_t>(lowestCard(rest));
+        }
+        std::shuffle(order, order + count, mersenne);
+        hands.fill(0);
+        for (uint64_t i = 0; i < count; ++i) {
+            hands[i % numPlayers] |= 1ULL << order[i];
+        }
+        checksum += hands[0];
+    }
+    const double shuffleSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t d = 0; d < deals; ++d) {
+        dealInto(kFullDeck, numPlayers, mersenne, hands.data());
+        checksum += hands[0];
+    }
+    const double mersenneSeconds = secondsSince(start);
+
+    Xoshiro256 xoshiro(42);
+    start = std::chrono::steady_clock::now();
+    for (uint64_t d = 0; d < deals; ++d) {
+        dealInto(kFullDeck, numPlayers, xoshiro, hands.data());
+        checksum += hands[0];
+    }
+    const double xoshiroSeconds = secondsSince(start);
+
+    auto line = [&](const char* name, double seconds) {
+        std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(8) << std::fixed
+                  << std::setprecision(1) << seconds / deals * 1e9 << " ns/deal" << std::setw(8)
+                  << std::setprecision(2) << vectorSeconds / seconds << "x\n";
+    };
+    line("vector<Card> + std::shuffle (mt19937)", vectorSeconds);
+    line("masks + std::shuffle (mt19937)", shuffleSeconds);
+    line("dealInto (mt19937)", mersenneSeconds);
+    line("dealInto (Xoshiro256)", xoshiroSeconds);
+
+    // Chaque carte doit tomber chez chaque joueur avec la même fréquence
+    std::array<std::array<uint64_t, kMaxPlayers>, 64> seen{};
+    for (uint64_t d = 0; d < deals; ++d) {
+        dealInto(kFullDeck, numPlayers, xoshiro, hands.data());
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            for (uint64_t rest = hands[p]; rest; rest &= rest - 1) {
+                ++seen[lowestCard(rest)][p];
+            }
+        }
+    }
+    double worst = 0;
+    for (uint64_t rest = kFullDeck; rest; rest &= rest - 1) {
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            const double expected = static_cast<double>(deals) * (p < kNumSuits * kNumRanks % numPlayers ? 14 : 13) / 52;
+            worst = std::max(worst, std::abs(seen[lowestCard(rest)][p] - expected) / std::sqrt(expected));
+        }
+    }
+    std::cout << "  uniformity: worst card/player deviation " << std::setprecision(2) << worst << " sigma\n";
+
+    // Classement : rang(déal) puis déal(rang) doit revenir au point de départ
+    bool roundTrip = true;
+    for (uint64_t players = kMinPlayers; players <= kMaxPlayers; ++players) {
+        for (uint64_t d = 0; d < 1000; ++d) {
+            const Deal deal = dealFromSeed(d, players);
+            const DealIndex index = rankDeal(deal);
+            const Deal back = unrankDeal(index, players);
+            roundTrip &= back.hands == deal.hands && DealIndex::fromString(index.toString()) == index;
+        }
+        bool outOfRange = false;
+        try {
+            unrankDeal(dealCount(players), players);
+        } catch (const std::runtime_error&) {
+            outOfRange = true;
+        }
+        roundTrip &= outOfRange && rankDeal(unrankDeal(0, players)) == DealIndex(0);
+        std::cout << "  " << players << " players: " << dealCount(players).toString() << " deals\n";
+    }
+    std::cout << "  rank/unrank round trip : " << (roundTrip ? "yes" : "NO") << " (checksum " << checksum % 1000 << ")\n";
+    return roundTrip ? 0 : 1;
+}
+
+// Rollouts to the end of a round: PlayerStrategy virtual calls on containers vs Simulator<Policies...> functors
+int benchRollout(uint64_t rollouts) {
+    const uint64_t numPlayers = 4;
+    std::cout << "[bench] rollout: " << rollouts << " rollouts from a 4-player round after 8 turns, seat 0 Random, others Greedy\n";
+
+    // Position de départ commune : une donne, puis quelques coups joués
+    GameState start;
+    start.reset(numPlayers);
+    Xoshiro256 dealer(7);
+    start.deal(kFullDeck, dealer);
+    for (uint64_t t = 0; t < 8; ++t) {
+        const uint64_t chosen = policy::GreedyHighest{}(start, start.legalMoves(), dealer);
+        start.apply(chosen ? Move::play(start.current, lowestCard(chosen)) : Move::pass(start.current));
+    }
+
+    // Chemin virtuel : ce que doit faire aujourd'hui une stratégie de recherche
+    auto lineUp = builtInLineUp(numPlayers);
+    TableLayout::Map layout;
+    TableLayout tableLayout(layout);
+    std::array<std::vector<Card>, kMaxPlayers> handCards;
+    uint64_t virtualPoints = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rollouts; ++r) {
+        GameState state = start;
+        tableLayout.reset(state.table);
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            handToCards(state.hands[p], handCards[p]);
+        }
+        uint64_t idleTurns = 0; // même limite de blocage que Simulator
+        while (!state.isTerminal() && idleTurns < kDefaultStallLimit) {
+            const uint64_t p = state.current;
+            const int chosen = lineUp[p]->selectCardToPlay(handCards[p], layout);
+            Move move = Move::pass(p);
+            if (chosen >= 0 && static_cast<size_t>(chosen) < handCards[p].size()) {
+                const Card card = handCards[p][chosen];
+                if (state.legalMoves() & cardBit(card.suit, card.rank)) {
+                    move = Move::play(p, cardIndex(card.suit, card.rank));
+                    tableLayout.place(card.suit, card.rank);
+                    handCards[p].erase(handCards[p].begin() + chosen);
+                }
+            }
+            state.apply(move);
+            idleTurns = move.isPass() ? idleTurns + 1 : 0;
+        }
+        const auto scores = state.scores();
+        virtualPoints += scores[1] + scores[2] + scores[3];
+    }
+    const double virtualSeconds = secondsSince(begin);
+
+    Simulator<policy::Random, policy::GreedyHighest, policy::GreedyHighest, policy::GreedyHighest> simulator;
+    Xoshiro256 rng(11);
+    uint64_t simulatorPoints = 0;
+    uint64_t checksum = 0;
+    begin = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rollouts; ++r) {
+        const auto scores = simulator.rolloutScores(start, rng);
+        simulatorPoints += scores[1] + scores[2] + scores[3];
+    }
+    const double simulatorSeconds = secondsSince(begin);
+
+    Simulator<policy::Random, policy::Neighbour, policy::GreedyHighest, policy::Neighbour> smart;
+    begin = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rollouts; ++r) {
+        checksum += smart.rolloutScores(start, rng)[1];
+    }
+    const double smartSeconds = secondsSince(begin);
+
+    std::cout << "  PlayerStrategy (virtual, containers)   " << std::fixed << std::setprecision(0) << rollouts / virtualSeconds
+              << " rollouts/s\n";
+    std::cout << "  Simulator<Random, Greedy x3>           " << rollouts / simulatorSeconds << " rollouts/s ("
+              << std::setprecision(1) << virtualSeconds / simulatorSeconds << "x)\n";
+    std::cout << "  Simulator<Random, Neighbour, Greedy, Neighbour> " << std::setprecision(0) << rollouts / smartSeconds
+              << " rollouts/s\n";
+
+    // Parties complètes : doivent rejouer exactement la référence GameState du batch simulator
+    const std::vector<BatchPolicy> policies = variantPolicies(numPlayers);
+    const uint64_t games = std::min<uint64_t>(rollouts / 10, 20000);
+    bool same = true;
+    for (uint64_t g = 0; g < games; ++g) {
+        XorShift64 generator{batchGameSeed(2024, g)};
+        const auto points = simulator.play(kFullDeck, generator);
+        same &= points == BatchSimulator::playReference(numPlayers, policies, 2024, g);
+    }
+    // Greedy seulement : ses As jamais joués bloquent des manches, arrêtées par la limite
+    Simulator<policy::GreedyHighest, policy::GreedyHighest, policy::GreedyHighest> greedyOnly;
+    greedyOnly.setStallLimit(50);
+    const std::vector<BatchPolicy> greedyPolicies(3, BatchPolicy::Greedy);
+    for (uint64_t g = 0; g < std::min<uint64_t>(games, 200); ++g) {
+        XorShift64 generator{batchGameSeed(2024, g)};
+        same &= greedyOnly.play(kFullDeck, generator) == BatchSimulator::playReference(3, greedyPolicies, 2024, g, 50);
+    }
+    std::cout << "  " << games << " full games, and 3 x Greedy with stall limit 50, == GameState reference : "
+              << (same ? "yes" : "NO")
+              << "\n  mean points per Greedy seat: " << std::setprecision(2)
+              << static_cast<double>(virtualPoints) / (3 * rollouts) << " virtual, "
+              << static_cast<double>(simulatorPoints) / (3 * rollouts) << " simulator (checksum " << checksum % 1000 << ")\n";
+    return same ? 0 : 1;
+}
+
+// Évaluation par rollouts d'une position : chaque coup légal est estimé par `rollouts` parties simulées,
+// sauf si la table connaît déjà la position qui en résulte
+template <class Sim>
+uint64_t evaluatePosition(const GameState& state, const Sim& simulator, TranspositionTable& table, uint64_t rollouts,
+                          Xoshiro256& rng) {
+    uint64_t played = 0;
+    const uint64_t mover = state.current;
+    for (uint64_t rest = state.legalMoves(); rest; rest &= rest - 1) {
+        GameState child = state;
+        child.apply(Move::play(mover, lowestCard(rest)));
+        const uint64_t key = stateHash(child);
+        TTEntry entry;
+        if (table.probe(key, entry) && entry.visits >= rollouts) {
+            continue;
+        }
+        uint64_t penalty = 0;
+        for (uint64_t r = 0; r < rollouts; ++r) {
+            GameState playout = child;
+            simulator.rollout(playout, rng);
+            penalty += cardCount(playout.hands[mover]);
+        }
+        played += rollouts;
+        entry.value = static_cast<float>(penalty) / static_cast<float>(rollouts);
+        entry.visits = static_cast<uint16_t>(rollouts);
+        entry.move = TTEntry::kNoMove;
+        table.store(key, entry);
+    }
+    return played;
+}
+
+// Rollout search over the same positions on `threads` threads: one shared table vs one private table per thread
+int benchTransposition(uint64_t positions, uint64_t threads) {
+    const uint64_t numPlayers = 4;
+    const uint64_t rollouts = 16;
+    std::cout << "[bench] tt: " << positions << " positions, " << threads << " threads, " << rollouts
+              << " rollouts per legal move, every thread searching every position (lazy SMP)\n";
+
+    // Positions de self-play où le joueur a le choix
+    const Simulator<policy::Neighbour, policy::Neighbour, policy::Neighbour, policy::Neighbour> simulator;
+    std::vector<GameState> workload;
+    for (uint64_t g = 0; workload.size() < positions; ++g) {
+        Xoshiro256 rng(gameSeed(44, g));
+        GameState state;
+        state.reset(numPlayers);
+        state.deal(kFullDeck, rng);
+        uint64_t idleTurns = 0;
+        while (!state.isTerminal() && idleTurns < kDefaultStallLimit && workload.size() < positions) {
+            const uint64_t playable = state.legalMoves();
+            if (cardCount(playable) >= 2) {
+                workload.push_back(state);
+            }
+            const uint64_t chosen = policy::Neighbour{}(state, playable, rng);
+            state.apply(chosen ? Move::play(state.current, lowestCard(chosen)) : Move::pass(state.current));
+            idleTurns = chosen ? 0 : idleTurns + 1;
+        }
+    }
+
+    std::cout << "  table     mode       rollouts    time (s)   hit rate   evictions   full buckets   occupancy\n";
+    for (const uint64_t megabytes : {1ULL, 64ULL}) {
+        for (const bool shared : {false, true}) {
+            std::vector<std::unique_ptr<TranspositionTable>> tables;
+            for (uint64_t t = 0; t < (shared ? 1 : threads); ++t) {
+                tables.push_back(std::make_unique<TranspositionTable>(megabytes));
+            }
+            std::vector<uint64_t> played(threads, 0);
+            const auto begin = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (uint64_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t]() {
+                    TranspositionTable& table = *tables[shared ? 0 : t];
+                    Xoshiro256 rng(gameSeed(45, t));
+                    // Chaque thread parcourt toutes les positions, à partir d'un point différent
+                    for (uint64_t i = 0; i < workload.size(); ++i) {
+                        const GameState& state = workload[(i + t * workload.size() / threads) % workload.size()];
+                        played[t] += evaluatePosition(state, simulator, table, rollouts, rng);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            const double seconds = secondsSince(begin);
+
+            TranspositionTable::Stats stats;
+            uint64_t occupancy = 0;
+            for (const auto& table : tables) {
+                const TranspositionTable::Stats part = table->getStats();
+                stats.probes += part.probes;
+                stats.hits += part.hits;
+                stats.evictions += part.evictions;
+                stats.fullBuckets += part.fullBuckets;
+                occupancy += table->occupancyPermille();
+            }
+            uint64_t total = 0;
+            for (uint64_t count : played) {
+                total += count;
+            }
+            std::cout << "  " << std::setw(4) << megabytes << " MB   " << std::left << std::setw(9)
+                      << (shared ? "shared" : "private") << std::right << std::setw(11) << total << std::setw(12)
+                      << std::fixed << std::setprecision(2) << seconds << std::setw(10) << std::setprecision(1)
+                      << 100.0 * stats.hitRate() << "%" << std::setw(12) << stats.evictions << std::setw(15)
+                      << stats.fullBuckets << std::setw(11) << occupancy / 10.0 / tables.size() << "%\n";
+        }
+    }
+    return 0;
+}
+
+// Random network of NeuralStrategy's shape on self-play positions: every kernel the CPU supports must
+// give the scalar scores to the bit, then bestMove() is timed with each
+// Games between NeuralStrategy seats: the rows they rebuild from notifications == the rows the dataset export writes
+bool neuralRowsMatchDataset(const NeuralNetwork& network) {
+    const uint64_t gamesPerCount = 40;
+    const auto shared = std::shared_ptr<const NeuralNetwork>(&network, [](const NeuralNetwork*) {});
+    uint64_t checked = 0;
+    bool same = true;
+    for (uint64_t numPlayers = kMinPlayers; numPlayers <= kMaxPlayers; ++numPlayers) {
+        std::vector<std::unique_ptr<NeuralStrategy>> strategies;
+        std::vector<PlayerStrategy*> seats;
+        std::vector<std::vector<uint8_t>> rebuilt(numPlayers);
+        for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+            strategies.push_back(std::make_unique<NeuralStrategy>(shared));
+            strategies.back()->recordRows(&rebuilt[seat]);
+            seats.push_back(strategies.back().get());
+        }
+        const std::vector<uint8_t> strategyIds(numPlayers, 0);
+        std::vector<int8_t> moves;
+        std::vector<uint8_t> exported;
+        for (uint64_t g = 0; g < gamesPerCount; ++g) {
+            for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+                seats[seat]->initialize(seat);
+                rebuilt[seat].clear();
+            }
+            const uint64_t seed = gameSeed(numPlayers, g);
+            Xoshiro256 rng(seed);
+            moves.clear();
+            exported.clear();
+            const GameOutcome outcome = playGame(seats, kFullDeck, rng, RoundRules{}, DecisionMemo{}, &moves);
+            DatasetExporter::encodeGame(moves, seed, outcome.rank, outcome.points, strategyIds, RoundRules{}, false,
+                                        exported);
+            // Les lignes exportées suivent l'ordre des coups : celles d'un siège, dans l'ordre de ses décisions
+            std::vector<size_t> next(numPlayers, 0);
+            for (size_t row = 0; row < exported.size(); row += features::kWidth, ++checked) {
+                const uint64_t seat = exported[row + features::kSeat];
+                const size_t offset = next[seat]++ * features::kInputs;
+                same &= offset + features::kInputs <= rebuilt[seat].size() &&
+                        std::memcmp(exported.data() + row, rebuilt[seat].data() + offset, features::kInputs) == 0;
+            }
+            for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+                same &= next[seat] * features::kInputs == rebuilt[seat].size();
+            }
+        }
+    }
+    std::cout << "  dataset replay, " << kMinPlayers << " to " << kMaxPlayers << " players: " << checked
+              << " rows rebuilt by NeuralStrategy == exported rows : " << (same ? "yes" : "NO") << "\n";
+    return same;
+}
+
+int benchNeural(uint64_t positions, uint64_t hidden) {
+    hidden = std::clamp<uint64_t>(hidden, 1, neural::kMaxWidth);
+    positions = std::max<uint64_t>(1, positions);
+    std::cout << "[bench] neural: random " << features::kInputs << "-" << hidden << "-" << hidden << "-"
+              << neural::kOutputs << " network, " << positions << " positions of 4-player Neighbour self-play\n";
+
+    // Poids et biais uniformes ; multiplicateurs à l'échelle de l'entrée, pour des activations étalées dans 0..127
+    Xoshiro256 rng(50);
+    const uint64_t widths[] = {features::kInputs, hidden, hidden, neural::kOutputs};
+    std::vector<neural::Layer> layers;
+    for (uint64_t l = 0; l + 1 < std::size(widths); ++l) {
+        neural::Layer layer = neural::makeLayer(widths[l], widths[l + 1]);
+        const double inputScale = l == 0 ? 1.0 : 48.0;
+        for (uint64_t o = 0; o < layer.outputs; ++o) {
+            for (uint64_t i = 0; i < layer.inputs; ++i) {
+                layer.weights[o * layer.stride + i] = static_cast<int8_t>(static_cast<uint8_t>(rng() >> 56));
+            }
+            layer.bias[o] = static_cast<int32_t>(rng() % 4096) - 2048;
+            layer.multiplier[o] = static_cast<float>(32.0 / (std::sqrt(static_cast<double>(layer.inputs)) * 74.0 * inputScale));
+        }
+        layers.push_back(std::move(layer));
+    }
+    // Le réseau passe par save() et le chargeur : c'est la copie relue qui est mesurée
+    const NeuralNetwork built(std::move(layers));
+    const std::string path = (std::filesystem::temp_directory_path() / "sevens_bench_neural.bin").string();
+    built.save(path);
+    NeuralNetwork network(path);
+
+    std::vector<std::array<uint8_t, features::kWidth>> rows;
+    rows.reserve(positions);
+    const policy::Neighbour play;
+    for (uint64_t g = 0; rows.size() < positions; ++g) {
+        Xoshiro256 deal(gameSeed(50, g));
+        GameState state;
+        state.reset(4);
+        state.deal(kFullDeck, deal);
+        features::RoundHistory history;
+        history.start(state);
+        uint64_t idleTurns = 0;
+        while (!state.isTerminal() && idleTurns < kDefaultStallLimit && rows.size() < positions) {
+            const uint64_t mover = state.current;
+            rows.emplace_back();
+            features::encode(state.hands[mover], state.table, 4, mover, 0, 0, history, rows.back().data());
+            const uint64_t chosen = play(state, state.legalMoves(), deal);
+            state.apply(chosen ? Move::play(mover, lowestCard(chosen)) : Move::pass(mover));
+            history.record(mover, !chosen);
+            idleTurns = chosen ? 0 : idleTurns + 1;
+        }
+    }
+
+    std::vector<float> reference(positions * neural::kOutputs);
+    std::vector<float> scores(reference.size());
+    bool same = true;
+    std::cout << "  kernel   scores == scalar   bestMove (us)   checksum\n";
+    for (const neural::Kernel kernel : {neural::Kernel::Scalar, neural::Kernel::Ssse3, neural::Kernel::Avx2}) {
+        if (!neural::kernelSupported(kernel)) {
+            std::cout << "  " << std::left << std::setw(9) << neural::kernelName(kernel) << std::right
+                      << "not supported by this CPU\n";
+            continue;
+        }
+        network.setKernel(kernel);
+        std::vector<float>& out = kernel == neural::Kernel::Scalar ? reference : scores;
+        for (uint64_t r = 0; r < positions; ++r) {
+            network.evaluate(rows[r].data(), out.data() + r * neural::kOutputs);
+        }
+        const bool identical = std::memcmp(out.data(), reference.data(), out.size() * sizeof(float)) == 0;
+        same &= identical;
+
+        uint64_t checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t r = 0; r < positions; ++r) {
+            checksum += network.bestMove(rows[r].data());
+        }
+        const double seconds = secondsSince(start);
+        std::cout << "  " << std::left << std::setw(9) << neural::kernelName(kernel) << std::right << std::setw(16)
+                  << (identical ? "yes" : "NO") << std::setw(16) << std::fixed << std::setprecision(2)
+                  << seconds / positions * 1e6 << std::setw(11) << checksum << "\n";
+    }
+
+    std::vector<float> builtScores(neural::kOutputs);
+    bool loaded = true;
+    for (uint64_t r = 0; r < positions; ++r) {
+        built.evaluate(rows[r].data(), builtScores.data());
+        loaded &= std::memcmp(builtScores.data(), reference.data() + r * neural::kOutputs,
+                              neural::kOutputs * sizeof(float)) == 0;
+    }
+    std::cout << "  saved to " << path << " and loaded back: scores == in-memory network : "
+              << (loaded ? "yes" : "NO") << "\n";
+    const bool replayed = neuralRowsMatchDataset(network);
+    return same && loaded && replayed ? 0 : 1;
+}
+
+#ifdef SEVENS_HAS_COROUTINES
+
+// Deterministic policy for the comparisons (RandomStrategy is seeded from the clock)
+class LowestPlayableStrategy : public PlayerStrategy {
+public:
+    void initialize(uint64_t) override {}
+    int selectCardToPlay(const std::vector<Card>& hand,
+                         const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override {
+        const uint64_t playable = playableMask(handMask(hand), tableMask(tableLayout));
+        for (size_t i = 0; i < hand.size(); ++i) {
+            if (playable & cardBit(hand[i].suit, hand[i].rank)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    void observeMove(uint64_t, const Card&) override {}
+    void observePass(uint64_t) override {}
+    std::string getName() const override { return "LowestPlayable"; }
+};
+
+// One game at a time through playGame() vs `inFlight` interleaved coroutine games on one thread
+int benchCoroutines(uint64_t games, uint64_t inFlight) {
+    const uint64_t numPlayers = 4;
+    const uint64_t seed = 2024;
+    std::cout << "[bench] coro: " << games << " games, " << inFlight << " in flight, 4 x LowestPlayable\n";
+
+    std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+    for (uint64_t i = 0; i < numPlayers * (inFlight + 1); ++i) {
+        strategies.push_back(std::make_shared<LowestPlayableStrategy>());
+    }
+    auto seatsOf = [&](uint64_t lineUp) {
+        std::vector<PlayerStrategy*> seats;
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            seats.push_back(strategies[lineUp * numPlayers + p].get());
+        }
+        return seats;
+    };
+
+    std::vector<GameOutcome> sequential(games);
+    const std::vector<PlayerStrategy*> sequentialSeats = seatsOf(inFlight);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t g = 0; g < games; ++g) {
+        Xoshiro256 rng(gameSeed(seed, g));
+        sequential[g] = playGame(sequentialSeats, kFullDeck, rng);
+    }
+    const double sequentialSeconds = secondsSince(start);
+
+    std::vector<GameOutcome> interleaved(games);
+    GameScheduler scheduler;
+    uint64_t next = 0;
+    std::function<void(uint64_t)> startNext = [&](uint64_t slot) {
+        const uint64_t g = next++;
+        if (g >= games) {
+            return;
+        }
+        Xoshiro256 rng(gameSeed(seed, g));
+        scheduler.spawn(playGameAsync(scheduler, seatsOf(slot), kFullDeck, rng), [&, g, slot](const GameOutcome& outcome) {
+            interleaved[g] = outcome;
+            startNext(slot);
+        });
+    };
+    start = std::chrono::steady_clock::now();
+    for (uint64_t slot = 0; slot < inFlight; ++slot) {
+        startNext(slot);
+    }
+    scheduler.run();
+    const double interleavedSeconds = secondsSince(start);
+
+    bool same = true;
+    for (uint64_t g = 0; g < games; ++g) {
+        same &= sequential[g].rank == interleaved[g].rank && sequential[g].points == interleaved[g].points &&
+                sequential[g].rounds == interleaved[g].rounds;
+    }
+    std::cout << "  playGame   : " << std::fixed << std::setprecision(0) << games / sequentialSeconds << " games/s\n";
+    std::cout << "  coroutines : " << games / interleavedSeconds << " games/s, "
+              << std::setprecision(1) << static_cast<double>(scheduler.getDecisions()) / std::max<uint64_t>(1, scheduler.getBatches())
+              << " decisions per batch\n";
+    std::cout << "  outcomes identical : " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+#endif // SEVENS_HAS_COROUTINES
+
+uint64_t argOr(int argc, char* argv[], int index, uint64_t fallback) {
+    return argc > index ? std::stoull(argv[index]) : fallback;
+}
+
+} // namespace
+
+int runAllocationCheck(int argc, char* argv[]) {
+    const uint64_t games = argOr(argc, argv, 2, 1000);
+    bool ok = true;
+
+    for (uint64_t numPlayers = kMinPlayers; numPlayers <= kMaxPlayers; ++numPlayers) {
+        auto lineUp = builtInLineUp(numPlayers);
+        std::vector<PlayerStrategy*> seats;
+        for (auto& strategy : lineUp) {
+            seats.push_back(strategy.get());
+        }
+        Xoshiro256 rng(123);
+        playGame(seats, kFullDeck, rng); // partie de chauffe : buffers et noeuds alloués ici
+
+        uint64_t worst = 0;
+        for (uint64_t g = 0; g < games; ++g) {
+            const AllocationCounts before = threadAllocations();
+            playGame(seats, kFullDeck, rng);
+            worst = std::max(worst, threadAllocations().allocations - before.allocations);
+        }
+        std::cout << "[alloccheck] " << numPlayers << " players, " << games << " games: at most "
+                  << worst << " allocation(s) per game\n";
+        ok &= worst == 0;
+    }
+
+#ifdef NDEBUG
+    std::cout << "[alloccheck] " << (ok ? "PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+#else
+    std::cout << "[alloccheck] " << (ok ? "PASSED" : "allocations found (not enforced without NDEBUG)") << "\n";
+    return 0;
+#endif
+}
+
+int runBenchmarks(int argc, char* argv[]) {
+    const std::string which = argc > 2 ? argv[2] : "engine";
+    if (which == "engine") {
+        return benchEngine(argOr(argc, argv, 3, 2000));
+    }
+    if (which == "batch") {
+        return benchBatch(argOr(argc, argv, 3, 200000), argOr(argc, argv, 4, 1024));
+    }
+    if (which == "variants") {
+        return benchVariants(argOr(argc, argv, 3, 20000));
+    }
+    if (which == "rollout") {
+        return benchRollout(argOr(argc, argv, 3, 200000));
+    }
+    if (which == "deal") {
+        return benchDeal(argOr(argc, argv, 3, 1000000));
+    }
+    if (which == "tt") {
+        return benchTransposition(argOr(argc, argv, 3, 20000), argOr(argc, argv, 4, 4));
+    }
+    if (which == "neural") {
+        return benchNeural(argOr(argc, argv, 3, 100000), argOr(argc, argv, 4, 64));
+    }
+#ifdef SEVENS_HAS_COROUTINES
+    if (which == "coro") {
+        return benchCoroutines(argOr(argc, argv, 3, 20000), argOr(argc, argv, 4, 256));
+    }
+#endif
+    std::cerr << "[bench] Unknown benchmark: " << which << "\n";
+    std::cerr << "Available benchmarks : engine, batch, variants, deal, rollout, tt, neural, coro (C++20 builds)\n";
+    return 1;
+}
+
+} // namespace sevens
+
+#endif // STATIC_BUILD
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace sevens {
+
+/**
+ * Micro-benchmarks of the simulation code ("bench" mode of sevens_game).
+ *   ./sevens_game bench engine [games]
+ *   ./sevens_game bench batch [games] [lanes]
+ *   ./sevens_game bench variants [games]
+ *   ./sevens_game bench deal [deals]
+ *   ./sevens_game bench rollout [rollouts]
+ *   ./sevens_game bench tt [positions] [threads]
+ *   ./sevens_game bench neural [positions] [hidden width]
+ *   ./sevens_game bench coro [games] [in-flight]   (C++20 coroutines)
+ * Only available in STATIC_BUILD, since it plays the built-in strategies.
+ */
+int runBenchmarks(int argc, char* argv[]);
+
+/**
+ * "alloccheck" mode: plays games through the Engine<N> dispatcher and checks
+ * that, once the first game has warmed the buffers up, a game performs no
+ * heap allocation at all. Fails (exit code 1) in release builds (NDEBUG).
+ *   ./sevens_game alloccheck [games]
+ */
+int runAllocationCheck(int argc, char* argv[]);
+
+} // namespace sevens
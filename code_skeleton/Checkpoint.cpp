@@ -0,0 +1,286 @@
+#include "Checkpoint.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sevens {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'E', 'V', 'S', 'C', 'K', 'P', '1'};
+constexpr uint32_t kVersion = 1;
+
+uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+class SnapshotWriter {
+public:
+    template <class T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain values only");
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void put(const std::string& text) {
+        put(static_cast<uint32_t>(text.size()));
+        bytes += text;
+    }
+
+    std::string bytes;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const std::string& bytes, const std::string& path) : bytes(bytes), path(path) {}
+
+    template <class T>
+    T get() {
+        T value;
+        need(sizeof(value));
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+    std::string getString() {
+        const uint32_t size = get<uint32_t>();
+        need(size);
+        std::string text = bytes.substr(offset, size);
+        offset += size;
+        return text;
+    }
+
+private:
+    void need(size_t size) const {
+        if (offset + size > bytes.size()) {
+            throw std::runtime_error("[Checkpoint] " + path + " is truncated.");
+        }
+    }
+
+    const std::string& bytes;
+    const std::string& path;
+    size_t offset = 0;
+};
+
+void putUsage(SnapshotWriter& out, const StrategyUsage& usage) {
+    out.put(usage.decisions);
+    out.put(usage.observations);
+    out.put(usage.cpuNanos);
+    out.put(usage.allocations);
+    out.put(usage.allocatedBytes);
+    out.put(usage.retainedBytes);
+}
+
+StrategyUsage getUsage(SnapshotReader& in) {
+    StrategyUsage usage;
+    usage.decisions = in.get<uint64_t>();
+    usage.observations = in.get<uint64_t>();
+    usage.cpuNanos = in.get<uint64_t>();
+    usage.allocations = in.get<uint64_t>();
+    usage.allocatedBytes = in.get<uint64_t>();
+    usage.retainedBytes = in.get<int64_t>();
+    return usage;
+}
+
+} // namespace
+
+TournamentCheckpoint::TournamentCheckpoint(const std::string& path, const TournamentOptions& options, uint64_t blockSize)
+    : path(path), options(options), blockSize(blockSize), blockCount((options.games + blockSize - 1) / blockSize),
+      completed(blockCount, 0) {
+    results.seats.resize(options.libraries.size());
+}
+
+TournamentCheckpoint::~TournamentCheckpoint() {
+    try {
+        stop();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool TournamentCheckpoint::load() {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < sizeof(kMagic) + sizeof(uint64_t) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("[Checkpoint] " + path + " is not a tournament checkpoint.");
+    }
+    const size_t body = bytes.size() - sizeof(uint64_t);
+    uint64_t checksum;
+    std::memcpy(&checksum, bytes.data() + body, sizeof(checksum));
+    if (checksum != fnv1a(bytes.data(), body)) {
+        throw std::runtime_error("[Checkpoint] " + path + " is corrupted (bad checksum).");
+    }
+
+    SnapshotReader in(bytes, path);
+    in.get<std::array<char, sizeof(kMagic)>>();
+    if (in.get<uint32_t>() != kVersion) {
+        throw std::runtime_error("[Checkpoint] " + path + " was written by another version.");
+    }
+
+    // Identité du tournoi : un point de reprise ne sert qu'à la même partie de la même série
+    bool same = in.get<uint64_t>() == options.libraries.size();
+    for (size_t i = 0; same && i < options.libraries.size(); ++i) {
+        same = in.getString() == options.libraries[i];
+    }
+    same = same && in.get<uint64_t>() == options.seed && in.get<uint64_t>() == options.games &&
+           in.get<uint64_t>() == options.firstGame && in.get<uint64_t>() == options.rules.stallLimit &&
+           in.get<uint8_t>() == static_cast<uint8_t>(options.rules.fastForward);
+    if (!same) {
+        throw std::runtime_error("[Checkpoint] " + path +
+                                 " belongs to another tournament (libraries, seed, games and rules must be the same).");
+    }
+
+    blockSize = in.get<uint64_t>();
+    blockCount = in.get<uint64_t>();
+    if (blockSize == 0 || blockCount != (options.games + blockSize - 1) / blockSize) {
+        throw std::runtime_error("[Checkpoint] " + path + " is corrupted (block count).");
+    }
+    completed.assign(blockCount, 0);
+    for (uint64_t base = 0; base < blockCount; base += 8) {
+        const uint8_t bits = in.get<uint8_t>();
+        for (uint64_t b = base; b < blockCount && b < base + 8; ++b) {
+            completed[b] = (bits >> (b - base)) & 1;
+        }
+    }
+
+    results = TournamentResults{};
+    results.seats.resize(options.libraries.size());
+    for (SeatStats& seat : results.seats) {
+        seat.name = in.getString();
+        seat.games = in.get<uint64_t>();
+        seat.wins = in.get<uint64_t>();
+        seat.lastPlaces = in.get<uint64_t>();
+        seat.rankSum = in.get<uint64_t>();
+        seat.points = in.get<uint64_t>();
+        seat.usage = getUsage(in);
+    }
+    results.games = in.get<uint64_t>();
+    results.rounds = in.get<uint64_t>();
+    results.stalledRounds = in.get<uint64_t>();
+    results.skippedCalls = in.get<uint64_t>();
+    results.memo.lookups = in.get<uint64_t>();
+    results.memo.hits = in.get<uint64_t>();
+    results.memo.timedMisses = in.get<uint64_t>();
+    results.memo.timedNanos = in.get<uint64_t>();
+    return true;
+}
+
+void TournamentCheckpoint::save() {
+    std::vector<std::pair<uint64_t, TournamentResults>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(pending);
+    }
+    for (auto& [block, partial] : finished) {
+        completed[block] = 1;
+        results.merge(partial);
+    }
+
+    SnapshotWriter out;
+    out.put(kMagic);
+    out.put(kVersion);
+    out.put(static_cast<uint64_t>(options.libraries.size()));
+    for (const auto& library : options.libraries) {
+        out.put(library);
+    }
+    out.put(options.seed);
+    out.put(options.games);
+    out.put(options.firstGame);
+    out.put(options.rules.stallLimit);
+    out.put(static_cast<uint8_t>(options.rules.fastForward));
+    out.put(blockSize);
+    out.put(blockCount);
+    for (uint64_t base = 0; base < blockCount; base += 8) {
+        uint8_t bits = 0;
+        for (uint64_t b = base; b < blockCount && b < base + 8; ++b) {
+            bits |= static_cast<uint8_t>(completed[b] << (b - base));
+        }
+        out.put(bits);
+    }
+    for (const SeatStats& seat : results.seats) {
+        out.put(seat.name);
+        out.put(seat.games);
+        out.put(seat.wins);
+        out.put(seat.lastPlaces);
+        out.put(seat.rankSum);
+        out.put(seat.points);
+        putUsage(out, seat.usage);
+    }
+    out.put(results.games);
+    out.put(results.rounds);
+    out.put(results.stalledRounds);
+    out.put(results.skippedCalls);
+    out.put(results.memo.lookups);
+    out.put(results.memo.hits);
+    out.put(results.memo.timedMisses);
+    out.put(results.memo.timedNanos);
+    out.put(fnv1a(out.bytes.data(), out.bytes.size()));
+
+    // Écriture dans un fichier temporaire puis rename : un arrêt brutal laisse l'ancien point de reprise intact
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(out.bytes.data(), static_cast<std::streamsize>(out.bytes.size()));
+        if (!file) {
+            throw std::runtime_error("[Checkpoint] Cannot write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("[Checkpoint] Cannot replace " + path);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void TournamentCheckpoint::complete(uint64_t block, TournamentResults&& partial) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.emplace_back(block, std::move(partial));
+}
+
+void TournamentCheckpoint::start(double intervalSeconds) {
+    stopping = false;
+    thread = std::thread([this, intervalSeconds]() { run(intervalSeconds); });
+}
+
+void TournamentCheckpoint::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+    save(); // dernier instantané : tous les blocs terminés
+}
+
+void TournamentCheckpoint::run(double intervalSeconds) {
+    const auto interval = std::chrono::duration<double>(intervalSeconds);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this]() { return stopping; })) {
+        lock.unlock();
+        try {
+            save();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n"; // le tournoi continue, le prochain instantané réessaiera
+        }
+        lock.lock();
+    }
+}
+
+} // namespace sevens
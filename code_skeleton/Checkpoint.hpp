@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Tournament.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Snapshot of a tournament in progress ("tournament --checkpoint <file>", continued with --resume).
+ *
+ * Games are handed out in blocks of consecutive indices. The results of a block reach the
+ * snapshot only once all its games are played, so a snapshot always covers an exact set of
+ * games: the completed blocks, and the sum of their statistics. Every game draws from its own
+ * random stream, gameSeed(seed, firstGame + index), and strategies are initialised at every
+ * game, so nothing else needs saving: a resumed run plays the missing blocks with the same
+ * streams and, statistics being integer sums, prints the same table as an uninterrupted run.
+ * Resource usage and decision cache counters measure the machine and are only accumulated.
+ *
+ * Layout (native byte order), a few hundred bytes plus one bit per block:
+ *   "SEVSCKP1", version, the identity of the run (libraries, seed, games, first game, rules),
+ *   the block size, the completed-block bitmap, the aggregated TournamentResults, and a
+ *   FNV-1a checksum of all of it.
+ *
+ * Workers hand finished blocks over under a mutex held for a vector push; merging and writing
+ * happen on a background thread ("<file>.tmp" then rename: a crash leaves the previous snapshot
+ * intact), so checkpointing never stalls them.
+ */
+class TournamentCheckpoint {
+public:
+    TournamentCheckpoint(const std::string& path, const TournamentOptions& options, uint64_t blockSize);
+    ~TournamentCheckpoint();
+    TournamentCheckpoint(const TournamentCheckpoint&) = delete;
+    TournamentCheckpoint& operator=(const TournamentCheckpoint&) = delete;
+
+    // Reads the snapshot of this run (block size included); false if there is none yet.
+    // @throws std::runtime_error if the file is corrupted or belongs to another tournament.
+    bool load();
+
+    uint64_t getBlockSize() const { return blockSize; }
+    uint64_t getBlockCount() const { return blockCount; }
+
+    // Blocks already in the snapshot (1 = done). Read before the workers start.
+    const std::vector<uint8_t>& getCompleted() const { return completed; }
+
+    // Statistics of the blocks in the snapshot. Read before start() or after stop().
+    const TournamentResults& getResults() const { return results; }
+
+    // Called by a worker when every game of `block` is played
+    void complete(uint64_t block, TournamentResults&& partial);
+
+    // Writes a snapshot every `intervalSeconds` on a background thread, and a last one in stop()
+    void start(double intervalSeconds);
+    void stop();
+
+private:
+    void run(double intervalSeconds);
+    void save();
+
+    std::string path;
+    TournamentOptions options;
+    uint64_t blockSize;
+    uint64_t blockCount;
+    std::vector<uint8_t> completed;
+    TournamentResults results;
+
+    std::mutex mutex; // protège pending et stopping
+    std::condition_variable wake;
+    std::vector<std::pair<uint64_t, TournamentResults>> pending;
+    bool stopping = false;
+    std::thread thread;
+};
+
+} // namespace sevens
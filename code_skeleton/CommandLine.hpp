@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Option values of the command-line modes. Each parser takes the whole text (no sign, no
+ * trailing characters), prints "<tag> <option> takes ..." on std::cerr and returns false
+ * otherwise, so that the mode can return 1 instead of aborting on an uncaught exception.
+ */
+namespace cli {
+
+inline bool parseCount(const std::string& tag, const std::string& option, const std::string& text, uint64_t& value) {
+    size_t used = 0;
+    try {
+        if (!text.empty() && text[0] >= '0' && text[0] <= '9') { // stoull accepterait "-3" (modulo 2^64)
+            value = std::stoull(text, &used);
+        }
+    } catch (const std::logic_error&) { // invalid_argument, out_of_range
+        used = 0;
+    }
+    if (used == 0 || used != text.size()) {
+        std::cerr << tag << " " << option << " takes a non-negative integer, not '" << text << "'\n";
+        return false;
+    }
+    return true;
+}
+
+inline bool parseReal(const std::string& tag, const std::string& option, const std::string& text, double& value) {
+    size_t used = 0;
+    try {
+        if (!text.empty() && text[0] != '-' && text[0] != '+') {
+            value = std::stod(text, &used);
+        }
+    } catch (const std::logic_error&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || !std::isfinite(value)) {
+        std::cerr << tag << " " << option << " takes a finite non-negative number, not '" << text << "'\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace cli
+
+} // namespace sevens
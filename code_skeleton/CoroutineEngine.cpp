@@ -0,0 +1,201 @@
+#include "CoroutineEngine.hpp"
+
+#ifdef SEVENS_HAS_COROUTINES
+
+#include <algorithm>
+
+namespace sevens {
+
+GameTask& GameTask::operator=(GameTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, {});
+    }
+    return *this;
+}
+
+GameTask::~GameTask() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+GameScheduler::GameScheduler(Resolver resolver) : resolver(std::move(resolver)) {
+    if (!this->resolver) {
+        // Par défaut : décisions synchrones, prises à la suite pour tout le lot
+        this->resolver = [](std::vector<DecisionRequest*>& requests) {
+            for (DecisionRequest* request : requests) {
+                request->choice = request->strategy->selectCardToPlay(*request->hand, *request->layout);
+                request->ready = true;
+            }
+        };
+    }
+}
+
+void GameScheduler::spawn(GameTask task, Completion onDone) {
+    size_t slot = running.size();
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        running.emplace_back();
+    }
+    task.getHandle().promise().slot = slot;
+    ready.push_back(task.getHandle());
+    running[slot] = Running{std::move(task), std::move(onDone)};
+    ++live;
+}
+
+GameScheduler::DecisionAwaiter GameScheduler::decide(
+    PlayerStrategy* strategy, uint64_t playerID, const std::vector<Card>& hand,
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout) {
+    DecisionRequest request;
+    request.strategy = strategy;
+    request.playerID = playerID;
+    request.hand = &hand;
+    request.layout = &layout;
+    return DecisionAwaiter(*this, request);
+}
+
+void GameScheduler::DecisionAwaiter::await_suspend(std::coroutine_handle<> game) {
+    // L'awaiter vit dans le frame de la partie suspendue : son adresse reste valable jusqu'à la reprise
+    request.game = game;
+    scheduler.pending.push_back(&request);
+}
+
+void GameScheduler::finish(size_t slot) {
+    Running done = std::move(running[slot]);
+    running[slot] = Running{};
+    freeSlots.push_back(slot);
+    --live;
+
+    const GameTask::promise_type& promise = done.task.getHandle().promise();
+    if (promise.error) {
+        std::rethrow_exception(promise.error);
+    }
+    if (done.onDone) {
+        done.onDone(promise.outcome); // peut lancer la partie suivante dans le slot libéré
+    }
+}
+
+void GameScheduler::run() {
+    std::vector<std::coroutine_handle<>> resuming;
+    while (live > 0) {
+        // 1. Chaque partie prête avance jusqu'à sa prochaine décision (ou jusqu'à la fin)
+        while (!ready.empty()) {
+            resuming.swap(ready);
+            for (std::coroutine_handle<> game : resuming) {
+                game.resume();
+                if (game.done()) {
+                    finish(std::coroutine_handle<GameTask::promise_type>::from_address(game.address()).promise().slot);
+                }
+            }
+            resuming.clear();
+        }
+        if (pending.empty()) {
+            continue;
+        }
+
+        // 2. Toutes les décisions en attente partent en un seul lot
+        resolver(pending);
+        ++batches;
+        const auto firstReady = std::stable_partition(pending.begin(), pending.end(),
+                                                      [](const DecisionRequest* request) { return !request->ready; });
+        for (auto it = firstReady; it != pending.end(); ++it) {
+            ready.push_back((*it)->game);
+        }
+        decisions += static_cast<uint64_t>(pending.end() - firstReady);
+        pending.erase(firstReady, pending.end());
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+GameTask playGameAsync(GameScheduler& scheduler, std::vector<PlayerStrategy*> strategies, uint64_t deck, Xoshiro256 rng,
+                       RoundRules rules) {
+    const uint64_t numPlayers = strategies.size();
+    GameState state;
+    state.reset(numPlayers);
+    std::vector<std::vector<Card>> handCards(numPlayers);
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+    TableLayout tableLayout(layout);
+    uint64_t rounds = 0, stalledRounds = 0, skippedCalls = 0, uncalledPasses = 0;
+
+    while (!state.isGameOver()) {
+        state.deal(deck, rng);
+        tableLayout.reset(state.table);
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            handToCards(state.hands[p], handCards[p]);
+        }
+
+        uint64_t idleTurns = 0;
+        while (!state.isTerminal()) {
+            const uint64_t playerID = state.current;
+            std::vector<Card>& cards = handCards[playerID];
+
+            // Coup forcé : pas de décision à attendre
+            Move move = Move::pass(playerID);
+            int chosen = -1;
+            if (rules.fastForward && state.forcedMove(move)) {
+                ++skippedCalls;
+                uncalledPasses += move.isPass();
+                for (size_t i = 0; !move.isPass() && i < cards.size(); ++i) {
+                    if (cardIndex(cards[i].suit, cards[i].rank) == static_cast<uint64_t>(move.card)) {
+                        chosen = static_cast<int>(i);
+                    }
+                }
+            } else {
+                chosen = co_await scheduler.decide(strategies[playerID], playerID, cards, layout);
+
+                // Même validation que MyGameMapper::requestMove : un choix invalide vaut un passe
+                if (chosen >= 0 && static_cast<size_t>(chosen) < cards.size()) {
+                    const Move play = Move::play(playerID, cardIndex(cards[chosen].suit, cards[chosen].rank));
+                    if (state.isLegal(play)) {
+                        move = play;
+                    }
+                }
+            }
+            state.apply(move);
+
+            if (move.isPass()) {
+                for (uint64_t p = 0; p < numPlayers; ++p) {
+                    if (p != playerID) {
+                        strategies[p]->observePass(playerID);
+                    }
+                }
+            } else {
+                const Card card = cards[chosen];
+                tableLayout.place(card.suit, card.rank);
+                cards.erase(cards.begin() + chosen);
+                for (uint64_t p = 0; p < numPlayers; ++p) {
+                    if (p != playerID) {
+                        strategies[p]->observeMove(playerID, card);
+                    }
+                }
+            }
+
+            idleTurns = move.isPass() ? idleTurns + 1 : 0;
+            if (!state.isTerminal() && rules.stallLimit && idleTurns >= rules.stallLimit) {
+                ++stalledRounds; // manche bloquée : comptée comme une manche normale
+                break;
+            }
+        }
+
+        state.settleRound();
+        ++rounds;
+    }
+
+    GameOutcome outcome = makeOutcome(state, rounds);
+    outcome.stalledRounds = static_cast<uint16_t>(stalledRounds);
+    outcome.skippedCalls = static_cast<uint32_t>(skippedCalls);
+    outcome.uncalledPasses = static_cast<uint32_t>(uncalledPasses);
+    co_return outcome;
+}
+
+} // namespace sevens
+
+#endif // SEVENS_HAS_COROUTINES
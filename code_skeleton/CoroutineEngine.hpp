@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Engine.hpp"
+
+// Needs C++20 coroutines (-std=c++20); without them the tournament keeps its one-game-at-a-time workers
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define SEVENS_HAS_COROUTINES 1
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+class GameScheduler;
+
+/**
+ * A selectCardToPlay call requested by a suspended game.
+ * It lives in the frame of that game until `ready` is set and the game is resumed.
+ */
+struct DecisionRequest {
+    PlayerStrategy* strategy = nullptr;
+    uint64_t playerID = 0;
+    const std::vector<Card>* hand = nullptr;
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>* layout = nullptr;
+    int choice = -1;              // index in *hand, or -1 to pass
+    bool ready = false;
+    std::coroutine_handle<> game;
+};
+
+/**
+ * Coroutine of one game (see playGameAsync). Created suspended and driven by a
+ * GameScheduler; its result is the GameOutcome of the game.
+ */
+class GameTask {
+public:
+    struct promise_type {
+        GameOutcome outcome;
+        std::exception_ptr error;
+        size_t slot = 0; // position in the scheduler
+
+        GameTask get_return_object() { return GameTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(const GameOutcome& result) { outcome = result; }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    GameTask() = default;
+    GameTask(GameTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    GameTask& operator=(GameTask&& other) noexcept;
+    GameTask(const GameTask&) = delete;
+    GameTask& operator=(const GameTask&) = delete;
+    ~GameTask();
+
+    std::coroutine_handle<promise_type> getHandle() const { return handle; }
+
+private:
+    explicit GameTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Single-threaded scheduler multiplexing many in-flight games.
+ *
+ * Every game runs until it needs a decision and then suspends on
+ * decide(). Once all runnable games are suspended, the pending decisions are
+ * handed to the resolver as one batch; the games whose decision is ready are
+ * resumed, the others stay suspended without blocking anybody.
+ *
+ * The default resolver calls selectCardToPlay synchronously for every
+ * request. A custom one can send a batch to an inference engine or to
+ * out-of-process workers and leave requests not ready yet; it should only
+ * return when at least one request is ready, otherwise run() spins.
+ */
+class GameScheduler {
+public:
+    using Resolver = std::function<void(std::vector<DecisionRequest*>& pending)>;
+    using Completion = std::function<void(const GameOutcome& outcome)>;
+
+    explicit GameScheduler(Resolver resolver = {});
+
+    // Starts `task`; `onDone` is called with its outcome, and may spawn the next game
+    void spawn(GameTask task, Completion onDone);
+
+    // Runs until every spawned game is finished. Rethrows the first exception thrown inside a game.
+    void run();
+
+    class DecisionAwaiter {
+    public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> game);
+        int await_resume() const noexcept { return request.choice; }
+
+    private:
+        friend class GameScheduler;
+        DecisionAwaiter(GameScheduler& scheduler, const DecisionRequest& request) : scheduler(scheduler), request(request) {}
+
+        GameScheduler& scheduler;
+        DecisionRequest request;
+    };
+
+    // co_await scheduler.decide(...) suspends the calling game until the decision is resolved
+    DecisionAwaiter decide(PlayerStrategy* strategy, uint64_t playerID, const std::vector<Card>& hand,
+                           const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout);
+
+    uint64_t getBatches() const { return batches; }
+    uint64_t getDecisions() const { return decisions; }
+
+private:
+    struct Running {
+        GameTask task;
+        Completion onDone;
+    };
+
+    void finish(size_t slot);
+
+    Resolver resolver;
+    std::vector<Running> running;          // slots of the in-flight games
+    std::vector<size_t> freeSlots;
+    std::vector<std::coroutine_handle<>> ready;
+    std::vector<DecisionRequest*> pending;
+    uint64_t live = 0;
+    uint64_t batches = 0;
+    uint64_t decisions = 0;
+};
+
+/**
+ * One full game as a coroutine, with the rules of MyGameMapper::compute_game_progress
+ * (GameState driver) and the same random draws as playGame() for the same `rng`.
+ * `strategies` must not be used by another in-flight game: strategies keep per-game state.
+ * Forced turns of RoundRules::fastForward complete without suspending the game.
+ */
+GameTask playGameAsync(GameScheduler& scheduler, std::vector<PlayerStrategy*> strategies, uint64_t deck, Xoshiro256 rng,
+                       RoundRules rules = {});
+
+} // namespace sevens
+
+#endif // coroutines
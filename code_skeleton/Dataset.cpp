@@ -0,0 +1,374 @@
+#include "Dataset.hpp"
+#include "CommandLine.hpp"
+#include "Engine.hpp"
+#include "Features.hpp"
+#include "GameLog.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace sevens {
+
+namespace {
+
+constexpr uint64_t kNpyHeaderSize = 128; // taille fixe : l'en-tête est réécrit avec la forme finale
+
+// .npy version 1.0 : magic, version, longueur du dictionnaire, dictionnaire complété d'espaces et de '\n'
+std::string npyHeader(uint64_t rows) {
+    std::string dict = "{'descr': '|u1', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " +
+                       std::to_string(features::kWidth) + "), }";
+    const uint64_t size = kNpyHeaderSize - 10;
+    dict.resize(size - 1, ' ');
+    dict += '\n';
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header += static_cast<char>(size & 0xFF);
+    header += static_cast<char>(size >> 8);
+    return header + dict;
+}
+
+} // namespace
+
+DatasetWriter::DatasetWriter(const std::string& prefix, uint64_t shardRows) : prefix(prefix), shardRows(shardRows) {
+    if (shardRows == 0) {
+        throw std::runtime_error("[Dataset] Shards need at least one row.");
+    }
+    thread = std::thread([this]() { run(); });
+}
+
+DatasetWriter::~DatasetWriter() {
+    try {
+        close();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void DatasetWriter::submit(uint64_t block, std::vector<uint8_t>&& blockRows) {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    // Le bloc attendu par l'écriture passe toujours : sinon tous les workers pourraient attendre un bloc jamais remis
+    space.wait(lock, [&]() { return failure || pending.size() < kMaxPending || block == nextBlock; });
+    waitNanos += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    if (failure) {
+        return;
+    }
+    pending.emplace(block, std::move(blockRows));
+    if (block == nextBlock) {
+        ready.notify_one();
+    }
+}
+
+void DatasetWriter::abort(std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failure) {
+            failure = error;
+        }
+        pending.clear();
+    }
+    ready.notify_all();
+    space.notify_all();
+}
+
+void DatasetWriter::close() {
+    if (thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        ready.notify_all();
+        thread.join();
+        if (!failure && file.is_open()) {
+            finishShard();
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(std::exchange(failure, nullptr));
+    }
+}
+
+void DatasetWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this]() { return closing || failure || pending.count(nextBlock); });
+        const auto next = pending.find(nextBlock);
+        if (failure || next == pending.end()) {
+            return; // fermeture : les blocs suivants ne viendront plus
+        }
+        const std::vector<uint8_t> block = std::move(next->second);
+        pending.erase(next);
+        ++nextBlock;
+        lock.unlock();
+        space.notify_all();
+        try {
+            write(block);
+        } catch (...) {
+            lock.lock();
+            failure = std::current_exception();
+            pending.clear();
+            space.notify_all();
+            return;
+        }
+        lock.lock();
+    }
+}
+
+void DatasetWriter::write(const std::vector<uint8_t>& block) {
+    const uint64_t count = block.size() / features::kWidth;
+    for (uint64_t offset = 0; offset < count;) {
+        if (!file.is_open()) {
+            openShard();
+        }
+        const uint64_t take = std::min(count - offset, shardRows - shardFill);
+        file.write(reinterpret_cast<const char*>(block.data() + offset * features::kWidth),
+                   static_cast<std::streamsize>(take * features::kWidth));
+        if (!file) {
+            throw std::runtime_error("[Dataset] Cannot write " + shardPath + ".tmp");
+        }
+        shardFill += take;
+        rows += take;
+        offset += take;
+        if (shardFill == shardRows) {
+            finishShard();
+        }
+    }
+}
+
+void DatasetWriter::openShard() {
+    char number[16];
+    std::snprintf(number, sizeof(number), "-%05llu", static_cast<unsigned long long>(shardIndex));
+    shardPath = prefix + number + ".npy";
+    file.open(shardPath + ".tmp", std::ios::binary | std::ios::trunc);
+    const std::string header = npyHeader(0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!file) {
+        throw std::runtime_error("[Dataset] Cannot create " + shardPath + ".tmp");
+    }
+    shardFill = 0;
+}
+
+void DatasetWriter::finishShard() {
+    const std::string header = npyHeader(shardFill);
+    file.seekp(0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.close();
+    if (!file || std::rename((shardPath + ".tmp").c_str(), shardPath.c_str()) != 0) {
+        throw std::runtime_error("[Dataset] Cannot complete " + shardPath);
+    }
+    ++shardIndex;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+DatasetExporter::DatasetExporter(const DatasetOptions& options) : options(options) {
+    if (options.libraries.size() < kMinPlayers || options.libraries.size() > kMaxPlayers) {
+        throw std::runtime_error("[Dataset] Number of players must be between 3 and 7.");
+    }
+    // Dictionnaire des stratégies : une ligne par nom, dans l'ordre des sièges
+    std::vector<std::string> names;
+    for (const auto& path : options.libraries) {
+        libraries.push_back(StrategyLibrary::open(path));
+        const std::string name = libraries.back()->create()->getName();
+        const auto known = std::find(names.begin(), names.end(), name);
+        strategyIds.push_back(static_cast<uint8_t>(known - names.begin()));
+        if (known == names.end()) {
+            names.push_back(name);
+        }
+    }
+    std::ofstream namesFile(options.output + ".names", std::ios::trunc);
+    for (const auto& name : names) {
+        namesFile << name << "\n";
+    }
+    if (!namesFile) {
+        throw std::runtime_error("[Dataset] Cannot write " + options.output + ".names");
+    }
+    if (this->options.workers == 0) {
+        this->options.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+DatasetStats DatasetExporter::run() {
+    const uint64_t numPlayers = libraries.size();
+    const uint64_t blocks = (options.games + kBlockGames - 1) / kBlockGames;
+    DatasetWriter writer(options.output, options.shardRows);
+    std::atomic<uint64_t> nextBlock{0};
+
+    // Chaque worker a ses propres instances (les stratégies ne sont pas thread-safe)
+    auto work = [&]() {
+        try {
+            std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+            std::vector<PlayerStrategy*> seats;
+            for (const auto& library : libraries) {
+                strategies.push_back(library->create());
+                seats.push_back(strategies.back().get());
+            }
+            std::vector<int8_t> moves;
+            size_t blockBytes = 0;
+            for (uint64_t b = nextBlock++; b < blocks; b = nextBlock++) {
+                std::vector<uint8_t> rows;
+                rows.reserve(blockBytes);
+                const uint64_t end = std::min(options.games, (b + 1) * kBlockGames);
+                for (uint64_t game = b * kBlockGames; game < end; ++game) {
+                    for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+                        seats[seat]->initialize(seat);
+                    }
+                    const uint64_t seed = gameSeed(options.seed, game);
+                    Xoshiro256 rng(seed);
+                    moves.clear();
+                    const GameOutcome outcome = playGame(seats, kFullDeck, rng, options.rules, DecisionMemo{}, &moves);
+                    encodeGame(moves, seed, outcome.rank, outcome.points, strategyIds, options.rules, options.allTurns, rows);
+                }
+                blockBytes = std::max(blockBytes, rows.size());
+                writer.submit(b, std::move(rows));
+            }
+        } catch (...) {
+            writer.abort(std::current_exception());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint64_t t = 1; t < options.workers; ++t) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    writer.close();
+
+    DatasetStats stats;
+    stats.games = options.games;
+    stats.positions = writer.getRows();
+    stats.shards = writer.getShards();
+    stats.bytes = stats.positions * features::kWidth + stats.shards * kNpyHeaderSize;
+    stats.writerWaitSeconds = writer.getWaitSeconds();
+    return stats;
+}
+
+// Rejoue la partie enregistrée : positions exactes, puis étiquettes de fin de manche et de fin de partie
+void DatasetExporter::encodeGame(const std::vector<int8_t>& moves, uint64_t seed,
+                                 const std::array<uint8_t, kMaxPlayers>& rank,
+                                 const std::array<uint16_t, kMaxPlayers>& points, const std::vector<uint8_t>& strategyIds,
+                                 const RoundRules& rules, bool allTurns, std::vector<uint8_t>& rows) {
+    using namespace features;
+    LoggedGame game;
+    game.seed = seed;
+    game.numPlayers = static_cast<uint8_t>(strategyIds.size());
+    game.points = points;
+    game.moves = moves;
+
+    RoundHistory history;
+    GameState after; // position juste après le dernier coup rejoué : les mains de fin de manche
+    uint64_t currentRound = std::numeric_limits<uint64_t>::max();
+    size_t roundStart = rows.size();
+    auto finishRound = [&]() {
+        for (size_t row = roundStart; row < rows.size(); row += kWidth) {
+            rows[row + kPenalty] = static_cast<uint8_t>(cardCount(after.hands[rows[row + kSeat]]));
+        }
+    };
+
+    replayGame(game, rules, [&](const GameState& state, Move move, uint64_t round) {
+        if (round != currentRound) {
+            finishRound();
+            history.start(state);
+            roundStart = rows.size();
+            currentRound = round;
+        }
+        const uint64_t seat = move.player;
+        if (allTurns || state.legalMoves()) {
+            rows.resize(rows.size() + kWidth);
+            uint8_t* row = rows.data() + rows.size() - kWidth;
+            encode(state.hands[seat], state.table, state.numPlayers, seat, round, state.points[seat], history, row);
+            row[kMove] = static_cast<uint8_t>(move.isPass() ? kPassLabel : compactCard(static_cast<uint64_t>(move.card)));
+            row[kRank] = rank[seat];
+            row[kFinal] = static_cast<uint8_t>(std::min<uint64_t>(points[seat], 255));
+            row[kStrategy] = strategyIds[seat];
+        }
+        history.record(seat, move.isPass());
+        after = state;
+        after.apply(move);
+    });
+    finishRound();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runDatasetMode(int argc, char* argv[]) {
+    DatasetOptions options;
+    options.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[dataset]", arg, argv[++i], options.games)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[dataset]", arg, argv[++i], options.seed)) {
+                return 1;
+            }
+        } else if (arg == "--workers" && i + 1 < argc) {
+            if (!cli::parseCount("[dataset]", arg, argv[++i], options.workers)) {
+                return 1;
+            }
+        } else if (arg == "--shard-rows" && i + 1 < argc) {
+            if (!cli::parseCount("[dataset]", arg, argv[++i], options.shardRows)) {
+                return 1;
+            }
+        } else if (arg == "--all-turns") {
+            options.allTurns = true;
+        } else if (arg == "--stall-limit" && i + 1 < argc) {
+            if (!cli::parseCount("[dataset]", arg, argv[++i], options.rules.stallLimit)) {
+                return 1;
+            }
+        } else if (arg == "--fast-forward") {
+            options.rules.fastForward = true;
+        } else {
+            options.libraries.push_back(arg);
+        }
+    }
+
+    if (options.output.empty() || options.libraries.size() < kMinPlayers || options.libraries.size() > kMaxPlayers) {
+        std::cerr << "[main] Usage: ./sevens_game dataset --output <prefix> [--games N] [--seed S] [--workers W]"
+                     " [--shard-rows R] [--all-turns] [--stall-limit T] [--fast-forward] lib1 lib2 lib3 ...\n"
+                  << "       (3 to 7 strategy libraries; writes <prefix>-00000.npy, ... and <prefix>.names)\n";
+        return 1;
+    }
+    if (options.shardRows == 0) {
+        std::cerr << "[dataset] --shard-rows must be at least 1.\n";
+        return 1;
+    }
+
+    try {
+        DatasetExporter exporter(options);
+        std::cout << "[main] Dataset: " << options.games << " games, seed " << options.seed << ", shards of "
+                  << options.shardRows << " positions to " << options.output << "-*.npy\n"
+                  << "[main] The export repeats for a seed only if every strategy draws its randomness from the game"
+                     " (a strategy seeded from the clock, like RandomStrategy, changes it from run to run)\n";
+        const auto start = std::chrono::steady_clock::now();
+        const DatasetStats stats = exporter.run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[Dataset] " << stats.games << " games, " << stats.positions << " positions in " << stats.shards
+                  << " shards (" << std::fixed << std::setprecision(1) << stats.bytes / 1e6 << " MB), "
+                  << std::setprecision(0) << stats.games / seconds << " games/s, " << stats.positions / seconds
+                  << " positions/s\n";
+        std::cout << "[Dataset] Workers waited " << std::setprecision(2) << stats.writerWaitSeconds
+                  << " s for the writer; strategy ids are the lines of " << options.output << ".names\n";
+    } catch (const std::exception& e) {
+        std::cerr << "[main] Dataset export failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace sevens
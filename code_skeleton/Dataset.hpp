@@ -0,0 +1,138 @@
+#pragma once
+
+#include "GameState.hpp"
+#include "StrategyLoader.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Settings of a self-play export ("dataset" mode of sevens_game).
+ */
+struct DatasetOptions {
+    std::vector<std::string> libraries; // one strategy library per seat (3 to 7)
+    std::string output;                 // shards "<output>-00000.npy", ... and the "<output>.names" sidecar
+    uint64_t games = 10000;
+    uint64_t seed = 0;                  // game i is played with gameSeed(seed, i)
+    uint64_t workers = 0;               // 0 = one per core
+    uint64_t shardRows = 1 << 20;       // positions per shard (192 MB)
+    bool allTurns = false;              // also export the turns without any legal card
+    RoundRules rules;
+};
+
+struct DatasetStats {
+    uint64_t games = 0;
+    uint64_t positions = 0;
+    uint64_t shards = 0;
+    uint64_t bytes = 0;
+    double writerWaitSeconds = 0; // time the players spent waiting for the writer
+};
+
+/**
+ * Writes rows of features::kWidth bytes to .npy shards (uint8, shape (rows, kWidth)), on a
+ * background thread. Workers hand over numbered blocks in any order; they are written in block
+ * order, so the files do not depend on the number of workers. A shard is written to "<name>.tmp"
+ * and renamed once complete, with its final shape in the header.
+ *
+ * A worker waits only when kMaxPending blocks are queued and its block is not the next one to
+ * write: the writer bounds the memory of the export, never its progress.
+ */
+class DatasetWriter {
+public:
+    static constexpr uint64_t kMaxPending = 32;
+
+    // @throws std::runtime_error if shardRows is 0.
+    DatasetWriter(const std::string& prefix, uint64_t shardRows);
+    ~DatasetWriter();
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    void submit(uint64_t block, std::vector<uint8_t>&& rows);
+
+    // Gives up the export: queued blocks are dropped, submit() returns at once, close() rethrows `error`
+    void abort(std::exception_ptr error);
+
+    // Writes the queued blocks and completes the last shard.
+    // @throws std::runtime_error if a shard could not be written.
+    void close();
+
+    uint64_t getRows() const { return rows; }
+    uint64_t getShards() const { return shardIndex; }
+    double getWaitSeconds() const { return waitNanos.load() * 1e-9; }
+
+private:
+    void run();
+    void write(const std::vector<uint8_t>& block);
+    void openShard();
+    void finishShard();
+
+    std::string prefix;
+    uint64_t shardRows;
+
+    std::mutex mutex; // protège pending, nextBlock, closing et failure
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::map<uint64_t, std::vector<uint8_t>> pending;
+    uint64_t nextBlock = 0;
+    bool closing = false;
+    std::exception_ptr failure;
+    std::atomic<uint64_t> waitNanos{0};
+    std::thread thread;
+
+    // Réservés au thread d'écriture
+    std::ofstream file;
+    std::string shardPath;
+    uint64_t shardIndex = 0;
+    uint64_t shardFill = 0;
+    uint64_t rows = 0;
+};
+
+/**
+ * Self-play export: plays games between the strategies of the line-up on all cores and writes
+ * every decision point, encoded by features::encode, with its labels (see Features.hpp).
+ *
+ * Games are played by the engine with move recording, then replayed on a GameState to encode the
+ * positions: the strategies run at full speed, and the labels that need the end of the round or
+ * of the game are filled before the rows leave the worker. Games go to workers in blocks of
+ * kBlockGames; every game is seeded by its index and the strategies are initialised at every
+ * game, so the export is the same whatever the number of workers, as long as the strategies take
+ * their randomness from the game. One that seeds itself from the clock (RandomStrategy) changes
+ * the rows, and even their count, from one run to the next.
+ */
+class DatasetExporter {
+public:
+    static constexpr uint64_t kBlockGames = 16;
+
+    // @throws std::runtime_error on a bad line-up, or if the sidecar cannot be written.
+    explicit DatasetExporter(const DatasetOptions& options);
+
+    DatasetStats run();
+
+    // Appends the rows of one game played with `rules` and recorded as `moves`, as the export writes
+    // them; strategyIds has one entry per seat (the kStrategy column). Public for the checks of "bench neural".
+    static void encodeGame(const std::vector<int8_t>& moves, uint64_t seed, const std::array<uint8_t, kMaxPlayers>& rank,
+                           const std::array<uint16_t, kMaxPlayers>& points, const std::vector<uint8_t>& strategyIds,
+                           const RoundRules& rules, bool allTurns, std::vector<uint8_t>& rows);
+
+private:
+    DatasetOptions options;
+    std::vector<std::shared_ptr<StrategyLibrary>> libraries; // one per seat
+    std::vector<uint8_t> strategyIds;                        // seat -> line of the .names file
+};
+
+// Entry point of "./sevens_game dataset --output <prefix> [--games N] [--seed S] [--workers W] [--shard-rows R]
+//                 [--all-turns] [--stall-limit T] [--fast-forward] lib1 lib2 lib3 ..."
+int runDatasetMode(int argc, char* argv[]);
+
+} // namespace sevens
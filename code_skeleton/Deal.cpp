@@ -0,0 +1,209 @@
+#include "Deal.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+// binomial[n][k] = C(n, k) pour n <= 64 : C(64, 32) < 2^61, tout tient sur 64 bits
+struct BinomialTable {
+    std::array<std::array<uint64_t, 65>, 65> values{};
+
+    constexpr BinomialTable() {
+        for (uint64_t n = 0; n <= 64; ++n) {
+            values[n][0] = 1;
+            for (uint64_t k = 1; k <= n; ++k) {
+                values[n][k] = values[n - 1][k - 1] + (k < n ? values[n - 1][k] : 0);
+            }
+        }
+    }
+};
+
+constexpr BinomialTable kBinomial;
+
+uint64_t binomial(uint64_t n, uint64_t k) { return k > n ? 0 : kBinomial.values[n][k]; }
+
+void checkPlayers(uint64_t numPlayers) {
+    if (numPlayers < kMinPlayers || numPlayers > kMaxPlayers) {
+        throw std::runtime_error("[Deal] Number of players must be between 3 and 7.");
+    }
+}
+
+uint64_t handSize(uint64_t cards, uint64_t numPlayers, uint64_t player) {
+    return cards / numPlayers + (player < cards % numPlayers ? 1 : 0);
+}
+
+// Cartes encore à distribuer, dans l'ordre croissant (positions 0..count-1 pour le classement)
+struct Remaining {
+    uint8_t cards[64];
+    uint64_t count = 0;
+
+    explicit Remaining(uint64_t deck) {
+        for (uint64_t rest = deck; rest; rest &= rest - 1) {
+            cards[count++] = static_cast<uint8_t>(lowestCard(rest));
+        }
+    }
+
+    // Retire les cartes de `hand` en gardant l'ordre
+    void remove(uint64_t hand) {
+        uint64_t kept = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!((hand >> cards[i]) & 1ULL)) {
+                cards[kept++] = cards[i];
+            }
+        }
+        count = kept;
+    }
+};
+
+} // namespace
+
+Deal dealFromSeed(uint64_t seed, uint64_t numPlayers, uint64_t deck) {
+    checkPlayers(numPlayers);
+    Deal deal;
+    deal.numPlayers = numPlayers;
+    Xoshiro256 rng(seed);
+    dealInto(deck, numPlayers, rng, deal.hands.data());
+    return deal;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void DealIndex::mulAdd(uint64_t factor, uint64_t addend) {
+    unsigned __int128 carry = addend;
+    for (uint64_t& limb : limbs) {
+        carry += static_cast<unsigned __int128>(limb) * factor;
+        limb = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+    if (carry) {
+        throw std::runtime_error("[DealIndex] Overflow beyond 192 bits.");
+    }
+}
+
+uint64_t DealIndex::divMod(uint64_t divisor) {
+    unsigned __int128 remainder = 0;
+    for (uint64_t i = limbs.size(); i-- > 0;) {
+        const unsigned __int128 value = (remainder << 64) | limbs[i];
+        limbs[i] = static_cast<uint64_t>(value / divisor);
+        remainder = value % divisor;
+    }
+    return static_cast<uint64_t>(remainder);
+}
+
+bool DealIndex::operator<(const DealIndex& other) const {
+    for (uint64_t i = limbs.size(); i-- > 0;) {
+        if (limbs[i] != other.limbs[i]) {
+            return limbs[i] < other.limbs[i];
+        }
+    }
+    return false;
+}
+
+std::string DealIndex::toString() const {
+    DealIndex rest = *this;
+    std::string digits;
+    do {
+        digits.push_back(static_cast<char>('0' + rest.divMod(10)));
+    } while (rest.limbs[0] || rest.limbs[1] || rest.limbs[2]);
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+DealIndex DealIndex::fromString(const std::string& text) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::runtime_error("[DealIndex] Not a decimal number: " + text);
+    }
+    DealIndex index;
+    for (char c : text) {
+        index.mulAdd(10, static_cast<uint64_t>(c - '0'));
+    }
+    return index;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+DealIndex dealCount(uint64_t numPlayers, uint64_t deck) {
+    checkPlayers(numPlayers);
+    const uint64_t cards = cardCount(deck);
+    DealIndex count = 1;
+    uint64_t left = cards;
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        const uint64_t size = handSize(cards, numPlayers, p);
+        count.mulAdd(binomial(left, size), 0);
+        left -= size;
+    }
+    return count;
+}
+
+DealIndex rankDeal(const Deal& deal, uint64_t deck) {
+    checkPlayers(deal.numPlayers);
+    const uint64_t cards = cardCount(deck);
+    uint64_t seen = 0;
+    for (uint64_t p = 0; p < deal.numPlayers; ++p) {
+        const uint64_t hand = deal.hands[p];
+        if ((hand & ~deck) || (hand & seen) || cardCount(hand) != handSize(cards, deal.numPlayers, p)) {
+            throw std::runtime_error("[Deal] Hand " + std::to_string(p) + " is not part of a round-robin deal of the deck.");
+        }
+        seen |= hand;
+    }
+
+    // Chaque main = combinaison des cartes restantes, classée en ordre colexicographique :
+    // rang = somme des C(position, j + 1) sur ses cartes triées
+    Remaining remaining(deck);
+    DealIndex index;
+    for (uint64_t p = 0; p < deal.numPlayers; ++p) {
+        const uint64_t hand = deal.hands[p];
+        uint64_t rank = 0;
+        uint64_t j = 0;
+        for (uint64_t i = 0; i < remaining.count; ++i) {
+            if ((hand >> remaining.cards[i]) & 1ULL) {
+                rank += binomial(i, ++j);
+            }
+        }
+        index.mulAdd(binomial(remaining.count, cardCount(hand)), rank);
+        remaining.remove(hand);
+    }
+    return index;
+}
+
+Deal unrankDeal(const DealIndex& index, uint64_t numPlayers, uint64_t deck) {
+    if (!(index < dealCount(numPlayers, deck))) {
+        throw std::runtime_error("[Deal] Deal index " + index.toString() + " is out of range.");
+    }
+    const uint64_t cards = cardCount(deck);
+
+    // Chiffres en base mixte, du dernier joueur (poids faible) au premier
+    std::array<uint64_t, kMaxPlayers> digits{};
+    DealIndex rest = index;
+    for (uint64_t p = numPlayers; p-- > 0;) {
+        uint64_t left = cards;
+        for (uint64_t q = 0; q < p; ++q) {
+            left -= handSize(cards, numPlayers, q);
+        }
+        digits[p] = rest.divMod(binomial(left, handSize(cards, numPlayers, p)));
+    }
+
+    Deal deal;
+    deal.numPlayers = numPlayers;
+    Remaining remaining(deck);
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        uint64_t rank = digits[p];
+        uint64_t hand = 0;
+        uint64_t position = remaining.count;
+        for (uint64_t j = handSize(cards, numPlayers, p); j > 0; --j) {
+            // Plus grande position c telle que C(c, j) <= rang
+            do {
+                --position;
+            } while (binomial(position, j) > rank);
+            rank -= binomial(position, j);
+            hand |= 1ULL << remaining.cards[position];
+        }
+        deal.hands[p] = hand;
+        remaining.remove(hand);
+    }
+    return deal;
+}
+
+} // namespace sevens
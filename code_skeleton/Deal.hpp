@@ -0,0 +1,86 @@
+#pragma once
+
+#include "GameState.hpp"
+#include "Random.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace sevens {
+
+/**
+ * One round's hands as card bitmasks (GameState layout), hands[p] for p < numPlayers.
+ * The cards are dealt round-robin: with c cards, players p < c % numPlayers get one more.
+ */
+struct Deal {
+    std::array<uint64_t, kMaxPlayers> hands{};
+    uint64_t numPlayers = 0;
+};
+
+/**
+ * Deals `deck` to `numPlayers` players straight into hands[0..numPlayers).
+ * Same draws as GameState::deal: same generator state, same hands.
+ */
+template <class URBG>
+inline void dealInto(uint64_t deck, uint64_t numPlayers, URBG& rng, uint64_t* hands) {
+    uint8_t cards[64];
+    uint64_t count = 0;
+    for (uint64_t rest = deck; rest; rest &= rest - 1) {
+        cards[count++] = static_cast<uint8_t>(lowestCard(rest));
+    }
+    for (uint64_t p = 0; p < numPlayers; ++p) {
+        hands[p] = 0;
+    }
+    dealShuffled(cards, count, numPlayers, rng, [hands](uint64_t player, uint8_t card) { hands[player] |= 1ULL << card; });
+}
+
+// Reproducible deal of a fixed seed (Xoshiro256), identical on every platform
+Deal dealFromSeed(uint64_t seed, uint64_t numPlayers, uint64_t deck = kFullDeck);
+
+/**
+ * Index of a deal among all deals of a deck, as a 192-bit unsigned integer:
+ * there are about 2^130 ways to deal 52 cards to 7 players.
+ */
+struct DealIndex {
+    std::array<uint64_t, 3> limbs{}; // poids faible d'abord
+
+    DealIndex() = default;
+    DealIndex(uint64_t value) { limbs[0] = value; } // NOLINT: conversion voulue depuis un entier
+
+    // *this = *this * factor + addend
+    // @throws std::runtime_error on overflow.
+    void mulAdd(uint64_t factor, uint64_t addend);
+
+    // *this /= divisor, returns the remainder
+    uint64_t divMod(uint64_t divisor);
+
+    bool operator==(const DealIndex& other) const { return limbs == other.limbs; }
+    bool operator<(const DealIndex& other) const;
+
+    std::string toString() const;
+
+    // Parses a decimal index
+    // @throws std::runtime_error if `text` is not a decimal number below 2^192.
+    static DealIndex fromString(const std::string& text);
+};
+
+/**
+ * Number of distinct deals of `deck` to `numPlayers` players.
+ * @throws std::runtime_error if the number of players is not between 3 and 7.
+ */
+DealIndex dealCount(uint64_t numPlayers, uint64_t deck = kFullDeck);
+
+/**
+ * Position of `deal` in [0, dealCount): each hand is ranked as a combination
+ * of the cards the previous players left, the first player is the most significant digit.
+ * @throws std::runtime_error if the hands are not a round-robin deal of `deck`.
+ */
+DealIndex rankDeal(const Deal& deal, uint64_t deck = kFullDeck);
+
+/**
+ * Inverse of rankDeal(): enumerating 0, 1, 2... visits every deal exactly once.
+ * @throws std::runtime_error if index >= dealCount(numPlayers, deck).
+ */
+Deal unrankDeal(const DealIndex& index, uint64_t numPlayers, uint64_t deck = kFullDeck);
+
+} // namespace sevens
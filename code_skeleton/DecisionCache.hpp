@@ -0,0 +1,121 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Decisions of deterministic strategies, remembered per (strategy, hand mask, table mask).
+ *
+ * A library whose selectCardToPlay depends on nothing but the hand and the table (no random
+ * draw, no observed history, no player ID) may export strategyIsDeterministic (see
+ * PlayerStrategy.hpp); a driver holding a cache then asks it only once per distinct question.
+ * Entries live in a fixed-size table (4-slot probe, the oldest slot of the window is overwritten when full);
+ * clear() is O(1) thanks to a generation stamp. One cache per thread: no lock.
+ *
+ * Strategies are identified by an `owner` key chosen by the driver (the address of their
+ * library); clear the cache when a library is reloaded, since the key may then be reused.
+ */
+class DecisionCache {
+public:
+    static constexpr uint64_t kProbe = 4;
+    static constexpr uint64_t kTimeEvery = 16; // un appel manqué sur 16 est chronométré
+
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t timedMisses = 0;
+        uint64_t timedNanos = 0;
+
+        // Strategy time saved: hits x mean duration of a call
+        double savedSeconds() const {
+            return timedMisses ? static_cast<double>(hits) * timedNanos / timedMisses * 1e-9 : 0.0;
+        }
+        void merge(const Stats& other) {
+            lookups += other.lookups;
+            hits += other.hits;
+            timedMisses += other.timedMisses;
+            timedNanos += other.timedNanos;
+        }
+    };
+
+    explicit DecisionCache(uint64_t log2Slots = 15) : slots(1ULL << log2Slots), mask((1ULL << log2Slots) - 1) {}
+
+    /**
+     * Card (GameState index, -1 = pass) that strategy `owner` picks for (hand, table): the
+     * remembered answer, or the result of `ask()` (same convention), which is then remembered.
+     */
+    template <class Ask>
+    int64_t decide(uint64_t owner, uint64_t hand, uint64_t table, Ask&& ask) {
+        ++stats.lookups;
+        const uint64_t home = splitMix64(owner ^ hand * 0x9E3779B97F4A7C15ULL ^ splitMix64(table)) & mask;
+        for (uint64_t i = 0; i < kProbe; ++i) {
+            const Slot& slot = slots[(home + i) & mask];
+            if (slot.generation == generation && slot.hand == hand && slot.table == table && slot.owner == owner) {
+                ++stats.hits;
+                return slot.card;
+            }
+        }
+
+        int64_t card;
+        if ((stats.lookups - stats.hits) % kTimeEvery == 0) {
+            const auto start = std::chrono::steady_clock::now();
+            card = ask();
+            stats.timedNanos += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            ++stats.timedMisses;
+        } else {
+            card = ask();
+        }
+
+        // Première case libre de la fenêtre, sinon la plus ancienne écriture
+        Slot* target = &slots[home];
+        for (uint64_t i = 0; i < kProbe; ++i) {
+            Slot& slot = slots[(home + i) & mask];
+            if (slot.generation != generation) {
+                target = &slot;
+                break;
+            }
+            if (slot.written < target->written) {
+                target = &slot;
+            }
+        }
+        *target = Slot{hand, table, owner, ++writes, generation, static_cast<int32_t>(card)};
+        return card;
+    }
+
+    void clear() { ++generation; }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Slot {
+        uint64_t hand = 0;
+        uint64_t table = 0;
+        uint64_t owner = 0;
+        uint64_t written = 0;
+        uint32_t generation = 0;
+        int32_t card = -1;
+    };
+
+    std::vector<Slot> slots;
+    uint64_t mask;
+    uint64_t writes = 0;
+    uint32_t generation = 1;
+    Stats stats;
+};
+
+/**
+ * What a driver needs to memoise a line-up: the cache and, per seat, the owner key of the
+ * strategy (0 = not deterministic, always asked).
+ */
+struct DecisionMemo {
+    DecisionCache* cache = nullptr;
+    std::array<uint64_t, kMaxPlayers> owner{};
+};
+
+} // namespace sevens
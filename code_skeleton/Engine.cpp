@@ -0,0 +1,67 @@
+#include "Engine.hpp"
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+template <uint64_t N>
+GameOutcome playWith(const std::vector<PlayerStrategy*>& strategies, uint64_t deck, Xoshiro256& rng,
+                     const RoundRules& rules, const DecisionMemo& memo, std::vector<int8_t>* moves) {
+    std::array<PlayerStrategy*, N> seats{};
+    std::copy(strategies.begin(), strategies.end(), seats.begin());
+    // Un moteur par thread et par nombre de joueurs, réutilisé d'une partie à l'autre
+    thread_local Engine<N> engine(seats);
+    engine.setStrategies(seats);
+    engine.setRules(rules);
+    engine.setMemo(memo);
+    engine.setRecording(moves);
+    return engine.play(deck, rng);
+}
+
+} // namespace
+
+GameOutcome makeOutcome(const GameState& state, uint64_t rounds) {
+    GameOutcome result;
+    result.numPlayers = state.numPlayers;
+    result.rounds = static_cast<uint16_t>(rounds);
+    result.points = state.points;
+
+    // Même classement que rankPlayers(), sans allocation : dernier = plus de points, puis tri stable
+    uint64_t lastPlaceID = 0;
+    for (uint64_t p = 1; p < state.numPlayers; ++p) {
+        if (state.points[p] > state.points[lastPlaceID]) {
+            lastPlaceID = p;
+        }
+    }
+    result.rank[lastPlaceID] = state.numPlayers;
+    for (uint64_t p = 0; p < state.numPlayers; ++p) {
+        if (p == lastPlaceID) {
+            continue;
+        }
+        uint64_t before = 1;
+        for (uint64_t q = 0; q < state.numPlayers; ++q) {
+            if (q != lastPlaceID && q != p &&
+                (state.points[q] < state.points[p] || (state.points[q] == state.points[p] && q < p))) {
+                ++before;
+            }
+        }
+        result.rank[p] = static_cast<uint8_t>(before);
+    }
+    return result;
+}
+
+GameOutcome playGame(const std::vector<PlayerStrategy*>& strategies, uint64_t deck, Xoshiro256& rng,
+                     const RoundRules& rules, const DecisionMemo& memo, std::vector<int8_t>* moves) {
+    switch (strategies.size()) {
+        case 3: return playWith<3>(strategies, deck, rng, rules, memo, moves);
+        case 4: return playWith<4>(strategies, deck, rng, rules, memo, moves);
+        case 5: return playWith<5>(strategies, deck, rng, rules, memo, moves);
+        case 6: return playWith<6>(strategies, deck, rng, rules, memo, moves);
+        case 7: return playWith<7>(strategies, deck, rng, rules, memo, moves);
+        default:
+            throw std::runtime_error("[Engine] Number of players must be between 3 and 7.");
+    }
+}
+
+} // namespace sevens
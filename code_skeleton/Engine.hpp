@@ -0,0 +1,237 @@
+#pragma once
+
+#include "DecisionCache.hpp"
+#include "Deal.hpp"
+#include "GameState.hpp"
+#include "PlayerStrategy.hpp"
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+// Calls f(integral_constant<0>) ... f(integral_constant<N-1>): the loop is unrolled by the compiler
+template <class F, size_t... I>
+inline void forEachSeatImpl(F&& f, std::index_sequence<I...>) {
+    (f(std::integral_constant<size_t, I>{}), ...);
+}
+
+template <uint64_t N, class F>
+inline void forEachSeat(F&& f) {
+    forEachSeatImpl(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+/**
+ * Outcome of one full game, without any heap allocation:
+ *   rank[p]   = final rank of player p (1 = best)
+ *   points[p] = penalty points of player p at the end of the game
+ *   skippedCalls / stalledRounds: see RoundRules
+ */
+struct GameOutcome {
+    std::array<uint8_t, kMaxPlayers> rank{};
+    std::array<uint16_t, kMaxPlayers> points{};
+    uint8_t numPlayers = 0;
+    uint16_t rounds = 0;
+    uint16_t stalledRounds = 0; // manches arrêtées par la limite de blocage
+    uint32_t skippedCalls = 0;  // coups forcés joués sans appeler la stratégie
+    uint32_t cachedCalls = 0;   // décisions rendues par le DecisionCache, sans appeler la stratégie non plus
+    uint32_t uncalledPasses = 0; // passes parmi ces deux sortes de tours
+};
+
+// Ranks the players of a finished game (same order as rankPlayers)
+GameOutcome makeOutcome(const GameState& state, uint64_t rounds);
+
+/**
+ * Sevens engine specialised for exactly N players (3 <= N <= 7).
+ *
+ * Same rules and same random draws as the GameState driver of MyGameMapper,
+ * but hands and scores live in std::array, per-player loops are unrolled and
+ * the containers handed to the strategies are updated incrementally instead
+ * of being rebuilt at every turn. A reused engine plays without any heap
+ * allocation (see the "alloccheck" mode).
+ */
+template <uint64_t N>
+class Engine {
+    static_assert(N >= kMinPlayers && N <= kMaxPlayers, "Sevens is played by 3 to 7 players");
+
+public:
+    explicit Engine(const std::array<PlayerStrategy*, N>& strategies) : strategies(strategies), tableLayout(layout) {
+        for (auto& cards : handCards) {
+            cards.reserve(kNumSuits * kNumRanks);
+        }
+    }
+
+    // Reuses this engine (and its buffers) with another line-up
+    void setStrategies(const std::array<PlayerStrategy*, N>& seats) { strategies = seats; }
+
+    void setRules(const RoundRules& value) { rules = value; }
+
+    // Seats with a non-zero owner key ask their strategy only on a cache miss
+    void setMemo(const DecisionMemo& value) { memo = value; }
+
+    // When set, every turn is appended to `moves`: the card index played, -1 for a pass (see GameLog.hpp)
+    void setRecording(std::vector<int8_t>* moves) { recording = moves; }
+
+    // Plays a full game (rounds until someone reaches kEndScore) and returns its outcome
+    template <class URBG>
+    GameOutcome play(uint64_t deck, URBG& rng) {
+        scores.fill(0);
+        stalledRounds = 0;
+        skippedCalls = 0;
+        cachedCalls = 0;
+        uncalledPasses = 0;
+        uint64_t rounds = 0;
+        bool gameOver = false;
+        while (!gameOver) {
+            playRound(deck, rng);
+            ++rounds;
+            gameOver = false;
+            forEachSeat<N>([&](auto p) { gameOver |= scores[p] >= kEndScore; });
+        }
+        return outcome(rounds);
+    }
+
+    const std::array<uint64_t, N>& getScores() const { return scores; }
+
+private:
+    template <class URBG>
+    void playRound(uint64_t deck, URBG& rng) {
+        // Même tirage que GameState::deal --> mêmes mains pour une même graine
+        dealInto(deck, N, rng, hands.data());
+        table = deck & kSevensMask;
+        tableLayout.reset(table);
+        forEachSeat<N>([&](auto p) { handToCards(hands[p], handCards[p]); });
+
+        bool roundOver = false;
+        uint64_t idleTurns = 0;
+        while (!roundOver) {
+            forEachSeat<N>([&](auto p) {
+                if (!roundOver) {
+                    idleTurns = playTurn(p) ? 0 : idleTurns + 1;
+                    roundOver = hands[p] == 0;
+                    if (!roundOver && rules.stallLimit && idleTurns >= rules.stallLimit) {
+                        roundOver = true; // manche bloquée : comptée comme une manche normale
+                        ++stalledRounds;
+                    }
+                }
+            });
+        }
+
+        forEachSeat<N>([&](auto p) { scores[p] += cardCount(hands[p]); });
+    }
+
+    // Returns true if a card was played
+    bool playTurn(uint64_t playerID) {
+        std::vector<Card>& cards = handCards[playerID];
+        const uint64_t legal = playableMask(hands[playerID], table);
+
+        int chosen = -1;
+        bool called = true; // la stratégie a été appelée pour ce tour (compté par MeteredStrategy)
+        if (rules.fastForward && !(legal & (legal - 1))) {
+            // Aucun choix possible : le coup est joué sans appeler la stratégie
+            ++skippedCalls;
+            called = false;
+            for (size_t i = 0; legal && i < cards.size(); ++i) {
+                if (cardBit(cards[i].suit, cards[i].rank) == legal) {
+                    chosen = static_cast<int>(i);
+                }
+            }
+        } else if (memo.cache && memo.owner[playerID]) {
+            called = false;
+            const int64_t card = memo.cache->decide(memo.owner[playerID], hands[playerID], table, [&]() -> int64_t {
+                called = true;
+                const int index = strategies[playerID]->selectCardToPlay(cards, layout);
+                if (index < 0 || static_cast<size_t>(index) >= cards.size()) {
+                    return -1;
+                }
+                return static_cast<int64_t>(cardIndex(cards[index].suit, cards[index].rank));
+            });
+            for (size_t i = 0; card >= 0 && i < cards.size(); ++i) {
+                if (cardIndex(cards[i].suit, cards[i].rank) == static_cast<uint64_t>(card)) {
+                    chosen = static_cast<int>(i);
+                }
+            }
+            cachedCalls += !called;
+        } else {
+            chosen = strategies[playerID]->selectCardToPlay(cards, layout);
+        }
+        if (chosen >= 0 && static_cast<size_t>(chosen) < cards.size()) {
+            const Card card = cards[chosen];
+            const uint64_t bit = cardBit(card.suit, card.rank);
+            if (playableMask(hands[playerID], table) & bit) {
+                hands[playerID] &= ~bit;
+                table |= bit;
+                tableLayout.place(card.suit, card.rank);
+                cards.erase(cards.begin() + chosen);
+                if (recording) {
+                    recording->push_back(static_cast<int8_t>(cardIndex(card.suit, card.rank)));
+                }
+                notify(playerID, &card);
+                return true;
+            }
+        }
+        if (recording) {
+            recording->push_back(-1);
+        }
+        uncalledPasses += !called;
+        notify(playerID, nullptr);
+        return false;
+    }
+
+    void notify(uint64_t playerID, const Card* card) {
+        forEachSeat<N>([&](auto p) {
+            if (p != playerID) {
+                if (card) {
+                    strategies[p]->observeMove(playerID, *card);
+                } else {
+                    strategies[p]->observePass(playerID);
+                }
+            }
+        });
+    }
+
+    GameOutcome outcome(uint64_t rounds) const {
+        GameState state;
+        state.reset(N);
+        forEachSeat<N>([&](auto p) { state.points[p] = static_cast<uint16_t>(scores[p]); });
+        GameOutcome result = makeOutcome(state, rounds);
+        result.stalledRounds = static_cast<uint16_t>(stalledRounds);
+        result.skippedCalls = static_cast<uint32_t>(skippedCalls);
+        result.cachedCalls = static_cast<uint32_t>(cachedCalls);
+        result.uncalledPasses = static_cast<uint32_t>(uncalledPasses);
+        return result;
+    }
+
+    std::array<PlayerStrategy*, N> strategies;
+    std::array<uint64_t, N> hands{};
+    std::array<uint64_t, N> scores{};
+    uint64_t table = 0;
+    RoundRules rules;
+    DecisionMemo memo;
+    std::vector<int8_t>* recording = nullptr;
+    uint64_t stalledRounds = 0;
+    uint64_t skippedCalls = 0;
+    uint64_t cachedCalls = 0;
+    uint64_t uncalledPasses = 0;
+
+    // Vues passées aux stratégies, mises à jour à chaque coup au lieu d'être reconstruites.
+    // Capacités réservées et noeuds recyclés : aucune allocation après la première partie.
+    std::array<std::vector<Card>, N> handCards;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+    TableLayout tableLayout;
+};
+
+/**
+ * Runtime dispatcher: picks Engine<N> for strategies.size() players and plays one game.
+ * Its turns are appended to `moves` if given (see Engine::setRecording).
+ * @throws std::runtime_error if the number of players is not between 3 and 7.
+ */
+GameOutcome playGame(const std::vector<PlayerStrategy*>& strategies, uint64_t deck, Xoshiro256& rng,
+                     const RoundRules& rules = {}, const DecisionMemo& memo = {},
+                     std::vector<int8_t>* moves = nullptr);
+
+} // namespace sevens
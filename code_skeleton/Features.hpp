@@ -0,0 +1,125 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace sevens {
+
+/**
+ * Fixed-width encoding of one decision point, for learned strategies: the rows of the "dataset"
+ * mode of sevens_game, and the input of strategies trained on them.
+ *
+ * A row is kWidth bytes, every column a uint8. Cards use the compact index suit * 13 + rank
+ * (52 values); seats of the other players are relative to the mover, in turn order
+ * (column 0 = the next player), and stay 0 for seats a smaller game does not have.
+ *
+ *   offset  width  column
+ *        0     52  hand        1 if the card is in the mover's hand
+ *       52     52  table       1 if the card is on the table
+ *      104     52  legal       1 if the mover may play the card now
+ *      156      6  cards       cards in hand of each other player
+ *      162      6  passes      passes of each other player since the round began
+ *      168      6  passed      1 if that player passed on their last turn
+ *      174      1  players     number of players
+ *      175      1  seat        seat of the mover
+ *      176      1  round       round of the game (0 = first, saturated at 255)
+ *      177      1  points      penalty points of the mover before this round
+ *   labels, filled once the game is over:
+ *      178      1  move        card played (compact index), or 52 for a pass
+ *      179      1  penalty     cards the mover was left with at the end of the round
+ *      180      1  rank        final rank of the mover (1 = winner)
+ *      181      1  final       final penalty points of the mover
+ *      182      1  strategy    id of the mover's strategy (line of the ".names" file of the export)
+ *      183      9  zero        padding to 3 cache lines
+ *
+ * Everything before the labels is public information at the time of the decision, so a strategy
+ * that counts the moves and passes it observes can rebuild it: NeuralStrategy calls the same
+ * encode() as the export, and "bench neural" checks that their rows agree.
+ */
+namespace features {
+
+constexpr uint64_t kCards = kNumSuits * kNumRanks;
+constexpr uint64_t kOthers = kMaxPlayers - 1;
+constexpr uint64_t kPassLabel = kCards;
+
+constexpr uint64_t kHand = 0;
+constexpr uint64_t kTable = kHand + kCards;
+constexpr uint64_t kLegal = kTable + kCards;
+constexpr uint64_t kOtherCards = kLegal + kCards;
+constexpr uint64_t kOtherPasses = kOtherCards + kOthers;
+constexpr uint64_t kOtherPassed = kOtherPasses + kOthers;
+constexpr uint64_t kPlayers = kOtherPassed + kOthers;
+constexpr uint64_t kSeat = kPlayers + 1;
+constexpr uint64_t kRound = kSeat + 1;
+constexpr uint64_t kPoints = kRound + 1;
+constexpr uint64_t kInputs = kPoints + 1; // colonnes connues au moment de la décision
+
+constexpr uint64_t kMove = kInputs;
+constexpr uint64_t kPenalty = kMove + 1;
+constexpr uint64_t kRank = kPenalty + 1;
+constexpr uint64_t kFinal = kRank + 1;
+constexpr uint64_t kStrategy = kFinal + 1;
+constexpr uint64_t kWidth = 192;
+
+static_assert(kInputs == 178 && kStrategy < kWidth, "the row layout is documented above, keep them in sync");
+
+constexpr uint64_t compactCard(uint64_t card) { return card / kSuitStride * kNumRanks + card % kSuitStride; }
+constexpr uint64_t cardOfCompact(uint64_t index) { return index / kNumRanks * kSuitStride + index % kNumRanks; }
+
+/**
+ * Public history of the current round: cards left and passes of every seat.
+ * The export feeds it from the replayed state; a strategy from its observeMove / observePass.
+ */
+struct RoundHistory {
+    std::array<uint8_t, kMaxPlayers> cards{};
+    std::array<uint8_t, kMaxPlayers> passes{};
+    std::array<uint8_t, kMaxPlayers> passed{};
+
+    void start(const GameState& state) {
+        *this = RoundHistory{};
+        for (uint64_t p = 0; p < state.numPlayers; ++p) {
+            cards[p] = static_cast<uint8_t>(cardCount(state.hands[p]));
+        }
+    }
+
+    void record(uint64_t player, bool pass) {
+        if (pass) {
+            passes[player] = static_cast<uint8_t>(passes[player] + (passes[player] < 255));
+        } else if (cards[player]) {
+            --cards[player];
+        }
+        passed[player] = pass;
+    }
+};
+
+// Writes the input columns of the position of `seat` (labels and padding are left to the caller)
+inline void encode(uint64_t hand, uint64_t table, uint64_t numPlayers, uint64_t seat, uint64_t round,
+                   uint64_t points, const RoundHistory& history, uint8_t* row) {
+    std::memset(row, 0, kInputs);
+    const uint64_t legal = playableMask(hand, table);
+    for (uint64_t suit = 0; suit < kNumSuits; ++suit) {
+        for (uint64_t rank = 0; rank < kNumRanks; ++rank) {
+            const uint64_t card = cardIndex(suit, rank);
+            const uint64_t column = suit * kNumRanks + rank;
+            row[kHand + column] = static_cast<uint8_t>((hand >> card) & 1);
+            row[kTable + column] = static_cast<uint8_t>((table >> card) & 1);
+            row[kLegal + column] = static_cast<uint8_t>((legal >> card) & 1);
+        }
+    }
+    for (uint64_t offset = 1; offset < numPlayers; ++offset) {
+        const uint64_t other = (seat + offset) % numPlayers;
+        row[kOtherCards + offset - 1] = history.cards[other];
+        row[kOtherPasses + offset - 1] = history.passes[other];
+        row[kOtherPassed + offset - 1] = history.passed[other];
+    }
+    row[kPlayers] = static_cast<uint8_t>(numPlayers);
+    row[kSeat] = static_cast<uint8_t>(seat);
+    row[kRound] = static_cast<uint8_t>(round < 255 ? round : 255);
+    row[kPoints] = static_cast<uint8_t>(points < 255 ? points : 255);
+}
+
+} // namespace features
+
+} // namespace sevens
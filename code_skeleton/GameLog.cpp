@@ -0,0 +1,127 @@
+#include "GameLog.hpp"
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace sevens {
+
+namespace {
+
+constexpr size_t kBlockBytes = 1 << 20; // les parties sont écrites par blocs d'environ 1 Mo
+
+} // namespace
+
+GameLogWriter::GameLogWriter(const std::string& path, const RoundRules& rules) : path(path) {
+    if (rules.stallLimit > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("[GameLog] The stall limit of a recorded run must fit in 32 bits.");
+    }
+    gamelog::FileHeader header{};
+    header.magic = gamelog::kFileMagic;
+    header.version = 1;
+    header.stallLimit = static_cast<uint32_t>(rules.stallLimit);
+    header.fastForward = rules.fastForward ? 1 : 0;
+    file.open(path, std::ios::binary | std::ios::trunc);
+    namesFile.open(path + ".names", std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file || !namesFile) {
+        throw std::runtime_error("[GameLog] Cannot create " + path);
+    }
+    buffer.reserve(kBlockBytes + 4096);
+}
+
+GameLogWriter::~GameLogWriter() {
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+}
+
+uint16_t GameLogWriter::strategyId(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<uint16_t>(ids.size());
+    ids.emplace(name, id);
+    namesFile << name << "\n" << std::flush; // le dictionnaire doit précéder les parties qui l'utilisent
+    return id;
+}
+
+void GameLogWriter::append(const LoggedGame& game) {
+    gamelog::GameHeader header{};
+    header.seed = game.seed;
+    header.moves = static_cast<uint32_t>(game.moves.size());
+    header.numPlayers = game.numPlayers;
+    header.rounds = game.rounds;
+    header.strategy = game.strategy;
+    header.points = game.points;
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(header));
+    const char* moves = reinterpret_cast<const char*>(game.moves.data());
+    buffer.insert(buffer.end(), moves, moves + game.moves.size());
+    if (buffer.size() >= kBlockBytes) {
+        flush();
+    }
+}
+
+void GameLogWriter::flush() {
+    if (buffer.empty()) {
+        return;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    buffer.clear();
+    if (!file) {
+        throw std::runtime_error("[GameLog] Cannot write to " + path);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+std::vector<LoggedGame> readGameLog(const std::string& path, RoundRules& rules) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("[GameLog] Cannot open " + path);
+    }
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    gamelog::FileHeader header{};
+    if (bytes.size() < sizeof(header)) {
+        throw std::runtime_error("[GameLog] Not a game log: " + path);
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != gamelog::kFileMagic || header.version != 1) {
+        throw std::runtime_error("[GameLog] Not a game log: " + path);
+    }
+    rules.stallLimit = header.stallLimit;
+    rules.fastForward = header.fastForward != 0;
+
+    std::vector<LoggedGame> games;
+    size_t offset = sizeof(header);
+    while (offset + sizeof(gamelog::GameHeader) <= bytes.size()) {
+        gamelog::GameHeader game{};
+        std::memcpy(&game, bytes.data() + offset, sizeof(game));
+        offset += sizeof(game);
+        if (offset + game.moves > bytes.size()) {
+            break; // partie tronquée (écriture interrompue)
+        }
+        LoggedGame logged;
+        logged.seed = game.seed;
+        logged.numPlayers = game.numPlayers;
+        logged.rounds = game.rounds;
+        logged.strategy = game.strategy;
+        logged.points = game.points;
+        logged.moves.assign(bytes.data() + offset, bytes.data() + offset + game.moves);
+        offset += game.moves;
+        if (logged.numPlayers < kMinPlayers || logged.numPlayers > kMaxPlayers) {
+            throw std::runtime_error("[GameLog] Corrupted game log: " + path);
+        }
+        games.push_back(std::move(logged));
+    }
+    return games;
+}
+
+} // namespace sevens
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * One recorded game: enough to rebuild every position of it.
+ * The deals are not stored, they are drawn again from `seed` (same generator as the engine);
+ * `moves` holds every turn in order, the card index played or -1 for a pass.
+ */
+struct LoggedGame {
+    uint64_t seed = 0;
+    uint8_t numPlayers = 0;
+    uint16_t rounds = 0;
+    std::array<uint16_t, kMaxPlayers> strategy{}; // ids in the name dictionary of the file
+    std::array<uint16_t, kMaxPlayers> points{};   // final points, checked by the replay
+    std::vector<int8_t> moves;
+};
+
+/**
+ * Game log layout: FileHeader (round rules of the run), then for every game a GameHeader
+ * followed by its `moves` bytes. Strategy names live in the "<file>.names" sidecar, one per
+ * line, as for results files. A game cut short by a crash is ignored by the reader.
+ */
+namespace gamelog {
+
+constexpr uint64_t kFileMagic = 0x31474F4C53564553ULL; // "SEVSLOG1"
+
+struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t stallLimit;
+    uint8_t fastForward;
+    uint8_t reserved[47];
+};
+
+struct GameHeader {
+    uint64_t seed;
+    uint32_t moves;
+    uint8_t numPlayers;
+    uint8_t reserved;
+    uint16_t rounds;
+    std::array<uint16_t, kMaxPlayers> strategy;
+    std::array<uint16_t, kMaxPlayers> points;
+    uint8_t padding[4];
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(GameHeader) == 48, "game log headers have a fixed size");
+
+} // namespace gamelog
+
+/**
+ * Writes the games of one run to a new game log. Games are buffered and written in blocks.
+ * Not thread-safe: the tournament serialises its workers around it.
+ */
+class GameLogWriter {
+public:
+    // @throws std::runtime_error if the file cannot be created or rules.stallLimit does not fit the header.
+    GameLogWriter(const std::string& path, const RoundRules& rules);
+    ~GameLogWriter();
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    // Id of a strategy name, added to the dictionary on first use
+    uint16_t strategyId(const std::string& name);
+
+    void append(const LoggedGame& game);
+
+    void flush();
+
+private:
+    std::string path;
+    std::ofstream file;
+    std::ofstream namesFile;
+    std::unordered_map<std::string, uint16_t> ids;
+    std::vector<char> buffer;
+};
+
+/**
+ * Reads a whole game log; `rules` receives the round rules it was played with.
+ * @throws std::runtime_error if the file cannot be read or is not a game log.
+ */
+std::vector<LoggedGame> readGameLog(const std::string& path, RoundRules& rules);
+
+/**
+ * Replays a logged game: calls visit(state, move, round) with the position before every
+ * recorded move (hands of every player known), rounds ending as in the engine.
+ * @throws std::runtime_error if the moves do not replay (illegal move, wrong final points).
+ */
+template <class Visit>
+void replayGame(const LoggedGame& game, const RoundRules& rules, Visit&& visit) {
+    GameState state;
+    state.reset(game.numPlayers);
+    Xoshiro256 rng(game.seed);
+    size_t next = 0;
+    uint64_t rounds = 0;
+    while (!state.isGameOver() && next < game.moves.size()) {
+        state.deal(kFullDeck, rng);
+        uint64_t idleTurns = 0;
+        bool roundOver = false;
+        while (!roundOver && next < game.moves.size()) {
+            const int8_t card = game.moves[next++];
+            const Move move = card < 0 ? Move::pass(state.current) : Move::play(state.current, static_cast<uint64_t>(card));
+            if (!state.isLegal(move)) {
+                throw std::runtime_error("[GameLog] Illegal move in the game of seed " + std::to_string(game.seed));
+            }
+            visit(static_cast<const GameState&>(state), move, rounds);
+            const uint64_t mover = move.player;
+            state.apply(move);
+            idleTurns = move.isPass() ? idleTurns + 1 : 0;
+            roundOver = state.hands[mover] == 0 || (rules.stallLimit && idleTurns >= rules.stallLimit);
+        }
+        state.settleRound();
+        ++rounds;
+    }
+    if (next != game.moves.size() || state.points != game.points) {
+        throw std::runtime_error("[GameLog] The game of seed " + std::to_string(game.seed) + " does not replay");
+    }
+}
+
+} // namespace sevens
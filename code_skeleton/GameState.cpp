@@ -0,0 +1,105 @@
+#include "GameState.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace sevens {
+
+uint64_t deckFromCards(const std::unordered_map<uint64_t, Card>& cards) {
+    // Aucun fichier de cartes chargé --> paquet standard de 52 cartes
+    if (cards.empty()) {
+        return kFullDeck;
+    }
+    uint64_t deck = 0;
+    for (const auto& [id, card] : cards) {
+        if (card.suit < kNumSuits && card.rank < kNumRanks) {
+            deck |= cardBit(card.suit, card.rank);
+        }
+    }
+    return deck;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void handToCards(uint64_t hand, std::vector<Card>& out) {
+    out.clear();
+    for (uint64_t rest = hand; rest; rest &= rest - 1) {
+        out.push_back(cardFromIndex(lowestCard(rest)));
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void tableToLayout(uint64_t table, std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout) {
+    layout.clear();
+    for (uint64_t rest = table; rest; rest &= rest - 1) {
+        const Card card = cardFromIndex(lowestCard(rest));
+        layout[card.suit][card.rank] = true;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+TableLayout::TableLayout(Map& layout) : layout(layout) {
+    layout.clear();
+    layout.reserve(kNumSuits);
+    for (uint64_t suit = 0; suit < kNumSuits; ++suit) {
+        auto& ranks = layout[suit];
+        ranks.reserve(kNumRanks); // plus jamais de rehash ensuite
+        for (uint64_t rank = 0; rank < kNumRanks; ++rank) {
+            ranks[rank] = true;
+            spare[suit][rank] = ranks.extract(rank);
+        }
+    }
+}
+
+void TableLayout::reset(uint64_t table) {
+    for (uint64_t rest = placed; rest; rest &= rest - 1) {
+        const Card card = cardFromIndex(lowestCard(rest));
+        spare[card.suit][card.rank] = layout.find(card.suit)->second.extract(card.rank);
+    }
+    placed = 0;
+    for (uint64_t rest = table; rest; rest &= rest - 1) {
+        const Card card = cardFromIndex(lowestCard(rest));
+        place(card.suit, card.rank);
+    }
+}
+
+void TableLayout::place(uint64_t suit, uint64_t rank) {
+    const uint64_t bit = cardBit(suit, rank);
+    if (placed & bit) {
+        return; // un 7 d'ouverture rejoué depuis une main
+    }
+    layout.find(suit)->second.insert(std::move(spare[suit][rank]));
+    placed |= bit;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::pair<uint64_t, uint64_t>> rankPlayers(const GameState& state) {
+    std::vector<std::pair<uint64_t, uint64_t>> results;
+
+    // Dernière place : le joueur qui a le plus de points (à égalité, le plus petit ID)
+    uint64_t lastPlaceID = 0;
+    for (uint64_t playerID = 1; playerID < state.numPlayers; ++playerID) {
+        if (state.points[playerID] > state.points[lastPlaceID]) {
+            lastPlaceID = playerID;
+        }
+    }
+    results.emplace_back(lastPlaceID, state.numPlayers); // Last place (rank = numPlayers)
+
+    std::vector<std::pair<uint64_t, uint64_t>> remainingPlayers;
+    for (uint64_t playerID = 0; playerID < state.numPlayers; ++playerID) {
+        if (playerID != lastPlaceID) {
+            remainingPlayers.emplace_back(playerID, state.points[playerID]);
+        }
+    }
+    std::stable_sort(remainingPlayers.begin(), remainingPlayers.end(),
+                     [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    for (size_t i = 0; i < remainingPlayers.size(); ++i) {
+        results.emplace_back(remainingPlayers[i].first, i + 1);
+    }
+    return results;
+}
+
+} // namespace sevens
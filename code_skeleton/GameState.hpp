@@ -0,0 +1,254 @@
+#pragma once
+
+#include "Generic_card_parser.hpp"
+#include "Random.hpp"
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+// -----------------------------------------------------------------------------
+// Card <-> bit layout
+//   Each suit owns a 16-bit lane of a 64-bit mask: bit = suit * 16 + rank.
+//   Ranks 13..15 of every lane stay empty, so shifting a mask by one never
+//   moves a card into the neighbouring suit.
+// -----------------------------------------------------------------------------
+
+constexpr uint64_t kNumSuits   = 4;
+constexpr uint64_t kNumRanks   = 13;
+constexpr uint64_t kSuitStride = 16;
+constexpr uint64_t kStartRank  = 6;   // 6 car les rangs vont de 0 à 12 ⇒ 7 = index 6
+constexpr uint64_t kMinPlayers = 3;
+constexpr uint64_t kMaxPlayers = 7;
+constexpr uint64_t kEndScore   = 50;  // la partie s'arrête dès qu'un joueur atteint 50 points
+constexpr uint64_t kDefaultStallLimit = 1000; // tours consécutifs sans carte posée avant de déclarer la manche bloquée
+
+constexpr uint64_t kSuitMask = (1ULL << kNumRanks) - 1;
+
+constexpr uint64_t suitLanes(uint64_t lane) {
+    return lane | (lane << kSuitStride) | (lane << (2 * kSuitStride)) | (lane << (3 * kSuitStride));
+}
+
+constexpr uint64_t kFullDeck   = suitLanes(kSuitMask);
+constexpr uint64_t kSevensMask = suitLanes(1ULL << kStartRank);
+
+constexpr uint64_t cardIndex(uint64_t suit, uint64_t rank) { return suit * kSuitStride + rank; }
+constexpr uint64_t cardBit(uint64_t suit, uint64_t rank) { return 1ULL << cardIndex(suit, rank); }
+inline Card cardFromIndex(uint64_t index) { return Card(index / kSuitStride, index % kSuitStride); }
+
+/**
+ * Cards of `hand` that may be put on `table`. Same rule as the original engine:
+ * a card is playable if one of its neighbours (rank - 1 or rank + 1) is on the
+ * table, or if it is a 7 whose suit has not been opened yet.
+ */
+constexpr uint64_t playableMask(uint64_t hand, uint64_t table) {
+    const uint64_t neighbours = ((table << 1) | (table >> 1)) & kFullDeck;
+    const uint64_t sevens = kSevensMask & ~table;
+    return hand & (neighbours | sevens);
+}
+
+/** splitmix64 mixing: independent seeds for neighbouring game indices. */
+constexpr uint64_t splitMix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Seed of game `gameIndex` of a run started with `masterSeed`
+constexpr uint64_t gameSeed(uint64_t masterSeed, uint64_t gameIndex) {
+    return splitMix64(masterSeed + (gameIndex + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+/** Lowest card index of a non-empty mask. */
+inline uint64_t lowestCard(uint64_t mask) { return static_cast<uint64_t>(__builtin_ctzll(mask)); }
+inline uint64_t cardCount(uint64_t mask) { return static_cast<uint64_t>(__builtin_popcountll(mask)); }
+
+/**
+ * A single decision: `player` puts card `card` on the table, or passes (card = -1).
+ */
+struct Move {
+    int8_t card = -1;
+    uint8_t player = 0;
+
+    static Move pass(uint64_t player) { return Move{-1, static_cast<uint8_t>(player)}; }
+    static Move play(uint64_t player, uint64_t card) {
+        return Move{static_cast<int8_t>(card), static_cast<uint8_t>(player)};
+    }
+    bool isPass() const { return card < 0; }
+};
+
+/**
+ * Compact, trivially copyable Sevens state (one round + the running game score).
+ *
+ * Copying it costs a memcpy of a few dozen bytes, so search strategies and
+ * analysis tools can fork it freely and roll moves back with undo().
+ */
+struct GameState {
+    std::array<uint64_t, kMaxPlayers> hands{};   // cartes en main de chaque joueur
+    uint64_t table = 0;                         // cartes posées sur la table
+    uint64_t opening = 0;                       // cartes posées au début de la manche (les 7)
+    std::array<uint16_t, kMaxPlayers> points{}; // points de pénalité cumulés sur la partie
+    uint8_t numPlayers = 0;
+    uint8_t current = 0;                        // joueur dont c'est le tour
+
+    // Starts a new game (all scores back to 0)
+    void reset(uint64_t players) {
+        *this = GameState{};
+        numPlayers = static_cast<uint8_t>(players);
+    }
+
+    // Starts a new round: deals `deck` in random order, round-robin, and opens the 7s
+    template <class URBG>
+    void deal(uint64_t deck, URBG& rng) {
+        uint8_t cards[64];
+        uint64_t count = 0;
+        for (uint64_t rest = deck; rest; rest &= rest - 1) {
+            cards[count++] = static_cast<uint8_t>(lowestCard(rest));
+        }
+        hands.fill(0);
+        dealShuffled(cards, count, numPlayers, rng, [this](uint64_t player, uint8_t card) { hands[player] |= 1ULL << card; });
+        opening = deck & kSevensMask;
+        table = opening;
+        current = 0;
+    }
+
+    // Deals `cards` in the given order (card i goes to player i % numPlayers)
+    void dealOrdered(const uint8_t* cards, uint64_t count, uint64_t deck) {
+        hands.fill(0);
+        for (uint64_t i = 0; i < count; ++i) {
+            hands[i % numPlayers] |= 1ULL << cards[i];
+        }
+        opening = deck & kSevensMask;
+        table = opening;
+        current = 0;
+    }
+
+    uint64_t legalMoves() const { return playableMask(hands[current], table); }
+
+    // True if the current player has no choice (no legal card, or exactly one); `move` is then that forced move
+    bool forcedMove(Move& move) const {
+        const uint64_t legal = legalMoves();
+        if (legal & (legal - 1)) {
+            return false;
+        }
+        move = legal ? Move::play(current, lowestCard(legal)) : Move::pass(current);
+        return true;
+    }
+
+    bool isLegal(Move move) const {
+        return move.player == current &&
+               (move.isPass() || (legalMoves() >> move.card) & 1ULL);
+    }
+
+    // Plays `move` for the current player and hands the turn to the next one
+    void apply(Move move) {
+        if (!move.isPass()) {
+            const uint64_t bit = 1ULL << move.card;
+            hands[move.player] &= ~bit;
+            table |= bit;
+        }
+        current = static_cast<uint8_t>((move.player + 1) % numPlayers);
+    }
+
+    // Exact inverse of apply(move)
+    void undo(Move move) {
+        if (!move.isPass()) {
+            const uint64_t bit = 1ULL << move.card;
+            hands[move.player] |= bit;
+            table &= ~(bit & ~opening); // les 7 d'ouverture restent sur la table
+        }
+        current = move.player;
+    }
+
+    // The round is over as soon as one player has emptied their hand
+    bool isTerminal() const { return winner() >= 0; }
+
+    int winner() const {
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            if (hands[p] == 0) {
+                return static_cast<int>(p);
+            }
+        }
+        return -1;
+    }
+
+    // Penalty points of the current round: one point per card left in hand
+    std::array<uint64_t, kMaxPlayers> scores() const {
+        std::array<uint64_t, kMaxPlayers> result{};
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            result[p] = cardCount(hands[p]);
+        }
+        return result;
+    }
+
+    // Adds the round penalties to the game score
+    void settleRound() {
+        const auto roundScores = scores();
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            points[p] = static_cast<uint16_t>(points[p] + roundScores[p]);
+        }
+    }
+
+    bool isGameOver() const {
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            if (points[p] >= kEndScore) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay memcpy-able");
+
+/**
+ * How the game drivers run a round.
+ *   stallLimit : a round in which that many consecutive turns pass without a card being played is
+ *                stalled (every strategy passing, or cards no strategy will ever play). It ends there
+ *                and is scored like any other round: each player takes one point per card in hand,
+ *                so a game always terminates. 0 = no limit.
+ *   fastForward: turns with no choice are applied without calling the strategy: a pass when no card
+ *                is legal, the only legal card otherwise. The other players are still notified.
+ *                A strategy can no longer pass on purpose with a single legal card, so results of
+ *                strategies that do (Greedy keeping its Aces, bluff passes) change with this flag.
+ */
+struct RoundRules {
+    uint64_t stallLimit = kDefaultStallLimit;
+    bool fastForward = false;
+};
+
+// Conversions between the compact state and the containers of the PlayerStrategy interface
+uint64_t deckFromCards(const std::unordered_map<uint64_t, Card>& cards);
+void handToCards(uint64_t hand, std::vector<Card>& out);
+void tableToLayout(uint64_t table, std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout);
+
+/**
+ * Keeps a table layout map in sync with a table mask without allocating.
+ * The map always holds the 4 suits with reserved buckets, and one node per
+ * card is created up front: placing a card moves its node into the map,
+ * reset() moves every node back to the pool (unordered_map extract/insert).
+ */
+class TableLayout {
+public:
+    using Map = std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>;
+
+    explicit TableLayout(Map& layout);
+
+    void reset(uint64_t table);
+    void place(uint64_t suit, uint64_t rank);
+
+private:
+    Map& layout;
+    std::array<std::array<Map::mapped_type::node_type, kNumRanks>, kNumSuits> spare;
+    uint64_t placed = 0;
+};
+
+// Final ranking of a finished game: (playerID, rank), last place first
+std::vector<std::pair<uint64_t, uint64_t>> rankPlayers(const GameState& state);
+
+} // namespace sevens
@@ -72,6 +72,11 @@ std::string GreedyStrategy::getName() const {
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::GreedyStrategy();
 }
+
+// Le choix ne dépend que de la main et de la table : le moteur peut le mettre en cache
+extern "C" uint64_t strategyIsDeterministic() {
+    return 1;
+}
 #endif
 
 } // namespace sevens
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Hand-structure features of one card, computed from the hand and table masks
+ * with a handful of bit operations (no rescan of the hand):
+ *   chain    : cards of my hand that become playable one after the other once this card is down
+ *   exposed  : unknown cards (neither in my hand nor on the table) this play makes playable for opponents
+ *   distance : cards still missing between the suit frontier and this card (0 = playable now)
+ *
+ * Header-only on purpose, so strategy libraries can use it without linking the engine.
+ */
+struct CardFeatures {
+    uint8_t chain = 0;
+    uint8_t exposed = 0;
+    uint8_t distance = 0;
+};
+
+namespace analysis {
+
+// Number of consecutive set bits of `lane` going up from bit `from` (exclusive)
+inline uint64_t runAbove(uint64_t lane, uint64_t from) {
+    return static_cast<uint64_t>(__builtin_ctzll(~(lane >> (from + 1))));
+}
+
+// Number of consecutive set bits of `lane` going down from bit `from` (exclusive)
+inline uint64_t runBelow(uint64_t lane, uint64_t from) {
+    return from == 0 ? 0 : static_cast<uint64_t>(__builtin_clzll(~(lane << (64 - from))));
+}
+
+} // namespace analysis
+
+inline CardFeatures analyzeCard(uint64_t hand, uint64_t table, uint64_t card) {
+    const uint64_t suit = card / kSuitStride;
+    const uint64_t rank = card % kSuitStride;
+    const uint64_t shift = suit * kSuitStride;
+    const uint64_t handLane = (hand >> shift) & kSuitMask;
+    const uint64_t tableLane = (table >> shift) & kSuitMask;
+
+    CardFeatures features;
+
+    // Suite de cartes de ma main débloquée dans la direction où la suite progresse
+    uint64_t chain = 0;
+    if (rank <= kStartRank) {
+        chain += analysis::runBelow(handLane, rank);
+    }
+    if (rank >= kStartRank) {
+        chain += analysis::runAbove(handLane, rank);
+    }
+    features.chain = static_cast<uint8_t>(chain);
+
+    // Cartes inconnues qui deviennent jouables pour les adversaires
+    const uint64_t unknown = kFullDeck & ~hand & ~table;
+    const uint64_t bit = 1ULL << card;
+    const uint64_t before = playableMask(unknown, table);
+    const uint64_t after = playableMask(unknown, table | bit);
+    features.exposed = static_cast<uint8_t>(cardCount(after & ~before));
+
+    // Distance à la frontière de la couleur
+    if (!(playableMask(bit, table) & bit) && !(tableLane >> rank & 1ULL)) {
+        uint64_t distance;
+        if (tableLane == 0) {
+            distance = rank > kStartRank ? rank - kStartRank : kStartRank - rank;
+        } else if (rank < kStartRank) {
+            distance = static_cast<uint64_t>(__builtin_ctzll(tableLane)) - 1 - rank;
+        } else {
+            distance = rank - (63 - static_cast<uint64_t>(__builtin_clzll(tableLane))) - 1;
+        }
+        features.distance = static_cast<uint8_t>(distance);
+    }
+    return features;
+}
+
+// Features of every card of `hand`, indexed by card index (suit * 16 + rank)
+inline void analyzeHand(uint64_t hand, uint64_t table, std::array<CardFeatures, 64>& out) {
+    for (uint64_t rest = hand; rest; rest &= rest - 1) {
+        const uint64_t card = lowestCard(rest);
+        out[card] = analyzeCard(hand, table, card);
+    }
+}
+
+// Masks from the containers of the PlayerStrategy interface (one pass each)
+inline uint64_t handMask(const std::vector<Card>& hand) {
+    uint64_t mask = 0;
+    for (const Card& card : hand) {
+        if (card.suit < kNumSuits && card.rank < kNumRanks) {
+            mask |= cardBit(card.suit, card.rank);
+        }
+    }
+    return mask;
+}
+
+inline uint64_t tableMask(const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
+    uint64_t mask = 0;
+    for (const auto& [suit, ranks] : tableLayout) {
+        for (const auto& [rank, onTable] : ranks) {
+            if (onTable && suit < kNumSuits && rank < kNumRanks) {
+                mask |= cardBit(suit, rank);
+            }
+        }
+    }
+    return mask;
+}
+
+} // namespace sevens
@@ -0,0 +1,576 @@
+#include "MatchServer.hpp"
+#include "CommandLine.hpp"
+#include "Tournament.hpp"
+#include <iostream>
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace sevens {
+
+namespace {
+
+constexpr const char* kDefaultSocket = "/tmp/sevens_game.sock";
+constexpr uint32_t kGamesPerSlice = 32;             // parties jouées pour un client avant de passer au suivant
+constexpr size_t kMaxPendingOutput = 1 << 20;       // au-delà, on attend que le client lise
+
+std::atomic<bool> stopRequested{false};
+
+extern "C" void onStopSignal(int) { stopRequested = true; }
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("[MatchServer] Socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error("[MatchServer] " + what + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+MatchServer::MatchServer(const std::string& socketPath) : socketPath(socketPath) {
+    const sockaddr_un address = socketAddress(socketPath);
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw systemError("socket");
+    }
+    unlink(socketPath.c_str()); // socket laissé par un démon précédent
+    const mode_t previousMask = umask(0177);
+    const int bound = bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    umask(previousMask);
+    if (bound < 0 || listen(listenFd, 128) < 0) {
+        close(listenFd);
+        throw systemError("bind/listen on " + socketPath);
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        close(listenFd);
+        throw systemError("epoll_create1");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+}
+
+MatchServer::~MatchServer() {
+    for (auto& [fd, client] : clients) {
+        close(fd);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void MatchServer::run() {
+    struct sigaction action{};
+    action.sa_handler = onStopSignal; // sans SA_RESTART : epoll_wait revient avec EINTR
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    epoll_event events[64];
+    std::vector<int> closing;
+    while (!stopRequested) {
+        bool busy = false;
+        for (const auto& [fd, client] : clients) {
+            busy |= client.job.active && client.out.size() - client.outOffset < kMaxPendingOutput;
+        }
+
+        // Des parties restent à jouer : on ne fait que sonder les sockets
+        const int count = epoll_wait(epollFd, events, 64, busy ? 0 : 1000);
+        if (count < 0 && errno != EINTR) {
+            throw systemError("epoll_wait");
+        }
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            auto it = clients.find(fd);
+            if (it == clients.end()) {
+                continue;
+            }
+            Client& client = it->second;
+            bool alive = !(events[i].events & (EPOLLHUP | EPOLLERR)) || (events[i].events & EPOLLIN);
+            if (alive && (events[i].events & EPOLLIN)) {
+                alive = readFrom(client) && parseRequests(client);
+            }
+            if (alive && (events[i].events & EPOLLOUT)) {
+                alive = writeTo(client);
+            }
+            if (!alive) {
+                closeClient(fd);
+            }
+        }
+
+        closing.clear();
+        for (auto& [fd, client] : clients) {
+            if (client.job.active && client.out.size() - client.outOffset < kMaxPendingOutput) {
+                advance(client);
+                if (!client.job.active && !parseRequests(client)) {
+                    closing.push_back(fd);
+                    continue;
+                }
+            }
+            if (client.outOffset < client.out.size() && !client.wantWrite && !writeTo(client)) {
+                closing.push_back(fd);
+            }
+        }
+        for (int fd : closing) {
+            closeClient(fd);
+        }
+    }
+    std::cout << "[MatchServer] Stopping.\n";
+}
+
+void MatchServer::acceptClients() {
+    for (;;) {
+        const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return; // EAGAIN : plus de connexion en attente
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        clients[fd].fd = fd;
+    }
+}
+
+bool MatchServer::readFrom(Client& client) {
+    uint8_t buffer[4096];
+    for (;;) {
+        const ssize_t received = read(client.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            client.in.insert(client.in.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received == 0) {
+            return false; // client parti
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+bool MatchServer::writeTo(Client& client) {
+    while (client.outOffset < client.out.size()) {
+        const ssize_t sent = write(client.fd, client.out.data() + client.outOffset, client.out.size() - client.outOffset);
+        if (sent > 0) {
+            client.outOffset += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+    if (client.outOffset == client.out.size()) {
+        client.out.clear();
+        client.outOffset = 0;
+    }
+
+    // EPOLLOUT seulement tant qu'il reste quelque chose à envoyer
+    const bool wantWrite = client.outOffset < client.out.size();
+    if (wantWrite != client.wantWrite) {
+        epoll_event event{};
+        event.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0u);
+        event.data.fd = client.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+        client.wantWrite = wantWrite;
+    }
+    return true;
+}
+
+void MatchServer::closeClient(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    clients.erase(fd);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MatchServer::parseRequests(Client& client) {
+    // Une seule requête à la fois par client : les suivantes attendent dans le buffer d'entrée
+    size_t offset = 0;
+    while (!client.job.active && client.in.size() - offset >= sizeof(protocol::FrameHeader)) {
+        protocol::FrameHeader header;
+        std::memcpy(&header, client.in.data() + offset, sizeof(header));
+        if (header.type != protocol::kMatchRequest || header.length < sizeof(protocol::MatchRequest) ||
+            header.length > protocol::kMaxFrameBytes) {
+            return false; // flux invalide : on coupe la connexion
+        }
+        if (client.in.size() - offset < sizeof(header) + header.length) {
+            break; // trame incomplète
+        }
+        const uint8_t* payload = client.in.data() + offset + sizeof(header);
+        offset += sizeof(header) + header.length;
+
+        protocol::MatchRequest request;
+        std::memcpy(&request, payload, sizeof(request));
+        if (request.magic != protocol::kMagic) {
+            return false;
+        }
+        std::vector<std::string> paths;
+        const char* text = reinterpret_cast<const char*>(payload + sizeof(request));
+        const char* end = reinterpret_cast<const char*>(payload + header.length);
+        while (text < end) {
+            const char* terminator = std::find(text, end, '\0');
+            paths.emplace_back(text, terminator);
+            text = terminator + 1;
+        }
+        startJob(client, request, paths);
+    }
+    client.in.erase(client.in.begin(), client.in.begin() + static_cast<std::ptrdiff_t>(offset));
+    return true;
+}
+
+void MatchServer::startJob(Client& client, const protocol::MatchRequest& request, const std::vector<std::string>& paths) {
+    if (paths.size() != request.numPlayers || paths.size() < kMinPlayers || paths.size() > kMaxPlayers) {
+        sendError(client, request.requestId, "Number of players must be between 3 and 7.");
+        return;
+    }
+    Job& job = client.job;
+    job.seats.clear();
+    try {
+        for (uint64_t seat = 0; seat < paths.size(); ++seat) {
+            job.seats.push_back(strategyFor(paths[seat], seat));
+        }
+    } catch (const std::exception& e) {
+        sendError(client, request.requestId, e.what());
+        return;
+    }
+    job.active = true;
+    job.requestId = request.requestId;
+    job.seed = request.seed;
+    job.games = request.games;
+    job.next = 0;
+    job.start = std::chrono::steady_clock::now();
+}
+
+void MatchServer::advance(Client& client) {
+    Job& job = client.job;
+    // Première tranche d'une seule partie : son résultat part sans attendre les suivantes
+    const uint32_t last = std::min(job.games, job.next == 0 ? 1 : job.next + kGamesPerSlice);
+    for (; job.next < last; ++job.next) {
+        GameOutcome outcome;
+        try {
+            // Instances partagées entre clients : réinitialisées à chaque partie, comme dans le tournoi,
+            // pour qu'une graine donne toujours les mêmes parties
+            for (uint64_t seat = 0; seat < job.seats.size(); ++seat) {
+                job.seats[seat]->initialize(seat);
+            }
+            Xoshiro256 rng(gameSeed(job.seed, job.next));
+            outcome = playGame(job.seats, kFullDeck, rng);
+        } catch (const std::exception& e) {
+            // Une stratégie qui lève une exception termine la requête de ce client, pas le démon
+            sendError(client, job.requestId, "Game " + std::to_string(job.next) + ": " + e.what());
+            job.active = false;
+            return;
+        } catch (...) {
+            sendError(client, job.requestId, "Game " + std::to_string(job.next) + ": unknown exception");
+            job.active = false;
+            return;
+        }
+
+        protocol::GameResult result{};
+        result.requestId = job.requestId;
+        result.game = job.next;
+        result.numPlayers = outcome.numPlayers;
+        result.rounds = outcome.rounds;
+        for (uint64_t p = 0; p < outcome.numPlayers; ++p) {
+            result.rank[p] = outcome.rank[p];
+            result.points[p] = outcome.points[p];
+        }
+        sendFrame(client, protocol::kGameResult, &result, sizeof(result));
+    }
+
+    if (job.next == job.games) {
+        protocol::MatchDone done{};
+        done.requestId = job.requestId;
+        done.games = job.games;
+        done.serverMicros = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - job.start).count());
+        sendFrame(client, protocol::kMatchDone, &done, sizeof(done));
+        job.active = false;
+    }
+}
+
+PlayerStrategy* MatchServer::strategyFor(const std::string& path, uint64_t seat) {
+    auto& strategy = warm[{path, seat}];
+    if (!strategy) {
+        auto& library = libraries[path];
+        if (!library) {
+            library = StrategyLibrary::open(path);
+            std::cout << "[MatchServer] Loaded " << path << "\n";
+        }
+        strategy = library->create();
+    }
+    return strategy.get();
+}
+
+void MatchServer::sendFrame(Client& client, uint32_t type, const void* payload, uint32_t length) {
+    const protocol::FrameHeader header{type, length};
+    const auto* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    const auto* payloadBytes = static_cast<const uint8_t*>(payload);
+    client.out.insert(client.out.end(), headerBytes, headerBytes + sizeof(header));
+    client.out.insert(client.out.end(), payloadBytes, payloadBytes + length);
+}
+
+void MatchServer::sendError(Client& client, uint32_t requestId, const std::string& message) {
+    std::vector<uint8_t> payload(sizeof(requestId) + message.size());
+    std::memcpy(payload.data(), &requestId, sizeof(requestId));
+    std::memcpy(payload.data() + sizeof(requestId), message.data(), message.size());
+    sendFrame(client, protocol::kError, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runServeMode(int argc, char* argv[]) {
+    const std::string path = argc > 2 ? argv[2] : kDefaultSocket;
+    try {
+        MatchServer server(path);
+        std::cout << "[MatchServer] Listening on " << path << "\n";
+        server.run();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+namespace {
+
+bool readExactly(int fd, void* data, size_t size) {
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t received = read(fd, bytes, size);
+        if (received <= 0) {
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool writeExactly(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t sent = write(fd, bytes, size);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+} // namespace
+
+int runRequestMode(int argc, char* argv[]) {
+    std::string path = kDefaultSocket;
+    uint64_t games = 10;
+    uint64_t seed = 1;
+    uint64_t repeat = 1;
+    std::vector<std::string> libraries;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            path = argv[++i];
+        } else if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[request]", arg, argv[++i], games)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[request]", arg, argv[++i], seed)) {
+                return 1;
+            }
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            if (!cli::parseCount("[request]", arg, argv[++i], repeat)) {
+                return 1;
+            }
+            repeat = std::max<uint64_t>(1, repeat);
+        } else {
+            libraries.push_back(arg);
+        }
+    }
+    if (libraries.size() < kMinPlayers || libraries.size() > kMaxPlayers) {
+        std::cerr << "[main] Request mode requires between 3 and 7 strategy libraries.\n";
+        return 1;
+    }
+    if (games > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "[request] --games must fit in 32 bits (MatchRequest::games).\n";
+        return 1;
+    }
+
+    // Le démon résout les chemins depuis son propre répertoire : on les envoie absolus
+    std::string paths;
+    for (const auto& library : libraries) {
+        paths += std::filesystem::absolute(library).lexically_normal().string();
+        paths.push_back('\0');
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const sockaddr_un address = socketAddress(path);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "[main] Cannot connect to " << path << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+
+    TournamentResults results;
+    results.seats.resize(libraries.size());
+    std::vector<double> latencies, firstResults; // par requête : réponse complète, premier GameResult
+    uint64_t serverMicros = 0;
+    bool ok = true;
+
+    for (uint64_t r = 0; r < repeat && ok; ++r) {
+        protocol::MatchRequest request{};
+        request.magic = protocol::kMagic;
+        request.requestId = static_cast<uint32_t>(r);
+        request.seed = seed + r;
+        request.games = static_cast<uint32_t>(games);
+        request.numPlayers = static_cast<uint8_t>(libraries.size());
+        const protocol::FrameHeader header{protocol::kMatchRequest, static_cast<uint32_t>(sizeof(request) + paths.size())};
+
+        const auto start = std::chrono::steady_clock::now();
+        ok = writeExactly(fd, &header, sizeof(header)) && writeExactly(fd, &request, sizeof(request)) &&
+             writeExactly(fd, paths.data(), paths.size());
+
+        bool done = false, firstSeen = false;
+        while (ok && !done) {
+            protocol::FrameHeader answer;
+            std::vector<uint8_t> payload;
+            ok = readExactly(fd, &answer, sizeof(answer)) && answer.length <= protocol::kMaxFrameBytes;
+            if (ok) {
+                payload.resize(answer.length);
+                ok = readExactly(fd, payload.data(), payload.size());
+            }
+            if (!ok) {
+                break;
+            }
+            if (answer.type == protocol::kGameResult && payload.size() == sizeof(protocol::GameResult)) {
+                if (!firstSeen) {
+                    firstSeen = true;
+                    firstResults.push_back(
+                        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                }
+                protocol::GameResult result;
+                std::memcpy(&result, payload.data(), sizeof(result));
+                GameOutcome outcome;
+                outcome.numPlayers = result.numPlayers;
+                outcome.rounds = result.rounds;
+                for (uint64_t p = 0; p < result.numPlayers; ++p) {
+                    outcome.rank[p] = result.rank[p];
+                    outcome.points[p] = result.points[p];
+                }
+                for (uint64_t seat = 0; seat < results.seats.size(); ++seat) {
+                    results.seats[seat].add(outcome, seat);
+                }
+                ++results.games;
+            } else if (answer.type == protocol::kMatchDone && payload.size() == sizeof(protocol::MatchDone)) {
+                protocol::MatchDone matchDone;
+                std::memcpy(&matchDone, payload.data(), sizeof(matchDone));
+                serverMicros += matchDone.serverMicros;
+                done = true;
+            } else if (answer.type == protocol::kError && payload.size() >= sizeof(uint32_t)) {
+                std::cerr << "[main] Server error: "
+                          << std::string(payload.begin() + sizeof(uint32_t), payload.end()) << "\n";
+                ok = false;
+            } else {
+                ok = false;
+            }
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    close(fd);
+    if (!ok) {
+        std::cerr << "[main] Request failed.\n";
+        return 1;
+    }
+
+    for (uint64_t seat = 0; seat < libraries.size(); ++seat) {
+        results.seats[seat].name = std::filesystem::path(libraries[seat]).stem().string();
+    }
+    Tournament::printResults(results);
+    // Une requête dure le temps de ses parties : la latence propre au démon se lit sur le premier
+    // résultat et sur la latence par partie, pas sur la réponse complète
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "[main] " << repeat << " request(s) of " << games << " games: latency median "
+              << std::fixed << std::setprecision(0) << latencies[latencies.size() / 2] << " us";
+    if (games) {
+        std::cout << " (" << std::setprecision(1) << latencies[latencies.size() / 2] / static_cast<double>(games)
+                  << " us per game)" << std::setprecision(0);
+    }
+    std::cout << ", max " << latencies.back() << " us, server time " << serverMicros / repeat << " us per request\n";
+    if (!firstResults.empty()) {
+        std::sort(firstResults.begin(), firstResults.end());
+        std::cout << "[main] First game result after " << firstResults[firstResults.size() / 2] << " us (median)\n";
+    }
+    return 0;
+}
+
+} // namespace sevens
+
+#else // !__linux__
+
+namespace sevens {
+
+int runServeMode(int, char*[]) {
+    std::cerr << "[main] Serve mode is only available on Linux (epoll).\n";
+    return 1;
+}
+
+int runRequestMode(int, char*[]) {
+    std::cerr << "[main] Request mode is only available on Linux.\n";
+    return 1;
+}
+
+} // namespace sevens
+
+#endif // __linux__
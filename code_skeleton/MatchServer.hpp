@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Engine.hpp"
+#include "StrategyLoader.hpp"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Binary protocol of the "serve" daemon (Unix domain socket, so native byte order).
+ * Every message is a FrameHeader followed by `length` bytes of payload:
+ *   client -> server : MatchRequest + numPlayers library paths, each terminated by '\0'
+ *   server -> client : one GameResult per game, then MatchDone (or Error + message text)
+ */
+namespace protocol {
+
+constexpr uint32_t kMagic = 0x314E5653;        // "SVN1"
+constexpr uint32_t kMaxFrameBytes = 64 * 1024; // requests are a few hundred bytes
+
+enum FrameType : uint32_t {
+    kMatchRequest = 1,
+    kGameResult = 2,
+    kMatchDone = 3,
+    kError = 4,
+};
+
+struct FrameHeader {
+    uint32_t type;
+    uint32_t length;
+};
+
+struct MatchRequest {
+    uint32_t magic;
+    uint32_t requestId; // echoed in every answer
+    uint64_t seed;      // game i is played with gameSeed(seed, i), as in the tournament
+    uint32_t games;
+    uint8_t numPlayers;
+    uint8_t reserved[3];
+};
+
+struct GameResult {
+    uint32_t requestId;
+    uint32_t game;
+    uint8_t numPlayers;
+    uint8_t rank[kMaxPlayers];
+    uint16_t points[kMaxPlayers];
+    uint16_t rounds;
+};
+
+struct MatchDone {
+    uint32_t requestId;
+    uint32_t games;
+    uint64_t serverMicros; // time between the request and its last result
+};
+
+static_assert(sizeof(MatchRequest) == 24 && sizeof(GameResult) == 32 && sizeof(MatchDone) == 16,
+              "protocol structs must not change size");
+
+} // namespace protocol
+
+/**
+ * Local tournament daemon: one thread, epoll over a Unix domain socket.
+ *
+ * Libraries stay loaded and strategy instances stay warm between requests,
+ * so a small match costs only its games. Instances are initialized at every
+ * game, so a seed gives the same games whatever was served before. Long
+ * matches are played in slices of a few games, so that one client cannot
+ * stall the others, and results are streamed as soon as they are computed.
+ * A strategy that throws ends its request with an Error frame.
+ *
+ * Linux only. The socket is created with mode 0600: connecting to it loads
+ * arbitrary libraries into the daemon.
+ */
+class MatchServer {
+public:
+    explicit MatchServer(const std::string& socketPath);
+    ~MatchServer();
+    MatchServer(const MatchServer&) = delete;
+    MatchServer& operator=(const MatchServer&) = delete;
+
+    // Serves until SIGINT / SIGTERM
+    void run();
+
+private:
+    struct Job {
+        bool active = false;
+        uint32_t requestId = 0;
+        uint64_t seed = 0;
+        uint32_t games = 0;
+        uint32_t next = 0;
+        std::vector<PlayerStrategy*> seats;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    struct Client {
+        int fd = -1;
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> out;
+        size_t outOffset = 0;
+        bool wantWrite = false;
+        Job job;
+    };
+
+    void acceptClients();
+    bool readFrom(Client& client);
+    bool writeTo(Client& client);
+    bool parseRequests(Client& client);
+    void startJob(Client& client, const protocol::MatchRequest& request, const std::vector<std::string>& paths);
+    void advance(Client& client);
+    void closeClient(int fd);
+
+    void sendFrame(Client& client, uint32_t type, const void* payload, uint32_t length);
+    void sendError(Client& client, uint32_t requestId, const std::string& message);
+
+    // Warm instance of library `path` for `seat`, loaded on first use (advance() initializes it at every game)
+    PlayerStrategy* strategyFor(const std::string& path, uint64_t seat);
+
+    std::string socketPath;
+    int listenFd = -1;
+    int epollFd = -1;
+    std::unordered_map<int, Client> clients;
+    std::map<std::string, std::shared_ptr<StrategyLibrary>> libraries;
+    std::map<std::pair<std::string, uint64_t>, std::shared_ptr<PlayerStrategy>> warm;
+};
+
+// Entry point of "./sevens_game serve [socket]"
+int runServeMode(int argc, char* argv[]);
+
+// Entry point of "./sevens_game request [--socket path] [--games N] [--seed S] [--repeat R] lib1 lib2 lib3 ..."
+int runRequestMode(int argc, char* argv[]);
+
+} // namespace sevens
@@ -0,0 +1,411 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace sevens {
+
+namespace metrics {
+
+namespace {
+
+std::atomic<size_t> nextStripe{0};
+
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c == '\n' ? ' ' : c;
+    }
+    return out;
+}
+
+} // namespace
+
+size_t threadStripe() {
+    thread_local const size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return stripe;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Slot& slot : slots) {
+        total += slot.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot result;
+    for (const Stripe& stripe : stripes) {
+        for (uint64_t b = 0; b <= kBuckets; ++b) {
+            result.counts[b] += stripe.counts[b].load(std::memory_order_relaxed);
+        }
+        result.sumNanos += stripe.sum.load(std::memory_order_relaxed);
+    }
+    for (uint64_t count : result.counts) {
+        result.count += count;
+    }
+    return result;
+}
+
+double Histogram::Snapshot::quantile(double q) const {
+    const double target = q * static_cast<double>(count);
+    uint64_t seen = 0;
+    for (uint64_t b = 0; b < kBuckets; ++b) {
+        seen += counts[b];
+        if (count && static_cast<double>(seen) >= target) {
+            return bound(b);
+        }
+    }
+    return count ? bound(kBuckets) : 0.0;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+Registry::Entry& Registry::find(Kind kind, const std::string& name, const std::string& help, const std::string& label) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Entry& entry : entries) {
+        if (entry.name == name && entry.label == label) {
+            if (entry.kind != kind) {
+                throw std::runtime_error("[Metrics] " + name + " is already registered with another type.");
+            }
+            return entry;
+        }
+    }
+    Entry& entry = entries.emplace_back();
+    entry.kind = kind;
+    entry.name = name;
+    entry.help = help;
+    entry.label = label;
+    return entry;
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help, const std::string& label) {
+    return find(Kind::counter, name, help, label).counter;
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help, const std::string& label) {
+    return find(Kind::gauge, name, help, label).gauge;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help, const std::string& label) {
+    return find(Kind::histogram, name, help, label).histogram;
+}
+
+std::string Registry::prometheus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << std::setprecision(9);
+    std::vector<std::string> written;
+    for (const Entry& first : entries) {
+        if (std::find(written.begin(), written.end(), first.name) != written.end()) {
+            continue;
+        }
+        written.push_back(first.name);
+        static const char* kTypes[] = {"counter", "gauge", "histogram"};
+        out << "# HELP " << first.name << " " << first.help << "\n";
+        out << "# TYPE " << first.name << " " << kTypes[static_cast<int>(first.kind)] << "\n";
+
+        // Toutes les séries du même nom sont regroupées sous un seul en-tête
+        for (const Entry& entry : entries) {
+            if (entry.name != first.name) {
+                continue;
+            }
+            const std::string label = entry.label.empty() ? "" : "strategy=\"" + escape(entry.label) + "\"";
+            const std::string braces = label.empty() ? "" : "{" + label + "}";
+            if (entry.kind == Kind::counter) {
+                out << entry.name << braces << " " << entry.counter.value() << "\n";
+            } else if (entry.kind == Kind::gauge) {
+                out << entry.name << braces << " " << entry.gauge.value() << "\n";
+            } else {
+                const Histogram::Snapshot snap = entry.histogram.snapshot();
+                const std::string prefix = label.empty() ? "" : label + ",";
+                uint64_t cumulative = 0;
+                for (uint64_t b = 0; b < Histogram::kBuckets; ++b) {
+                    cumulative += snap.counts[b];
+                    out << entry.name << "_bucket{" << prefix << "le=\"" << Histogram::bound(b) << "\"} " << cumulative << "\n";
+                }
+                out << entry.name << "_bucket{" << prefix << "le=\"+Inf\"} " << snap.count << "\n";
+                out << entry.name << "_sum" << braces << " " << static_cast<double>(snap.sumNanos) * 1e-9 << "\n";
+                out << entry.name << "_count" << braces << " " << snap.count << "\n";
+            }
+        }
+    }
+    return out.str();
+}
+
+std::string Registry::json() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\"time\": " << std::time(nullptr);
+    std::vector<std::string> written;
+    for (const Entry& first : entries) {
+        if (std::find(written.begin(), written.end(), first.name) != written.end()) {
+            continue;
+        }
+        written.push_back(first.name);
+        out << ", \"" << first.name << "\": ";
+
+        // Métrique sans label : valeur directe ; avec labels : objet label -> valeur
+        const bool labelled = !first.label.empty();
+        bool comma = false;
+        if (labelled) {
+            out << "{";
+        }
+        for (const Entry& entry : entries) {
+            if (entry.name != first.name) {
+                continue;
+            }
+            if (labelled) {
+                out << (comma ? ", " : "") << "\"" << escape(entry.label) << "\": ";
+                comma = true;
+            }
+            if (entry.kind == Kind::counter) {
+                out << entry.counter.value();
+            } else if (entry.kind == Kind::gauge) {
+                out << entry.gauge.value();
+            } else {
+                const Histogram::Snapshot snap = entry.histogram.snapshot();
+                const double mean = snap.count ? static_cast<double>(snap.sumNanos) * 1e-9 / snap.count : 0.0;
+                out << "{\"count\": " << snap.count << ", \"mean\": " << mean << ", \"p50\": " << snap.quantile(0.5)
+                    << ", \"p99\": " << snap.quantile(0.99) << ", \"p999\": " << snap.quantile(0.999) << "}";
+            }
+            if (!labelled) {
+                break;
+            }
+        }
+        if (labelled) {
+            out << "}";
+        }
+    }
+    out << "}\n";
+    return out.str();
+}
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+GameMetrics& gameMetrics() {
+    static GameMetrics instance{
+        registry().counter("sevens_games_total", "Games finished."),
+        registry().counter("sevens_moves_total", "Turns played (cards and passes), forced moves and cached decisions included."),
+        registry().counter("sevens_passes_total", "Turns that were a pass, forced and cached ones included."),
+        registry().gauge("sevens_active_workers", "Worker threads currently playing games."),
+    };
+    return instance;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+Exporter::Exporter(const std::string& listen, const std::string& jsonPath, double intervalSeconds)
+    : jsonPath(jsonPath), interval(intervalSeconds > 0 ? intervalSeconds : 5.0) {
+    if (!listen.empty()) {
+#ifndef _WIN32
+        // Le destructeur ne tourne pas si le constructeur lève : chaque erreur ferme le socket elle-même
+        const auto fail = [this](const std::string& message) {
+            if (listenFd >= 0) {
+                close(listenFd);
+                listenFd = -1;
+            }
+            throw std::runtime_error(message);
+        };
+        const bool port = listen.find_first_not_of("0123456789") == std::string::npos;
+        if (port) {
+            if (listen.size() > 5 || std::stoul(listen) > 65535) {
+                throw std::runtime_error("[Metrics] Not a TCP port: " + listen);
+            }
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(std::stoul(listen)));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // exposition locale seulement
+            listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const int reuse = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+                fail("[Metrics] Cannot listen on port " + listen + ": " + std::strerror(errno));
+            }
+        } else {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (listen.size() >= sizeof(address.sun_path)) {
+                throw std::runtime_error("[Metrics] Socket path too long: " + listen);
+            }
+            std::memcpy(address.sun_path, listen.c_str(), listen.size() + 1);
+            unlink(listen.c_str());
+            listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+                fail("[Metrics] Cannot listen on " + listen + ": " + std::strerror(errno));
+            }
+            socketPath = listen;
+        }
+        if (::listen(listenFd, 16) < 0) {
+            fail(std::string("[Metrics] listen: ") + std::strerror(errno));
+        }
+#else
+        throw std::runtime_error("[Metrics] The metrics server is not available on Windows, use a JSON file.");
+#endif
+    }
+    gameMetrics();
+    lastSample = std::chrono::steady_clock::now();
+    thread = std::thread([this]() { run(); });
+}
+
+Exporter::~Exporter() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+#ifndef _WIN32
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+    }
+#endif
+}
+
+void Exporter::run() {
+    while (!stopping) {
+#ifndef _WIN32
+        if (listenFd >= 0) {
+            pollfd entry{listenFd, POLLIN, 0};
+            if (poll(&entry, 1, 100) > 0) {
+                const int fd = accept(listenFd, nullptr, nullptr);
+                if (fd >= 0) {
+                    serveClient(fd);
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+#endif
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - lastSample).count() >= interval) {
+            sample();
+        }
+    }
+    sample(); // dernier instantané : valeurs finales du run
+}
+
+void Exporter::sample() {
+    static Gauge& gamesRate = registry().gauge("sevens_games_per_second", "Games finished per second over the last interval.");
+    static Gauge& movesRate = registry().gauge("sevens_moves_per_second", "Decisions per second over the last interval.");
+    static Gauge& passRate = registry().gauge("sevens_pass_rate_permille", "Passes per thousand decisions since the start.");
+
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(now - lastSample).count();
+    const GameMetrics& game = gameMetrics();
+    const uint64_t games = game.games.value();
+    const uint64_t moves = game.moves.value();
+    if (seconds > 0) {
+        gamesRate.set(std::llround((games - lastGames) / seconds));
+        movesRate.set(std::llround((moves - lastMoves) / seconds));
+    }
+    passRate.set(moves ? static_cast<int64_t>(game.passes.value() * 1000 / moves) : 0);
+    lastGames = games;
+    lastMoves = moves;
+    lastSample = now;
+
+    if (!jsonPath.empty()) {
+        const std::string temporary = jsonPath + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            out << registry().json();
+        }
+        std::rename(temporary.c_str(), jsonPath.c_str()); // un lecteur ne voit jamais un instantané tronqué
+    }
+}
+
+void Exporter::serveClient(int fd) {
+#ifndef _WIN32
+    // Requête ignorée (GET /metrics ou autre) : une seule ressource
+    pollfd entry{fd, POLLIN, 0};
+    char request[4096];
+    if (poll(&entry, 1, 500) > 0) {
+        (void)!read(fd, request, sizeof(request));
+    }
+    const std::string body = registry().prometheus();
+    const std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                                 std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    close(fd);
+#else
+    (void)fd;
+#endif
+}
+
+} // namespace metrics
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+MeteredStrategy::MeteredStrategy(std::shared_ptr<PlayerStrategy> inner, const std::string& label)
+    : inner(std::move(inner)),
+      shared(metrics::gameMetrics()),
+      decisions(metrics::registry().counter("sevens_strategy_moves_total",
+                                            "Calls of selectCardToPlay, per strategy (not the forced or cached turns).", label)),
+      passes(metrics::registry().counter("sevens_strategy_passes_total", "Calls that returned a pass, per strategy.", label)),
+      latency(metrics::registry().histogram("sevens_decision_latency_seconds",
+                                            "selectCardToPlay wall time of one decision in 16, per strategy.", label)) {}
+
+int MeteredStrategy::selectCardToPlay(
+    const std::vector<Card>& hand,
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
+    int chosen;
+    if (++calls % kTimeEvery == 0) {
+        const auto start = std::chrono::steady_clock::now();
+        chosen = inner->selectCardToPlay(hand, tableLayout);
+        latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    } else {
+        chosen = inner->selectCardToPlay(hand, tableLayout);
+    }
+    ++pendingMoves;
+    pendingPasses += chosen < 0;
+    if (pendingMoves == kFlushEvery) {
+        flush();
+    }
+    return chosen;
+}
+
+void MeteredStrategy::flush() {
+    decisions.add(pendingMoves);
+    shared.moves.add(pendingMoves);
+    passes.add(pendingPasses);
+    shared.passes.add(pendingPasses);
+    pendingMoves = 0;
+    pendingPasses = 0;
+}
+
+} // namespace sevens
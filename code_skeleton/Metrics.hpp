@@ -0,0 +1,202 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace sevens {
+
+/**
+ * Live metrics of long runs: lock-free counters, gauges and latency histograms.
+ *
+ * Counters and histograms are striped: every thread writes its own cache line with a relaxed
+ * atomic add, so recording costs a few nanoseconds and workers never contend. Readers sum the
+ * stripes. Metrics live in one process-wide Registry and are never destroyed; a hot path looks
+ * a metric up once and keeps the reference.
+ */
+namespace metrics {
+
+constexpr size_t kStripes = 16;
+
+// Stripe of the calling thread (assigned round-robin on first use)
+size_t threadStripe();
+
+class Counter {
+public:
+    void add(uint64_t n = 1) { slots[threadStripe()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Slot, kStripes> slots;
+};
+
+class Gauge {
+public:
+    void set(int64_t v) { current.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { current.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> current{0};
+};
+
+/**
+ * Latency histogram with power-of-two buckets: bucket b counts durations < 2^(b + kFirstBucket) ns
+ * (256 ns to about 8.6 s), the last one everything above.
+ */
+class Histogram {
+public:
+    static constexpr uint64_t kFirstBucket = 8;
+    static constexpr uint64_t kBuckets = 26;
+
+    void record(uint64_t nanos) {
+        const uint64_t high = nanos >> kFirstBucket;
+        const uint64_t bucket = high ? 64 - static_cast<uint64_t>(__builtin_clzll(high)) : 0;
+        Stripe& stripe = stripes[threadStripe()];
+        stripe.counts[bucket < kBuckets ? bucket : kBuckets].fetch_add(1, std::memory_order_relaxed);
+        stripe.sum.fetch_add(nanos, std::memory_order_relaxed);
+    }
+
+    // Upper bound of bucket b in seconds
+    static double bound(uint64_t bucket) { return static_cast<double>(1ULL << (bucket + kFirstBucket)) * 1e-9; }
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets + 1> counts{};
+        uint64_t count = 0;
+        uint64_t sumNanos = 0;
+
+        // Approximate quantile (upper bound of the bucket holding it), in seconds
+        double quantile(double q) const;
+    };
+    Snapshot snapshot() const;
+
+private:
+    struct alignas(64) Stripe {
+        std::array<std::atomic<uint64_t>, kBuckets + 1> counts{};
+        std::atomic<uint64_t> sum{0};
+    };
+    std::array<Stripe, kStripes> stripes;
+};
+
+/**
+ * Named metrics of the process. Registration takes a mutex (rare), recording never does.
+ * Names follow Prometheus conventions; `label` is an optional strategy="..." label value.
+ */
+class Registry {
+public:
+    Counter& counter(const std::string& name, const std::string& help, const std::string& label = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& label = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& label = "");
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string prometheus() const;
+
+    // One JSON object: every metric, plus the rates computed by the exporter
+    std::string json() const;
+
+private:
+    enum class Kind { counter, gauge, histogram };
+    struct Entry {
+        Kind kind;
+        std::string name, help, label;
+        Counter counter;
+        Gauge gauge;
+        Histogram histogram;
+    };
+    Entry& find(Kind kind, const std::string& name, const std::string& help, const std::string& label);
+
+    mutable std::mutex mutex;
+    std::deque<Entry> entries; // adresses stables : les références données aux threads restent valides
+};
+
+Registry& registry();
+
+/**
+ * Background thread of a run with metrics: every `interval` it updates the rate gauges
+ * (games/s, moves/s, pass rate), rewrites the JSON snapshot (temporary file then rename),
+ * and meanwhile answers HTTP GETs with the Prometheus text.
+ *   listen: "" (no server), a TCP port on 127.0.0.1, or the path of a Unix socket.
+ */
+class Exporter {
+public:
+    // @throws std::runtime_error if the listening socket cannot be opened.
+    Exporter(const std::string& listen, const std::string& jsonPath, double intervalSeconds);
+    ~Exporter();
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+private:
+    void run();
+    void sample();
+    void serveClient(int fd);
+
+    std::string jsonPath;
+    std::string socketPath;
+    double interval;
+    int listenFd = -1;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+    uint64_t lastGames = 0, lastMoves = 0;
+    std::chrono::steady_clock::time_point lastSample;
+};
+
+// Metrics every game driver shares
+struct GameMetrics {
+    Counter& games;
+    Counter& moves;
+    Counter& passes;
+    Gauge& activeWorkers;
+};
+GameMetrics& gameMetrics();
+
+} // namespace metrics
+
+/**
+ * Decorator recording the decisions of the wrapped strategy: moves and passes counters and a
+ * decision latency histogram labelled with `label`. It only sees the calls: the turns the engine
+ * plays without one (--fast-forward, --memoize hits) reach the shared totals through
+ * GameOutcome, in Tournament::recordGame, and never the per-strategy counters. Like AccountedStrategy, the engine is
+ * unchanged: a run without metrics pays nothing. An instance is used by one thread at a time,
+ * so counts are kept locally and published every kFlushEvery decisions, and only one
+ * decision in kTimeEvery is timed: a cheap strategy stays within a few percent of its speed.
+ */
+class MeteredStrategy : public PlayerStrategy {
+public:
+    static constexpr uint64_t kFlushEvery = 64;
+    static constexpr uint64_t kTimeEvery = 16;
+
+    MeteredStrategy(std::shared_ptr<PlayerStrategy> inner, const std::string& label);
+    ~MeteredStrategy() override { flush(); }
+
+    void initialize(uint64_t playerID) override { inner->initialize(playerID); }
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override;
+    void observeMove(uint64_t playerID, const Card& playedCard) override { inner->observeMove(playerID, playedCard); }
+    void observePass(uint64_t playerID) override { inner->observePass(playerID); }
+    std::string getName() const override { return inner->getName(); }
+
+private:
+    void flush();
+
+    std::shared_ptr<PlayerStrategy> inner;
+    uint64_t calls = 0;
+    uint64_t pendingMoves = 0;
+    uint64_t pendingPasses = 0;
+    metrics::GameMetrics& shared;
+    metrics::Counter& decisions;
+    metrics::Counter& passes;
+    metrics::Histogram& latency;
+};
+
+} // namespace sevens
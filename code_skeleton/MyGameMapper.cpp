@@ -11,6 +11,7 @@
 namespace sevens {
 
 MyGameMapper::MyGameMapper() {
+    handBuffer.reserve(kNumSuits * kNumRanks);
     // TODO: Possibly seed random engine, etc.
     // Initialisation du moteur aléatoire avec le temps système 
     random_engine.seed(std::chrono::steady_clock::now().time_since_epoch().count());
@@ -29,6 +30,7 @@ void MyGameMapper::read_cards(const std::string& filename) {
     try {
         MyCardParser parser;
         parser.read_cards(filename);
+        cards_hashmap = parser.get_cards_hashmap();
         std::cout << "[MyGameMapper::read_cards] Loaded " << cards_hashmap.size() << " cards.\n";
     } catch (const std::exception& e){
         std::cerr << "[MyGameMapper::read_cards] Loading error : " << e.what() << "\n";
@@ -129,130 +131,143 @@ const std::unordered_map<uint64_t, std::shared_ptr<PlayerStrategy>>& MyGameMappe
 // -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 
-// Simule une partie sans affichage, renvoie la progression du jeu (sous forme de paires suit/rank)
-std::vector<std::pair<uint64_t, uint64_t>> MyGameMapper::compute_game_progress(uint64_t numPlayers) {
-    if (numPlayers < 3 || numPlayers > 7) {
-        throw std::runtime_error("[MyGameMapper] Number of players must be between 3 and 7.");
-    }
+void MyGameMapper::seed(uint64_t value) {
+    random_engine.seed(static_cast<std::mt19937::result_type>(value));
+}
 
-    finalResults.clear();
-    playerHands.clear();
-    playerScores.clear();
 
-    for (uint64_t playerID = 0; playerID < numPlayers; ++playerID) {
-        playerHands[playerID] = {};
-        playerScores[playerID] = 0;
-    }
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-    std::vector<Card> deck;
-    for (const auto& [id, card] : cards_hashmap) {
-        deck.push_back(card);
-    }
 
-    bool gameOver = false;
-    while (!gameOver) {
-        // Reset table and redistribute cards for new round
-        table_layout.clear();
-        std::shuffle(deck.begin(), deck.end(), random_engine);
-        for (size_t i = 0; i < deck.size(); ++i) {
-            playerHands[i % numPlayers].push_back(deck[i]);
-        }
-        for (const auto& [id, card] : cards_hashmap) {
-            if (card.rank == 6 && card.suit <= 3) {
-                table_layout[card.suit][card.rank] = true;
-            }
-        }
+const GameState& MyGameMapper::getGameState() const {
+    return gameState;
+}
 
-        // Simulate one round
-        bool roundOver = false;
-        uint64_t winnerID = 0;
-        while (!roundOver) {
-            for (uint64_t playerID = 0; playerID < numPlayers; ++playerID) {
-                auto strategyIt = playerStrategies.find(playerID);
-                if (strategyIt == playerStrategies.end()) {
-                    std::cerr << "[MyGameMapper] No strategy for player " << playerID << "\n";
-                    continue;
-                }
 
-                auto& strategy = strategyIt->second;
-                auto& hand = playerHands[playerID];
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-                if (hand.empty()) {
-                    roundOver = true;
-                    winnerID = playerID;
-                    if (verboseMode) {
-                        std::cout << strategy->getName() << "-" << playerID << " finished with rank 1 in this round!\n";
-                    }
-                    break;
-                }
 
-                int cardIndex = strategy->selectCardToPlay(hand, table_layout);
-                if (cardIndex >= 0 && static_cast<size_t>(cardIndex) < hand.size()) {
-                    Card card = hand[cardIndex];
-                    bool playable = (card.rank == 6 && !table_layout[card.suit].count(6)) ||
-                                    (table_layout[card.suit].count(card.rank - 1) || table_layout[card.suit].count(card.rank + 1));
-                    if (playable) {
-                        table_layout[card.suit][card.rank] = true;
-                        if (verboseMode) {
-                            std::cout << strategy->getName() << "-" << playerID << " plays " << card << "\n";
-                        }
-                        hand.erase(hand.begin() + cardIndex);
-                    } else {
-                        if (verboseMode) {
-                            std::cout << strategy->getName() << "-" << playerID << " passes (invalid card)\n";
-                        }
-                    }
-                } else {
-                    if (verboseMode) {
-                        std::cout << strategy->getName() << "-" << playerID << " passes\n";
-                    }
-                }
-            }
-        }
+Move MyGameMapper::requestMove(uint64_t playerID) {
+    auto strategyIt = playerStrategies.find(playerID);
+    if (strategyIt == playerStrategies.end()) {
+        std::cerr << "[MyGameMapper] No strategy for player " << playerID << "\n";
+        return Move::pass(playerID);
+    }
 
-        // Award points for leftover cards
-        for (uint64_t playerID = 0; playerID < numPlayers; ++playerID) {
-            if (playerID != winnerID) {
-                playerScores[playerID] += playerHands[playerID].size();
-                if (verboseMode) {
-                    std::cout << playerStrategies[playerID]->getName() << "-" << playerID << " scored " << playerHands[playerID].size() << " points\n";
-                }
+    auto& strategy = strategyIt->second;
+
+    // Avance rapide : un tour sans choix ne coûte pas d'appel à la stratégie
+    Move forced;
+    if (roundRules.fastForward && gameState.forcedMove(forced)) {
+        ++skippedCalls;
+        if (verboseMode) {
+            if (forced.isPass()) {
+                std::cout << strategy->getName() << "-" << playerID << " passes (no playable card)\n";
+            } else {
+                std::cout << strategy->getName() << "-" << playerID << " plays "
+                          << cardFromIndex(static_cast<uint64_t>(forced.card)) << " (forced)\n";
             }
-            playerHands[playerID].clear(); // Prepare for next round
         }
+        return forced;
+    }
+
+    handToCards(gameState.hands[playerID], handBuffer);
 
-        // Check game over condition
-        for (const auto& [playerID, score] : playerScores) {
-            if (score >= 50) {
-                gameOver = true;
-                break;
+    int chosen = strategy->selectCardToPlay(handBuffer, table_layout);
+    if (chosen >= 0 && static_cast<size_t>(chosen) < handBuffer.size()) {
+        const Card& card = handBuffer[chosen];
+        Move move = Move::play(playerID, cardIndex(card.suit, card.rank));
+        if (gameState.isLegal(move)) {
+            if (verboseMode) {
+                std::cout << strategy->getName() << "-" << playerID << " plays " << card << "\n";
             }
+            return move;
+        }
+        if (verboseMode) {
+            std::cout << strategy->getName() << "-" << playerID << " passes (invalid card)\n";
         }
+    } else if (verboseMode) {
+        std::cout << strategy->getName() << "-" << playerID << " passes\n";
     }
+    return Move::pass(playerID);
+}
 
-    // Determine final rankings
-    uint64_t lastPlaceID = 0;
-    for (const auto& [playerID, score] : playerScores) {
-        if (score >= 50) {
-            lastPlaceID = playerID;
-            break;
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+
+void MyGameMapper::broadcastMove(Move move) {
+    for (const auto& [otherID, other] : playerStrategies) {
+        if (otherID == move.player) {
+            continue;
+        }
+        if (move.isPass()) {
+            other->observePass(move.player);
+        } else {
+            other->observeMove(move.player, cardFromIndex(static_cast<uint64_t>(move.card)));
         }
     }
-    finalResults.emplace_back(lastPlaceID, numPlayers); // Last place (rank = numPlayers)
+}
 
-    std::vector<std::pair<uint64_t, uint64_t>> remainingPlayers;
-    for (uint64_t playerID = 0; playerID < numPlayers; ++playerID) {
-        if (playerID != lastPlaceID) {
-            remainingPlayers.emplace_back(playerID, playerScores[playerID]);
-        }
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+
+// Simule une partie sans affichage, renvoie la progression du jeu (sous forme de paires suit/rank)
+// Toute la logique des règles vit dans GameState : cette méthode ne fait que piloter les stratégies.
+std::vector<std::pair<uint64_t, uint64_t>> MyGameMapper::compute_game_progress(uint64_t numPlayers) {
+    if (numPlayers < kMinPlayers || numPlayers > kMaxPlayers) {
+        throw std::runtime_error("[MyGameMapper] Number of players must be between 3 and 7.");
     }
-    std::sort(remainingPlayers.begin(), remainingPlayers.end(),
-              [](const auto& a, const auto& b) { return a.second < b.second; });
 
-    for (size_t i = 0; i < remainingPlayers.size(); ++i) {
-        finalResults.emplace_back(remainingPlayers[i].first, i + 1);
+    const uint64_t deck = deckFromCards(cards_hashmap);
+    gameState.reset(numPlayers);
+    roundsPlayed = 0;
+    stalledRounds = 0;
+    skippedCalls = 0;
+
+    while (!gameState.isGameOver()) {
+        // Reset table and redistribute cards for new round
+        gameState.deal(deck, random_engine);
+        tableLayout.reset(gameState.table);
+
+        // Simulate one round (stopped if nobody has played a card for roundRules.stallLimit turns)
+        uint64_t idleTurns = 0;
+        bool stalled = false;
+        while (!gameState.isTerminal() && !stalled) {
+            Move move = requestMove(gameState.current);
+            gameState.apply(move);
+            if (!move.isPass()) {
+                const Card card = cardFromIndex(static_cast<uint64_t>(move.card));
+                tableLayout.place(card.suit, card.rank);
+            }
+            broadcastMove(move);
+            idleTurns = move.isPass() ? idleTurns + 1 : 0;
+            stalled = roundRules.stallLimit && idleTurns >= roundRules.stallLimit && !gameState.isTerminal();
+        }
+        stalledRounds += stalled;
+
+        // Award points for leftover cards (a stalled round has no winner: everybody scores their hand)
+        const int winnerID = gameState.winner();
+        const auto roundScores = gameState.scores();
+        if (verboseMode) {
+            if (stalled) {
+                std::cout << "Round stalled after " << idleTurns << " turns without a card played\n";
+            } else {
+                std::cout << playerStrategies[winnerID]->getName() << "-" << winnerID << " finished with rank 1 in this round!\n";
+            }
+            for (uint64_t playerID = 0; playerID < numPlayers; ++playerID) {
+                if (static_cast<int>(playerID) != winnerID) {
+                    std::cout << playerStrategies[playerID]->getName() << "-" << playerID << " scored " << roundScores[playerID] << " points\n";
+                }
+            }
+        }
+        gameState.settleRound();
+        ++roundsPlayed;
     }
 
+    // Determine final rankings
+    finalResults = rankPlayers(gameState);
     return finalResults;
 }
 
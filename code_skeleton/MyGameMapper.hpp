@@ -3,6 +3,7 @@
 #include "Generic_game_mapper.hpp"
 #include "MyCardParser.hpp"
 #include "PlayerStrategy.hpp"
+#include "GameState.hpp"
 #include <random> // la génération de nombres aléatoires modernes avec son contenu --> (des généateur pseudo-aléatoire(engines),des distributions)
 #include <unordered_map> // Unordered map est une collection de paires clé-valeur, où les clés sont uniques et non ordonnées, ce qui signifie que les éléments ne sont pas triés
 #include <vector> // C’est une directive pour inclure la bibliothèque standard C++ qui contient le type std::vector --> un tableau dynamique --> pouvoir changer de taille à l'exécution + facilement ajouter ou retirer .push_back(),.pop_back() + plus flexible que les tableaux int[] classiques
@@ -43,6 +44,22 @@ public:
     // Nouvelle méthode pour obtenir le nombre de stratégies enregistrées
     size_t getRegisteredPlayerCount() const;
 
+    // Fixe la graine du générateur (parties reproductibles)
+    void seed(uint64_t value);
+
+    // State of the last simulated game (can be copied freely)
+    const GameState& getGameState() const;
+
+    // Number of rounds of the last simulated game
+    uint64_t getRoundsPlayed() const { return roundsPlayed; }
+
+    // Stall limit and fast-forward of the next games (see RoundRules)
+    void setRoundRules(const RoundRules& rules) { roundRules = rules; }
+
+    // Rounds of the last game stopped by the stall limit, and forced moves applied without calling a strategy
+    uint64_t getStalledRounds() const { return stalledRounds; }
+    uint64_t getSkippedCalls() const { return skippedCalls; }
+
 private:
     // You can define any data structures needed to track the game
     // E.g., player hands, table layout, random engine, etc.
@@ -54,9 +71,22 @@ private:
     // Générateur de nombres aléatoires pour les actions aléatoires (distribution des cartes,etc)
     std::mt19937 random_engine ; // std::mt19937 est un moteur de génération de nombres pseudo-alétoire (algo Mersenne Twister version de 19937 bits de période)
 
-    // Main de chaque joueur (playerID -> vecteur de cartes)
-    // Chaque carte est représentée par un couple (suit,rank)
-    std::unordered_map<uint64_t,std::vector<Card>> playerHands;
+    // État compact de la partie : mains, table et scores (voir GameState.hpp)
+    GameState gameState;
+
+    // Main du joueur courant, telle que passée à selectCardToPlay
+    std::vector<Card> handBuffer;
+
+    // Garde table_layout synchronisée avec la table sans allocation
+    TableLayout tableLayout{table_layout};
+
+    // Nombre de manches de la dernière partie
+    uint64_t roundsPlayed = 0;
+
+    // Limite de blocage et avance rapide des coups forcés, compteurs de la dernière partie
+    RoundRules roundRules;
+    uint64_t stalledRounds = 0;
+    uint64_t skippedCalls = 0;
 
     // Résultats finaux du jeu (playerID -> range obtenu)
     std::vector<std::pair<uint64_t,uint64_t>> finalResults;
@@ -64,8 +94,11 @@ private:
     // Mode d'affichage verbeux (utile pour debug ou affichage utilisateur)
     bool verboseMode = false ;
 
-    // Track scores for each player
-    std::unordered_map<uint64_t, uint64_t> playerScores; 
+    // Asks the strategy of the current player for a move and validates it against the rules
+    Move requestMove(uint64_t playerID);
+
+    // Informs every other strategy about the move that was just played
+    void broadcastMove(Move move);
 };
 
 } // namespace sevens
@@ -1,4 +1,6 @@
 #include "PlayerStrategy.hpp"
+#include "HandAnalysis.hpp"
+#include "Simulator.hpp"
 #include <algorithm>
 #include <vector>
 #include <string>
@@ -6,6 +8,7 @@
 #include <chrono>
 #include <cstdint>
 #include <memory> 
+#include <limits>
 
 namespace sevens {
 
@@ -27,7 +30,7 @@ public:
     
     void initialize(uint64_t playerID) override {
         myID = playerID;
-        // TODO: any further initialization
+        seeded = false;
     }
 
     
@@ -40,44 +43,31 @@ public:
             return -1;
         }
 
-        int bestIndex = -1;
-        int bestScore = -1;
+        // Masques de la main et de la table : une seule passe, puis tout se fait en opérations sur bits
+        const uint64_t handBits = handMask(hand);
+        const uint64_t tableBits = tableMask(tableLayout);
+        const uint64_t chosen = heuristic.pick(handBits, tableBits, playableMask(handBits, tableBits));
 
-        for (size_t i = 0; i < hand.size(); ++i) {
-            const Card& card = hand[i];
-            uint64_t suit = card.suit;
-            uint64_t rank = card.rank;
-
-            bool playable = false;
-            if (rank == 6) {
-                // playable = true;
-                if (tableLayout.find(suit) == tableLayout.end() ||
-                    tableLayout.at(suit).find(6) == tableLayout.at(suit).end()) {
-                    playable = true;
-                }
-            } else if (tableLayout.count(suit)) {
-                const auto& suitMap = tableLayout.at(suit);
-                if ((rank > 0 && suitMap.count(rank - 1) && suitMap.at(rank - 1)) ||
-                    (rank < 12 && suitMap.count(rank + 1) && suitMap.at(rank + 1))) {
-                    playable = true;
-                }
-            }
+        // Graine tirée de la première position de la partie (notre donne, la table à notre premier tour) :
+        // des tirages du bluff propres à chaque partie, reproductibles, et communs aux deux candidats du mode tune
+        if (!seeded) {
+            rng.seed(static_cast<std::mt19937::result_type>(splitMix64(handBits ^ splitMix64(tableBits + myID))));
+            seeded = true;
+        }
 
-            if (playable) {
-                int score = static_cast<int>(rank);
-
-                // Bonus si cette carte débloque une autre carte de notre main
-                for (const Card& other : hand) {
-                    if (other.suit == suit &&
-                        (other.rank == rank + 1 || other.rank == rank - 1)) {
-                        score += 5;
-                    }
-                }
-
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestIndex = static_cast<int>(i);
-                }
+        // Rétention (bluff) : avec plus de 5 cartes, passer avec la probabilité bluffPass même si on peut jouer
+        if (chosen && bluffPass > 0 && hand.size() > kBluffMinCards &&
+            std::uniform_real_distribution<double>(0.0, 1.0)(rng) < bluffPass) {
+            return -1;
+        }
+
+        // Même heuristique que la politique de simulation policy::Neighbour, on retrouve l'index de la carte choisie
+        int bestIndex = -1;
+        for (size_t i = 0; i < hand.size() && chosen; ++i) {
+            const Card& card = hand[i];
+            if (card.suit < kNumSuits && card.rank < kNumRanks && cardBit(card.suit, card.rank) == chosen) {
+                bestIndex = static_cast<int>(i);
+                break;
             }
         }
 
@@ -106,16 +96,52 @@ public:
         return "MySmartStrategy";
     }
 
+    // Parameter vector of the tuning interface, in the order of kParameters
+    void setParameters(const double* values, uint64_t count) {
+        if (count >= 4) {
+            heuristic.rankWeight = values[0];
+            heuristic.chainBonus = values[1];
+            heuristic.exposePenalty = values[2];
+            bluffPass = values[3];
+        }
+    }
+
 private:
+    static constexpr size_t kBluffMinCards = 5;
+
+    // Poids de l'heuristique : rang 1, bonus de suite 5, malus d'exposition 2 (voir kParameters)
+    policy::Neighbour heuristic;
+    double bluffPass = 0;
+
     uint64_t myID;
     std::mt19937 rng;
+    bool seeded = false; // rng réinitialisé au premier tour de chaque partie
 };
 
 
+// Poids réglables par "./sevens_game tune" (valeur initiale = comportement par défaut)
+constexpr StrategyParameter kParameters[] = {
+    {"rankWeight", 1.0, -2.0, 4.0},
+    {"chainBonus", 5.0, 0.0, 12.0},
+    {"exposePenalty", 2.0, 0.0, 8.0},
+    {"bluffPass", 0.0, 0.0, 0.9}, // < 1 : un bluff systématique pourrait bloquer la manche
+};
+
 #ifdef BUILD_SHARED_LIB
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::MySmartStrategy();
 }
+
+extern "C" uint64_t strategyParameters(const sevens::StrategyParameter** out) {
+    *out = kParameters;
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+extern "C" void setStrategyParameters(sevens::PlayerStrategy* strategy, const double* values, uint64_t count) {
+    if (auto* smart = dynamic_cast<sevens::MySmartStrategy*>(strategy)) {
+        smart->setParameters(values, count);
+    }
+}
 #endif
 
 } // namespace sevens
@@ -0,0 +1,370 @@
+#pragma once
+
+#include "Features.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEVENS_NEURAL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sevens {
+
+/**
+ * Small quantized multilayer perceptron over the input columns of a features row
+ * (see Features.hpp): scores of the 52 cards and of the pass, for NeuralStrategy.
+ *
+ *   FileHeader, then for every layer: LayerHeader, int8 weights[outputs][inputs] (row-major),
+ *   int32 bias[outputs], float32 multiplier[outputs]. Little-endian, no padding.
+ *
+ * Activations are uint8 in 0..127; the first layer reads the row itself (features::kInputs
+ * columns, larger values clamped to 127). A hidden layer computes
+ *   out[o] = clamp(round((bias[o] + sum_i in[i] * weights[o][i]) * multiplier[o]), 0, 127)
+ * (a ReLU folded into the requantization) and the last one, with kOutputs outputs, the float
+ * scores (bias[o] + sum_i in[i] * weights[o][i]) * multiplier[o]. Training exports write the
+ * multiplier as scale(in) * scale(weights of o) / scale(out).
+ *
+ * Keeping activations below 128 lets the SIMD kernels multiply with pmaddubsw, whose pairwise
+ * int16 sums cannot saturate then (2 * 127 * 128 < 32768). AVX2 and SSSE3 kernels are picked at
+ * run time, with a scalar fallback; the three give the same results to the bit.
+ *
+ * NeuralStrategy.so is built from NeuralStrategy.cpp alone: the loader and the kernels live here.
+ */
+namespace neural {
+
+constexpr uint32_t kMagic = 0x314E4E53; // "SNN1"
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kMaxLayers = 8;
+constexpr uint64_t kMaxWidth = 512;
+constexpr uint64_t kOutputs = features::kCards + 1; // les 52 cartes, puis la passe
+constexpr int32_t kActivationMax = 127;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layers;
+    uint32_t reserved;
+};
+
+struct LayerHeader {
+    uint32_t inputs;
+    uint32_t outputs;
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(LayerHeader) == 8, "on-disk layout");
+
+/**
+ * One dense layer in memory: rows padded with zeros to a multiple of 32 inputs (one AVX2 load)
+ * and their count to a multiple of 4 (the kernels reduce 4 rows at a time).
+ */
+struct Layer {
+    uint64_t inputs = 0;
+    uint64_t outputs = 0;
+    uint64_t stride = 0; // inputs arrondi à 32
+    uint64_t rows = 0;   // outputs arrondi à 4
+    std::vector<int8_t> weights;
+    std::vector<int32_t> bias;
+    std::vector<float> multiplier;
+};
+
+// Zero layer of `inputs` x `outputs`, storage padded as above
+inline Layer makeLayer(uint64_t inputs, uint64_t outputs) {
+    Layer layer;
+    layer.inputs = inputs;
+    layer.outputs = outputs;
+    layer.stride = (inputs + 31) / 32 * 32;
+    layer.rows = (outputs + 3) / 4 * 4;
+    layer.weights.assign(layer.rows * layer.stride, 0);
+    layer.bias.assign(layer.rows, 0);
+    layer.multiplier.assign(layer.rows, 0.0f);
+    return layer;
+}
+
+// sums[o] = sum_i in[i] * weights[o][i] for the `rows` rows of the layer; `in` holds `stride` values
+using DotKernel = void (*)(const uint8_t* in, const Layer& layer, int32_t* sums);
+
+inline void dotScalar(const uint8_t* in, const Layer& layer, int32_t* sums) {
+    for (uint64_t o = 0; o < layer.rows; ++o) {
+        const int8_t* w = layer.weights.data() + o * layer.stride;
+        int32_t sum = 0;
+        for (uint64_t i = 0; i < layer.stride; ++i) {
+            sum += static_cast<int32_t>(in[i]) * w[i];
+        }
+        sums[o] = sum;
+    }
+}
+
+#ifdef SEVENS_NEURAL_X86
+
+// Chaque int32 du résultat : somme de 4 produits u8 x i8 adjacents
+__attribute__((target("ssse3"))) inline __m128i dot4Ssse3(__m128i x, const int8_t* w) {
+    return _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(w))),
+                          _mm_set1_epi16(1));
+}
+
+__attribute__((target("ssse3"))) inline void dotSsse3(const uint8_t* in, const Layer& layer, int32_t* sums) {
+    for (uint64_t o = 0; o < layer.rows; o += 4) {
+        const int8_t* w = layer.weights.data() + o * layer.stride;
+        __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+        for (uint64_t i = 0; i < layer.stride; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            s0 = _mm_add_epi32(s0, dot4Ssse3(x, w + i));
+            s1 = _mm_add_epi32(s1, dot4Ssse3(x, w + layer.stride + i));
+            s2 = _mm_add_epi32(s2, dot4Ssse3(x, w + 2 * layer.stride + i));
+            s3 = _mm_add_epi32(s3, dot4Ssse3(x, w + 3 * layer.stride + i));
+        }
+        // Deux hadd : [somme s0, somme s1, somme s2, somme s3]
+        const __m128i s = _mm_hadd_epi32(_mm_hadd_epi32(s0, s1), _mm_hadd_epi32(s2, s3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + o), s);
+    }
+}
+
+__attribute__((target("avx2"))) inline __m256i dot4Avx2(__m256i x, const int8_t* w) {
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w))),
+                             _mm256_set1_epi16(1));
+}
+
+__attribute__((target("avx2"))) inline void dotAvx2(const uint8_t* in, const Layer& layer, int32_t* sums) {
+    for (uint64_t o = 0; o < layer.rows; o += 4) {
+        const int8_t* w = layer.weights.data() + o * layer.stride;
+        __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+        for (uint64_t i = 0; i < layer.stride; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            s0 = _mm256_add_epi32(s0, dot4Avx2(x, w + i));
+            s1 = _mm256_add_epi32(s1, dot4Avx2(x, w + layer.stride + i));
+            s2 = _mm256_add_epi32(s2, dot4Avx2(x, w + 2 * layer.stride + i));
+            s3 = _mm256_add_epi32(s3, dot4Avx2(x, w + 3 * layer.stride + i));
+        }
+        // hadd travaille par moitié de 128 bits : on additionne les deux moitiés à la fin
+        const __m256i s = _mm256_hadd_epi32(_mm256_hadd_epi32(s0, s1), _mm256_hadd_epi32(s2, s3));
+        const __m128i total = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + o), total);
+    }
+}
+
+#endif // SEVENS_NEURAL_X86
+
+enum class Kernel { Scalar, Ssse3, Avx2 };
+
+inline const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Ssse3: return "ssse3";
+        default: return "scalar";
+    }
+}
+
+inline bool kernelSupported(Kernel kernel) {
+#ifdef SEVENS_NEURAL_X86
+    static const bool ssse3 = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return kernel == Kernel::Scalar || (kernel == Kernel::Ssse3 && ssse3) || (kernel == Kernel::Avx2 && avx2);
+#else
+    return kernel == Kernel::Scalar;
+#endif
+}
+
+inline Kernel bestKernel() {
+    if (kernelSupported(Kernel::Avx2)) {
+        return Kernel::Avx2;
+    }
+    return kernelSupported(Kernel::Ssse3) ? Kernel::Ssse3 : Kernel::Scalar;
+}
+
+} // namespace neural
+
+/**
+ * Quantized network loaded from a file (format above) or built in memory, and written back by
+ * save(). Immutable once loaded, evaluate() keeps its activations on the stack: one instance can
+ * be shared by the strategies of every thread.
+ */
+class NeuralNetwork {
+public:
+    // @throws std::runtime_error if the layers do not describe a valid network (see the file format).
+    explicit NeuralNetwork(std::vector<neural::Layer> layers) : layers(std::move(layers)) {
+        if (this->layers.empty() || this->layers.size() > neural::kMaxLayers) {
+            throw std::runtime_error("[NeuralNetwork] A network has 1 to " + std::to_string(neural::kMaxLayers) + " layers.");
+        }
+        uint64_t inputs = features::kInputs;
+        for (uint64_t l = 0; l < this->layers.size(); ++l) {
+            const neural::Layer& layer = this->layers[l];
+            checkShape("layers", l, layer.inputs, layer.outputs, inputs, l + 1 == this->layers.size());
+            const neural::Layer padded = neural::makeLayer(layer.inputs, layer.outputs);
+            if (layer.stride != padded.stride || layer.rows != padded.rows || layer.weights.size() != padded.weights.size() ||
+                layer.bias.size() != padded.bias.size() || layer.multiplier.size() != padded.multiplier.size()) {
+                throw std::runtime_error("[NeuralNetwork] layers: layer " + std::to_string(l) +
+                                         " is not padded like makeLayer().");
+            }
+            checkMultipliers("layers", l, layer);
+            inputs = layer.outputs;
+        }
+        setKernel(neural::bestKernel());
+    }
+
+    // @throws std::runtime_error if the file cannot be read or does not describe a valid network.
+    explicit NeuralNetwork(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("[NeuralNetwork] Cannot open " + path);
+        }
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        uint64_t offset = 0;
+        const auto read = [&](void* out, uint64_t size) {
+            if (bytes.size() - offset < size) {
+                throw std::runtime_error("[NeuralNetwork] " + path + " is truncated.");
+            }
+            std::memcpy(out, bytes.data() + offset, size);
+            offset += size;
+        };
+
+        neural::FileHeader header{};
+        read(&header, sizeof(header));
+        if (header.magic != neural::kMagic || header.version != neural::kVersion || header.layers == 0 ||
+            header.layers > neural::kMaxLayers) {
+            throw std::runtime_error("[NeuralNetwork] " + path + " is not a network file.");
+        }
+        uint64_t inputs = features::kInputs;
+        for (uint32_t l = 0; l < header.layers; ++l) {
+            neural::LayerHeader shape{};
+            read(&shape, sizeof(shape));
+            checkShape(path, l, shape.inputs, shape.outputs, inputs, l + 1 == header.layers);
+            neural::Layer layer = neural::makeLayer(shape.inputs, shape.outputs);
+            for (uint64_t o = 0; o < layer.outputs; ++o) {
+                read(layer.weights.data() + o * layer.stride, layer.inputs);
+            }
+            read(layer.bias.data(), layer.outputs * sizeof(int32_t));
+            read(layer.multiplier.data(), layer.outputs * sizeof(float));
+            checkMultipliers(path, l, layer);
+            layers.push_back(std::move(layer));
+            inputs = shape.outputs;
+        }
+        if (offset != bytes.size()) {
+            throw std::runtime_error("[NeuralNetwork] " + path + " has trailing bytes after the last layer.");
+        }
+        setKernel(neural::bestKernel());
+    }
+
+    // Writes the network in the file format above, which the path constructor reads back.
+    // @throws std::runtime_error if the file cannot be written.
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const neural::FileHeader header{neural::kMagic, neural::kVersion, static_cast<uint32_t>(layers.size()), 0};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const neural::Layer& layer : layers) {
+            const neural::LayerHeader shape{static_cast<uint32_t>(layer.inputs), static_cast<uint32_t>(layer.outputs)};
+            out.write(reinterpret_cast<const char*>(&shape), sizeof(shape));
+            for (uint64_t o = 0; o < layer.outputs; ++o) { // sans le bourrage
+                out.write(reinterpret_cast<const char*>(layer.weights.data() + o * layer.stride),
+                          static_cast<std::streamsize>(layer.inputs));
+            }
+            out.write(reinterpret_cast<const char*>(layer.bias.data()),
+                      static_cast<std::streamsize>(layer.outputs * sizeof(int32_t)));
+            out.write(reinterpret_cast<const char*>(layer.multiplier.data()),
+                      static_cast<std::streamsize>(layer.outputs * sizeof(float)));
+        }
+        if (!out) {
+            throw std::runtime_error("[NeuralNetwork] Cannot write " + path);
+        }
+    }
+
+    // @throws std::runtime_error if the CPU lacks the instructions of `kernel`.
+    void setKernel(neural::Kernel kernel) {
+        if (!neural::kernelSupported(kernel)) {
+            throw std::runtime_error(std::string("[NeuralNetwork] This CPU cannot run the ") +
+                                     neural::kernelName(kernel) + " kernel.");
+        }
+        this->kernel = kernel;
+#ifdef SEVENS_NEURAL_X86
+        dot = kernel == neural::Kernel::Avx2    ? neural::dotAvx2
+              : kernel == neural::Kernel::Ssse3 ? neural::dotSsse3
+                                                : neural::dotScalar;
+#else
+        dot = neural::dotScalar;
+#endif
+    }
+
+    neural::Kernel getKernel() const { return kernel; }
+    const std::vector<neural::Layer>& getLayers() const { return layers; }
+
+    // Scores of the kOutputs moves for a features row (its first features::kInputs columns are read)
+    void evaluate(const uint8_t* row, float* scores) const {
+        alignas(32) uint8_t activations[2][neural::kMaxWidth];
+        alignas(32) int32_t sums[neural::kMaxWidth];
+        uint8_t* in = activations[0];
+        std::memset(in, 0, layers.front().stride);
+        for (uint64_t i = 0; i < features::kInputs; ++i) {
+            in[i] = row[i] < neural::kActivationMax ? row[i] : static_cast<uint8_t>(neural::kActivationMax);
+        }
+        for (uint64_t l = 0; l < layers.size(); ++l) {
+            const neural::Layer& layer = layers[l];
+            dot(in, layer, sums);
+            if (l + 1 == layers.size()) {
+                for (uint64_t o = 0; o < layer.outputs; ++o) {
+                    scores[o] = static_cast<float>(sums[o] + layer.bias[o]) * layer.multiplier[o];
+                }
+                return;
+            }
+            // Requantification en 0..127 ; les colonnes de bourrage de la couche suivante restent à 0
+            uint8_t* out = activations[(l + 1) % 2];
+            std::memset(out, 0, layers[l + 1].stride);
+            for (uint64_t o = 0; o < layer.outputs; ++o) {
+                const float value = static_cast<float>(sums[o] + layer.bias[o]) * layer.multiplier[o] + 0.5f;
+                out[o] = value <= 0.0f ? 0
+                         : value >= static_cast<float>(neural::kActivationMax)
+                             ? static_cast<uint8_t>(neural::kActivationMax)
+                             : static_cast<uint8_t>(value);
+            }
+            in = out;
+        }
+    }
+
+    // Best move allowed by the row: compact card index among its legal columns, or features::kPassLabel
+    // (the pass is always allowed). Ties go to the smallest index.
+    uint64_t bestMove(const uint8_t* row) const {
+        float scores[neural::kOutputs];
+        evaluate(row, scores);
+        uint64_t best = features::kPassLabel;
+        for (uint64_t card = 0; card < features::kCards; ++card) {
+            if (row[features::kLegal + card] && (best == features::kPassLabel ? scores[card] >= scores[best]
+                                                                               : scores[card] > scores[best])) {
+                best = card;
+            }
+        }
+        return best;
+    }
+
+private:
+    static void checkShape(const std::string& source, uint64_t l, uint64_t inputs, uint64_t outputs, uint64_t expected,
+                           bool last) {
+        if (inputs != expected || outputs == 0 || outputs > neural::kMaxWidth || (last && outputs != neural::kOutputs)) {
+            throw std::runtime_error("[NeuralNetwork] " + source + ": layer " + std::to_string(l) + " is " +
+                                     std::to_string(inputs) + " x " + std::to_string(outputs) + ", expected " +
+                                     std::to_string(expected) + " inputs" +
+                                     (last ? " and " + std::to_string(neural::kOutputs) + " outputs." : "."));
+        }
+    }
+
+    // Un multiplicateur NaN ou infini rendrait la conversion en uint8 de evaluate() indéfinie
+    static void checkMultipliers(const std::string& source, uint64_t l, const neural::Layer& layer) {
+        for (uint64_t o = 0; o < layer.outputs; ++o) {
+            if (!std::isfinite(layer.multiplier[o])) {
+                throw std::runtime_error("[NeuralNetwork] " + source + ": layer " + std::to_string(l) +
+                                         " has a non-finite multiplier for output " + std::to_string(o) + ".");
+            }
+        }
+    }
+
+    std::vector<neural::Layer> layers;
+    neural::Kernel kernel = neural::Kernel::Scalar;
+    neural::DotKernel dot = neural::dotScalar;
+};
+
+} // namespace sevens
@@ -0,0 +1,31 @@
+#include "NeuralStrategy.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace sevens {
+
+// Réseau partagé par toutes les instances : $SEVENS_NEURAL_WEIGHTS, sinon neural_strategy.bin du répertoire courant
+inline std::shared_ptr<const NeuralNetwork> sharedNeuralNetwork() {
+    static const std::shared_ptr<const NeuralNetwork> network = []() -> std::shared_ptr<const NeuralNetwork> {
+        const char* env = std::getenv("SEVENS_NEURAL_WEIGHTS");
+        const std::string path = env && *env ? env : "neural_strategy.bin";
+        try {
+            return std::make_shared<const NeuralNetwork>(path);
+        } catch (const std::exception& e) {
+            std::cerr << "[NeuralStrategy] " << e.what() << ", using the heuristic only.\n";
+            return nullptr;
+        }
+    }();
+    return network;
+}
+
+#ifdef BUILD_SHARED_LIB
+// Pas de strategyIsDeterministic : la décision dépend aussi des coups observés
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::NeuralStrategy(sharedNeuralNetwork());
+}
+#endif
+
+} // namespace sevens
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "Features.hpp"
+#include "HandAnalysis.hpp"
+#include "NeuralNet.hpp"
+#include "Simulator.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Plays the move a quantized network scores best (NeuralNet.hpp), among the legal ones. The network
+ * reads the features of the "dataset" export (Features.hpp), so it can be trained on self-play
+ * exports; the library loads it once per process (NeuralStrategy.cpp), and the strategy falls back
+ * to MySmartStrategy's heuristic without it.
+ *
+ * The public columns are rebuilt from the notifications: cards left and passes of the others,
+ * number of players (highest seat seen, or the size of the deal before anyone has moved), round
+ * and own penalty points. The engine does not announce rounds: a new one is detected when a
+ * card leaves the table or the hand grows, and the events seen since the last turn are replayed
+ * from the first of the moves that put the new table's cards (all but the 7s) down, with the
+ * passes from seat 0 (which opens every round) before it.
+ */
+class NeuralStrategy : public PlayerStrategy {
+public:
+    explicit NeuralStrategy(std::shared_ptr<const NeuralNetwork> network) : network(std::move(network)) {}
+
+    ~NeuralStrategy() override = default;
+
+    void initialize(uint64_t playerID) override {
+        myID = playerID;
+        seatsSeen = playerID + 1;
+        dealPlayers = 0;
+        round = 0;
+        points = 0;
+        cardsLeft = 0;
+        lastTable = 0;
+        started = false;
+        history = features::RoundHistory{};
+        events.clear();
+    }
+
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override
+    {
+        if (hand.empty()) {
+            return -1;
+        }
+        const uint64_t handBits = handMask(hand);
+        const uint64_t tableBits = tableMask(tableLayout);
+        trackRound(hand.size(), tableBits);
+        const uint64_t playableBits = playableMask(handBits, tableBits);
+        if (!playableBits) {
+            return -1;
+        }
+
+        uint64_t chosen = 0;
+        if (network) {
+            alignas(32) uint8_t row[features::kWidth];
+            const uint64_t players = std::max(seatsSeen, dealPlayers);
+            features::encode(handBits, tableBits, players, myID, round, points, history, row);
+            if (rows) {
+                rows->insert(rows->end(), row, row + features::kInputs);
+            }
+            const uint64_t move = network->bestMove(row);
+            if (move == features::kPassLabel) {
+                return -1;
+            }
+            chosen = 1ULL << features::cardOfCompact(move);
+        } else {
+            chosen = heuristic.pick(handBits, tableBits, playableBits);
+        }
+
+        for (size_t i = 0; i < hand.size(); ++i) {
+            const Card& card = hand[i];
+            if (card.suit < kNumSuits && card.rank < kNumRanks && cardBit(card.suit, card.rank) == chosen) {
+                --cardsLeft;
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        if (playerID >= kMaxPlayers || playedCard.suit >= kNumSuits || playedCard.rank >= kNumRanks) {
+            return;
+        }
+        seatsSeen = std::max(seatsSeen, playerID + 1);
+        history.record(playerID, false);
+        events.push_back({playerID, false, playedCard.rank != kStartRank});
+    }
+
+    void observePass(uint64_t playerID) override {
+        if (playerID >= kMaxPlayers) {
+            return;
+        }
+        seatsSeen = std::max(seatsSeen, playerID + 1);
+        history.record(playerID, true);
+        events.push_back({playerID, true, false});
+    }
+
+    std::string getName() const override {
+        return "NeuralStrategy";
+    }
+
+    // Appends the features::kInputs columns of every row given to the network to `sink` (nullptr: none),
+    // for the checks of "bench neural"
+    void recordRows(std::vector<uint8_t>* sink) {
+        rows = sink;
+    }
+
+private:
+    struct Event {
+        uint64_t player;
+        bool pass;
+        bool placed; // la carte s'est ajoutée à la table (les 7 joués y sont déjà)
+    };
+
+    // Nombre de joueurs qui donne `size` cartes au siège myID (0 si aucun)
+    uint64_t playersForDeal(uint64_t size) const {
+        for (uint64_t n = kMinPlayers; n <= kMaxPlayers; ++n) {
+            if (myID < n && features::kCards / n + (myID < features::kCards % n) == size) {
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    // Détecte un changement de manche et remet l'historique à zéro pour la nouvelle
+    void trackRound(uint64_t handSize, uint64_t tableBits) {
+        const bool newRound = !started || (lastTable & ~tableBits) || handSize > cardsLeft;
+        if (newRound) {
+            if (started) {
+                points += cardsLeft; // cartes restées en main à la fin de la manche précédente
+                ++round;
+            }
+            started = true;
+            if (const uint64_t guess = playersForDeal(handSize)) {
+                dealPlayers = guess;
+            }
+            const uint64_t players = std::max(seatsSeen, dealPlayers);
+            history = features::RoundHistory{};
+            for (uint64_t p = 0; p < players && p < kMaxPlayers; ++p) {
+                history.cards[p] = static_cast<uint8_t>(features::kCards / players + (p < features::kCards % players));
+            }
+            // Chaque carte de la table hors des 7 est un coup de la nouvelle manche : ce sont les derniers observés
+            uint64_t placed = cardCount(tableBits & ~kSevensMask);
+            size_t first = events.size();
+            while (first > 0 && placed > 0) {
+                placed -= events[--first].placed;
+            }
+            // Avant, seulement des passes : dans l'ordre du tour depuis le siège 0, qui ouvre la manche
+            uint64_t next = first < events.size() ? events[first].player : myID;
+            while (first > 0 && next > 0 && events[first - 1].pass && events[first - 1].player < next) {
+                next = events[--first].player;
+            }
+            for (size_t i = first; i < events.size(); ++i) {
+                history.record(events[i].player, events[i].pass);
+            }
+        }
+        events.clear();
+        cardsLeft = handSize;
+        lastTable = tableBits;
+    }
+
+    std::shared_ptr<const NeuralNetwork> network;
+    policy::Neighbour heuristic;
+    uint64_t myID = 0;
+    uint64_t seatsSeen = 1;   // plus grand siège observé + 1
+    uint64_t dealPlayers = 0; // déduit de la taille de notre donne
+    uint64_t round = 0;
+    uint64_t points = 0;
+    uint64_t cardsLeft = 0;   // taille de notre main après notre dernier coup
+    uint64_t lastTable = 0;
+    bool started = false;
+    features::RoundHistory history;
+    std::vector<Event> events; // coups et passes observés depuis notre dernier tour
+    std::vector<uint8_t>* rows = nullptr;
+};
+
+} // namespace sevens
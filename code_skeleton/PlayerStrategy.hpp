@@ -41,4 +41,32 @@ typedef PlayerStrategy* (*CreateStrategyFn)(); // une déclaration de type qui d
 // Pourquoi ? Cela permet de stocker des fonctions de création de stratégie dans des variables ou des conteneurs.
 // -> Très utile pour des usines (factories) de création de stratégies, ou pour sélectionner dynamiquement des stratégies.
 
+/**
+ * Optional tuning interface of a strategy library ("tune" mode of sevens_game).
+ * A library exposing its weights exports both functions:
+ *
+ *   extern "C" uint64_t strategyParameters(const sevens::StrategyParameter** out);
+ *       number of parameters, *out = their descriptions (static storage)
+ *   extern "C" void setStrategyParameters(sevens::PlayerStrategy* strategy, const double* values, uint64_t count);
+ *       applies a parameter vector to a strategy created by this library
+ */
+struct StrategyParameter {
+    const char* name;
+    double initial;
+    double min;
+    double max;
+};
+
+typedef uint64_t (*StrategyParametersFn)(const StrategyParameter** out);
+typedef void (*SetStrategyParametersFn)(PlayerStrategy* strategy, const double* values, uint64_t count);
+
+/**
+ * Optional: a library whose selectCardToPlay depends only on the hand and the table exports
+ *
+ *   extern "C" uint64_t strategyIsDeterministic();   // non-zero: decisions may be cached
+ *
+ * and the engine answers repeated questions from a DecisionCache instead of calling it.
+ */
+typedef uint64_t (*StrategyIsDeterministicFn)();
+
 } // namespace sevens
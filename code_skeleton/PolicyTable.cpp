@@ -0,0 +1,285 @@
+#include "PolicyTable.hpp"
+#include "CommandLine.hpp"
+#include "Simulator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+namespace {
+
+struct BuildOptions {
+    std::string path;
+    uint64_t players = 4;
+    uint64_t games = 5000;
+    uint64_t rollouts = 8;
+    uint64_t minVisits = 1;
+    uint64_t seed = 2024;
+};
+
+struct KeyHash {
+    size_t operator()(const std::pair<uint64_t, uint64_t>& key) const {
+        return static_cast<size_t>(splitMix64(key.first * 0x9E3779B97F4A7C15ULL ^ key.second));
+    }
+};
+
+// Statistiques d'un état canonique : au plus 3 cartes jouables par couleur
+// (les deux voisins de la rangée, plus le 7 tenu en main une fois son 6 ou son 8 posé)
+struct StateStats {
+    uint32_t visits = 0;
+    uint8_t moves = 0;
+    std::array<uint8_t, kNumSuits * 3> card{};
+    std::array<uint32_t, kNumSuits * 3> samples{};
+    std::array<uint32_t, kNumSuits * 3> penalty{};
+
+    void add(uint64_t move, uint64_t points) {
+        uint64_t m = 0;
+        while (m < moves && card[m] != move) {
+            ++m;
+        }
+        if (m == moves) {
+            card[moves++] = static_cast<uint8_t>(move);
+        }
+        ++samples[m];
+        penalty[m] += static_cast<uint32_t>(points);
+    }
+};
+
+using StatsMap = std::unordered_map<std::pair<uint64_t, uint64_t>, StateStats, KeyHash>;
+
+template <size_t, class T>
+using Repeat = T;
+
+/**
+ * Self-play rounds, every seat playing policy::Neighbour. At each decision with a choice,
+ * every legal card is scored by `rollouts` playouts of the rest of the round (same policy,
+ * real hidden hands); the samples of all occurrences of a canonical state add up.
+ */
+template <size_t... I>
+void selfPlay(const BuildOptions& options, StatsMap& stats, std::index_sequence<I...>) {
+    const Simulator<Repeat<I, policy::Neighbour>...> simulator{};
+    const policy::Neighbour play;
+    for (uint64_t g = 0; g < options.games; ++g) {
+        Xoshiro256 rng(gameSeed(options.seed, g));
+        GameState state;
+        state.reset(options.players);
+        state.deal(kFullDeck, rng);
+        uint64_t idleTurns = 0; // manche bloquée : arrêtée comme dans Engine
+        while (!state.isTerminal() && idleTurns < kDefaultStallLimit) {
+            const uint64_t mover = state.current;
+            const uint64_t playable = state.legalMoves();
+            if (cardCount(playable) >= 2) {
+                const policytable::CanonicalKey key = policytable::canonicalize(state.hands[mover], state.table);
+                StateStats& node = stats[{key.hand, key.table}];
+                ++node.visits;
+                for (uint64_t rest = playable; rest; rest &= rest - 1) {
+                    const uint64_t card = lowestCard(rest);
+                    for (uint64_t r = 0; r < options.rollouts; ++r) {
+                        GameState playout = state;
+                        playout.apply(Move::play(mover, card));
+                        simulator.rollout(playout, rng);
+                        node.add(key.toCanonical(card), cardCount(playout.hands[mover]));
+                    }
+                }
+            }
+            const uint64_t chosen = play(state, playable, rng);
+            state.apply(chosen ? Move::play(mover, lowestCard(chosen)) : Move::pass(mover));
+            idleTurns = chosen ? 0 : idleTurns + 1;
+        }
+    }
+}
+
+void writeTable(const BuildOptions& options, const StatsMap& stats) {
+    uint64_t entries = 0;
+    for (const auto& [key, node] : stats) {
+        entries += node.visits >= options.minVisits;
+    }
+    uint64_t buckets = 16;
+    while (buckets < 2 * entries) {
+        buckets *= 2; // facteur de charge <= 1/2 : sondages courts
+    }
+
+    std::vector<policytable::Entry> slots(buckets);
+    std::memset(slots.data(), 0, slots.size() * sizeof(policytable::Entry));
+    for (const auto& [key, node] : stats) {
+        if (node.visits < options.minVisits) {
+            continue;
+        }
+        uint64_t best = 0;
+        for (uint64_t m = 1; m < node.moves; ++m) {
+            if (static_cast<uint64_t>(node.penalty[m]) * node.samples[best] <
+                static_cast<uint64_t>(node.penalty[best]) * node.samples[m]) {
+                best = m;
+            }
+        }
+        uint64_t slot = policytable::bucketOf(key.first, key.second, buckets);
+        while (slots[slot].table != 0) {
+            slot = (slot + 1) & (buckets - 1);
+        }
+        policytable::Entry& entry = slots[slot];
+        entry.hand = key.first;
+        entry.table = key.second;
+        entry.value = static_cast<float>(node.penalty[best]) / static_cast<float>(node.samples[best]);
+        entry.visits = static_cast<uint16_t>(std::min<uint32_t>(node.visits, 0xFFFF));
+        entry.move = node.card[best];
+    }
+
+    policytable::FileHeader header{};
+    header.magic = policytable::kMagic;
+    header.version = policytable::kVersion;
+    header.buckets = buckets;
+    header.entries = entries;
+    header.players = static_cast<uint8_t>(options.players);
+
+    std::ofstream out(options.path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(policytable::Entry)));
+    if (!out) {
+        throw std::runtime_error("[PolicyTable] Cannot write " + options.path);
+    }
+}
+
+int buildMode(const BuildOptions& options) {
+    std::cout << "[policytable] Building " << options.path << ": " << options.games << " self-play rounds, "
+              << options.players << " players, " << options.rollouts << " rollouts per legal card\n";
+    const auto start = std::chrono::steady_clock::now();
+    StatsMap stats;
+    switch (options.players) {
+        case 3: selfPlay(options, stats, std::make_index_sequence<3>{}); break;
+        case 4: selfPlay(options, stats, std::make_index_sequence<4>{}); break;
+        case 5: selfPlay(options, stats, std::make_index_sequence<5>{}); break;
+        case 6: selfPlay(options, stats, std::make_index_sequence<6>{}); break;
+        case 7: selfPlay(options, stats, std::make_index_sequence<7>{}); break;
+        default:
+            std::cerr << "[policytable] Number of players must be between 3 and 7.\n";
+            return 1;
+    }
+    writeTable(options, stats);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[policytable] " << stats.size() << " canonical states seen, written in " << std::fixed
+              << std::setprecision(1) << seconds << " s\n";
+    return 0;
+}
+
+// Table statistics, then hit rate on fresh self-play rounds (seeds not used by the build)
+int infoMode(const std::string& path, uint64_t games) {
+    auto start = std::chrono::steady_clock::now();
+    const PolicyTable table(path);
+    const double openMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[policytable] " << path << ": " << table.getEntries() << " states in " << table.getBuckets()
+              << " buckets (" << table.getPlayers() << " players), opened in " << std::fixed << std::setprecision(1)
+              << openMicros << " us\n";
+
+    const policy::Neighbour play;
+    uint64_t decisions = 0, hits = 0, lateDecisions = 0, lateHits = 0, agree = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> probes;
+    for (uint64_t g = 0; g < games; ++g) {
+        Xoshiro256 rng(gameSeed(~0ULL, g));
+        GameState state;
+        state.reset(table.getPlayers());
+        state.deal(kFullDeck, rng);
+        uint64_t idleTurns = 0;
+        while (!state.isTerminal() && idleTurns < kDefaultStallLimit) {
+            const uint64_t mover = state.current;
+            const uint64_t playable = state.legalMoves();
+            const uint64_t chosen = play(state, playable, rng);
+            if (cardCount(playable) >= 2) {
+                const int64_t advised = table.lookup(state.hands[mover], state.table);
+                const bool late = cardCount(state.hands[mover]) <= 3;
+                probes.emplace_back(state.hands[mover], state.table);
+                ++decisions;
+                lateDecisions += late;
+                if (advised >= 0) {
+                    ++hits;
+                    lateHits += late;
+                    agree += (1ULL << advised) == chosen;
+                }
+            }
+            state.apply(chosen ? Move::play(mover, lowestCard(chosen)) : Move::pass(mover));
+            idleTurns = chosen ? 0 : idleTurns + 1;
+        }
+    }
+
+    // Débit des sondes seules : un premier passage charge les pages touchées, le second est mesuré
+    int64_t checksum = 0;
+    double lookupSeconds = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        start = std::chrono::steady_clock::now();
+        for (const auto& [hand, tableBits] : probes) {
+            checksum += table.lookup(hand, tableBits);
+        }
+        lookupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    auto percent = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+    std::cout << "[policytable] " << games << " fresh rounds: " << std::setprecision(1) << percent(hits, decisions)
+              << "% of decisions found (" << percent(lateHits, lateDecisions) << "% with 3 cards or less), "
+              << percent(agree, hits) << "% of hits agree with the Neighbour heuristic\n";
+    std::cout << "[policytable] " << probes.size() << " warm lookups, " << std::setprecision(0)
+              << lookupSeconds / std::max<size_t>(1, probes.size()) * 1e9 << " ns each (checksum " << checksum % 1000 << ")\n";
+    return 0;
+}
+
+} // namespace
+
+int runPolicyTableMode(int argc, char* argv[]) {
+    const std::string usage = "[main] Usage: ./sevens_game policytable build <file> [--players P] [--games N] [--rollouts K] "
+                              "[--min-visits V] [--seed S]\n"
+                              "       ./sevens_game policytable info <file> [--games N]\n";
+    if (argc < 4) {
+        std::cerr << usage;
+        return 1;
+    }
+    const std::string action = argv[2];
+    BuildOptions options;
+    options.path = argv[3];
+    uint64_t infoGames = 2000;
+    for (int i = 4; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "[policytable] Missing value for " << arg << "\n";
+            return 1;
+        }
+        uint64_t value = 0;
+        if (!cli::parseCount("[policytable]", arg, argv[++i], value)) {
+            return 1;
+        }
+        if (arg == "--players") {
+            options.players = value;
+        } else if (arg == "--games") {
+            options.games = value;
+            infoGames = value;
+        } else if (arg == "--rollouts") {
+            options.rollouts = std::max<uint64_t>(1, value);
+        } else if (arg == "--min-visits") {
+            options.minVisits = value;
+        } else if (arg == "--seed") {
+            options.seed = value;
+        } else {
+            std::cerr << "[policytable] Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    try {
+        if (action == "build") {
+            return buildMode(options);
+        }
+        if (action == "info") {
+            return infoMode(options.path, infoGames);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << usage;
+    return 1;
+}
+
+} // namespace sevens
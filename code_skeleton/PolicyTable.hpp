@@ -0,0 +1,218 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sevens {
+
+/**
+ * Precomputed policy table: canonical (hand, table) of the player to move -> best card and its value.
+ *
+ *   FileHeader, then `buckets` Entry slots (a power of two), open addressing with linear probing.
+ *   An empty slot has table == 0 (the opening 7s are always on the table).
+ *
+ * Suits play symmetric roles, so a state and its 24 suit permutations share one entry:
+ * the key lists the suits sorted by (table lane, hand lane), see canonicalize().
+ *
+ * The reader is this header alone, so that TableStrategy.so can map tables; the builder is in
+ * PolicyTable.cpp.
+ */
+namespace policytable {
+
+constexpr uint32_t kMagic = 0x31545053; // "SPT1"
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t buckets;
+    uint64_t entries;
+    uint8_t players;   // nombre de joueurs des parties de self-play
+    uint8_t reserved[39];
+};
+
+struct Entry {
+    uint64_t hand;     // clé canonique
+    uint64_t table;
+    float value;       // pénalité moyenne de la manche pour le joueur après ce coup (plus bas = mieux)
+    uint16_t visits;   // fois où l'état a été rencontré pendant la construction (saturé)
+    uint8_t move;      // carte conseillée, en indices canoniques
+    uint8_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(Entry) == 24, "policy table layout must not change");
+
+/**
+ * Canonical form of a (hand, table) pair under suit permutation.
+ * suitOf[lane] = original suit of canonical lane `lane`.
+ */
+struct CanonicalKey {
+    uint64_t hand = 0;
+    uint64_t table = 0;
+    std::array<uint8_t, kNumSuits> suitOf{};
+
+    uint64_t toCanonical(uint64_t card) const {
+        for (uint64_t lane = 0; lane < kNumSuits; ++lane) {
+            if (suitOf[lane] == card / kSuitStride) {
+                return lane * kSuitStride + card % kSuitStride;
+            }
+        }
+        return card;
+    }
+
+    uint64_t fromCanonical(uint64_t card) const { return suitOf[card / kSuitStride] * kSuitStride + card % kSuitStride; }
+};
+
+inline CanonicalKey canonicalize(uint64_t hand, uint64_t table) {
+    std::array<uint64_t, kNumSuits> lanes{};
+    for (uint64_t suit = 0; suit < kNumSuits; ++suit) {
+        const uint64_t shift = suit * kSuitStride;
+        // Tri décroissant sur (table, main) ; la couleur d'origine dans les bits bas départage les égalités
+        lanes[suit] = ((table >> shift & kSuitMask) << 36) | ((hand >> shift & kSuitMask) << 8) | suit;
+    }
+    // Tri par insertion : 4 éléments
+    for (uint64_t i = 1; i < kNumSuits; ++i) {
+        for (uint64_t j = i; j > 0 && lanes[j] > lanes[j - 1]; --j) {
+            std::swap(lanes[j], lanes[j - 1]);
+        }
+    }
+    CanonicalKey key;
+    for (uint64_t lane = 0; lane < kNumSuits; ++lane) {
+        key.suitOf[lane] = static_cast<uint8_t>(lanes[lane] & 0xFF);
+        key.hand |= (lanes[lane] >> 8 & kSuitMask) << (lane * kSuitStride);
+        key.table |= (lanes[lane] >> 36 & kSuitMask) << (lane * kSuitStride);
+    }
+    return key;
+}
+
+inline uint64_t bucketOf(uint64_t hand, uint64_t table, uint64_t buckets) {
+    return splitMix64(hand * 0x9E3779B97F4A7C15ULL ^ table) & (buckets - 1);
+}
+
+} // namespace policytable
+
+/**
+ * Read-only view of a policy table file, memory-mapped: opening costs one mmap,
+ * pages are loaded on first lookup. One instance can be shared by many strategies.
+ */
+class PolicyTable {
+public:
+    // @throws std::runtime_error if the file cannot be mapped or is not a policy table.
+    explicit PolicyTable(const std::string& path) {
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info{};
+        if (fd < 0 || fstat(fd, &info) < 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::runtime_error("[PolicyTable] Cannot open " + path);
+        }
+        size = static_cast<uint64_t>(info.st_size);
+        if (size >= sizeof(policytable::FileHeader)) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("[PolicyTable] mmap failed on " + path);
+            }
+            madvise(mapped, size, MADV_RANDOM); // accès aléatoires : pas de lecture anticipée
+            data = static_cast<const uint8_t*>(mapped);
+        }
+        close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("[PolicyTable] Cannot open " + path);
+        }
+        copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = copy.data();
+        size = copy.size();
+#endif
+        if (!data || size < sizeof(policytable::FileHeader)) {
+            unmap();
+            throw std::runtime_error("[PolicyTable] " + path + " is too short to be a policy table.");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        const bool powerOfTwo = header.buckets && !(header.buckets & (header.buckets - 1));
+        if (header.magic != policytable::kMagic || header.version != policytable::kVersion || !powerOfTwo ||
+            header.entries >= header.buckets || // au moins un slot vide termine chaque sondage
+            size != sizeof(header) + header.buckets * sizeof(policytable::Entry)) {
+            unmap();
+            throw std::runtime_error("[PolicyTable] " + path + " is not a valid policy table.");
+        }
+        slots = reinterpret_cast<const policytable::Entry*>(data + sizeof(header));
+    }
+
+    ~PolicyTable() { unmap(); }
+    PolicyTable(const PolicyTable&) = delete;
+    PolicyTable& operator=(const PolicyTable&) = delete;
+
+    /**
+     * Advised card (GameState index) for the player holding `hand` with `table` down, or -1 if the
+     * state is not in the table or its advice is not a card of the hand (corrupt file).
+     * `value` receives the expected round penalty of that move. At most `buckets` slots are
+     * probed, so a file without an empty slot cannot hang the caller.
+     */
+    int64_t lookup(uint64_t hand, uint64_t table, float* value = nullptr) const {
+        const policytable::CanonicalKey key = policytable::canonicalize(hand, table);
+        const uint64_t mask = header.buckets - 1;
+        uint64_t slot = policytable::bucketOf(key.hand, key.table, header.buckets);
+        for (uint64_t probe = 0; probe < header.buckets; ++probe, slot = (slot + 1) & mask) {
+            const policytable::Entry& entry = slots[slot];
+            if (entry.table == 0) {
+                return -1;
+            }
+            if (entry.hand == key.hand && entry.table == key.table) {
+                if (entry.move >= 64 || !((key.hand >> entry.move) & 1ULL)) {
+                    return -1;
+                }
+                if (value) {
+                    *value = entry.value;
+                }
+                return static_cast<int64_t>(key.fromCanonical(entry.move));
+            }
+        }
+        return -1;
+    }
+
+    uint64_t getEntries() const { return header.entries; }
+    uint64_t getBuckets() const { return header.buckets; }
+    uint64_t getPlayers() const { return header.players; }
+
+private:
+    void unmap() {
+#ifndef _WIN32
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), size);
+            data = nullptr;
+        }
+#endif
+    }
+
+    policytable::FileHeader header{};
+    const uint8_t* data = nullptr;
+    const policytable::Entry* slots = nullptr;
+    uint64_t size = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> copy;
+#endif
+};
+
+// Entry point of "./sevens_game policytable build|info ..."
+int runPolicyTableMode(int argc, char* argv[]);
+
+} // namespace sevens
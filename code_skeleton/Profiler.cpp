@@ -0,0 +1,384 @@
+#include "Profiler.hpp"
+#include "StrategyLoader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define SEVENS_PROFILER_SUPPORTED 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+namespace sevens {
+
+namespace {
+
+std::atomic<SamplingProfiler*> activeProfiler{nullptr};
+std::atomic<uint64_t> sampledNanos{0}; // temps CPU des threads échantillonnés, à leur sortie
+
+std::string hexOffset(uintptr_t offset) {
+    std::ostringstream out;
+    out << "0x" << std::hex << offset;
+    return out.str();
+}
+
+#ifdef SEVENS_PROFILER_SUPPORTED
+
+std::string fileName(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+struct StackBounds {
+    uintptr_t low;
+    uintptr_t high; // 0 : thread non échantillonné
+};
+
+// Type trivial initialisé à la compilation : lisible depuis le handler sans initialisation paresseuse
+thread_local StackBounds threadStack = {0, 0};
+
+std::mutex threadsMutex; // protège timers et nextThreadId
+std::unordered_map<int64_t, std::pair<timer_t, uint64_t>> timers; // timer, temps CPU du thread au départ
+int64_t nextThreadId = 0;
+struct sigaction previousAction;
+
+uint64_t threadCpuNanos() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+void onSigprof(int, siginfo_t*, void* context) {
+    SamplingProfiler* profiler = activeProfiler.load(std::memory_order_acquire);
+    const StackBounds stack = threadStack;
+    if (!profiler || !stack.high) {
+        return;
+    }
+    const int savedErrno = errno;
+    const mcontext_t& registers = static_cast<ucontext_t*>(context)->uc_mcontext;
+#if defined(__x86_64__)
+    const uintptr_t pc = static_cast<uintptr_t>(registers.gregs[REG_RIP]);
+    uintptr_t fp = static_cast<uintptr_t>(registers.gregs[REG_RBP]);
+    uintptr_t low = static_cast<uintptr_t>(registers.gregs[REG_RSP]);
+#else
+    const uintptr_t pc = static_cast<uintptr_t>(registers.pc);
+    uintptr_t fp = static_cast<uintptr_t>(registers.regs[29]);
+    uintptr_t low = static_cast<uintptr_t>(registers.sp);
+#endif
+    uintptr_t pcs[SamplingProfiler::kMaxDepth];
+    uint32_t depth = 0;
+    pcs[depth++] = pc;
+    // Chaîne des frame pointers : fp[0] = fp de l'appelant, fp[1] = adresse de retour.
+    // Sans frame pointer, fp est un registre quelconque : on ne lit que dans la pile du thread,
+    // au-dessus du sommet courant et en remontant strictement, donc jamais hors de la mémoire mappée
+    low = std::max(low, stack.low);
+    while (depth < SamplingProfiler::kMaxDepth && fp >= low && fp <= stack.high - 2 * sizeof(uintptr_t) &&
+           fp % sizeof(uintptr_t) == 0) {
+        const uintptr_t* frame = reinterpret_cast<const uintptr_t*>(fp);
+        if (!frame[1]) {
+            break;
+        }
+        pcs[depth++] = frame[1];
+        low = fp + 2 * sizeof(uintptr_t);
+        fp = frame[0];
+    }
+    profiler->record(pcs, depth);
+    errno = savedErrno;
+}
+
+std::string demangle(const char* symbol) {
+    int status = 0;
+    char* readable = abi::__cxa_demangle(symbol, nullptr, nullptr, &status);
+    std::string name = status == 0 && readable ? readable : symbol;
+    std::free(readable);
+    // ';' sépare les frames du format replié
+    std::replace(name.begin(), name.end(), ';', ':');
+    return name;
+}
+
+#endif // SEVENS_PROFILER_SUPPORTED
+
+} // namespace
+
+SamplingProfiler::SamplingProfiler(uint64_t hz) : hz(hz), slots(new Slot[kSlots]) {
+#ifdef SEVENS_PROFILER_SUPPORTED
+    if (hz == 0 || hz > 10000) {
+        throw std::runtime_error("[Profiler] The sampling rate must be between 1 and 10000 Hz.");
+    }
+    SamplingProfiler* none = nullptr;
+    if (!activeProfiler.compare_exchange_strong(none, this)) {
+        throw std::runtime_error("[Profiler] Another profiler is already running.");
+    }
+    sampledNanos = 0;
+    struct sigaction action {};
+    action.sa_sigaction = onSigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+        activeProfiler.store(nullptr);
+        throw std::runtime_error(std::string("[Profiler] Cannot install the SIGPROF handler: ") + std::strerror(errno));
+    }
+    thread = std::thread([this]() { run(); });
+#else
+    throw std::runtime_error("[Profiler] Sampling is only available on Linux (x86-64 and AArch64).");
+#endif
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+void SamplingProfiler::stop() {
+    if (stopped || !thread.joinable()) {
+        return;
+    }
+    stopped = true;
+#ifdef SEVENS_PROFILER_SUPPORTED
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto& entry : timers) {
+            timer_delete(entry.second.first);
+        }
+        timers.clear();
+        activeProfiler.store(nullptr, std::memory_order_release);
+    }
+    // SIG_IGN écarte un SIGPROF encore en attente, que l'action par défaut transformerait en arrêt du processus
+    struct sigaction ignore {};
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGPROF, &ignore, nullptr);
+    sigaction(SIGPROF, &previousAction, nullptr);
+#endif
+    stopping = true;
+    thread.join();
+    drain();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void SamplingProfiler::record(const uintptr_t* pcs, uint32_t depth) {
+    Slot& slot = slots[cursor.fetch_add(1, std::memory_order_relaxed) % kSlots];
+    uint32_t free = 0;
+    if (!slot.state.compare_exchange_strong(free, 1, std::memory_order_acquire)) {
+        dropped.fetch_add(1, std::memory_order_relaxed); // anneau plein : le vidage a pris du retard
+        return;
+    }
+    slot.depth = depth;
+    for (uint32_t i = 0; i < depth; ++i) {
+        slot.pcs[i] = pcs[i];
+    }
+    slot.state.store(2, std::memory_order_release);
+}
+
+void SamplingProfiler::run() {
+    while (!stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        drain();
+    }
+}
+
+void SamplingProfiler::drain() {
+    std::vector<uint32_t> stack;
+    for (uint64_t i = 0; i < kSlots; ++i) {
+        Slot& slot = slots[i];
+        if (slot.state.load(std::memory_order_acquire) != 2) {
+            continue;
+        }
+        uintptr_t pcs[kMaxDepth];
+        const uint32_t depth = std::min(slot.depth, kMaxDepth);
+        std::copy(slot.pcs, slot.pcs + depth, pcs);
+        slot.state.store(0, std::memory_order_release);
+
+        // Racine d'abord ; une adresse de retour pointe après l'appel, -1 la ramène dans l'appelant
+        stack.clear();
+        for (uint32_t d = depth; d-- > 0;) {
+            stack.push_back(frameAt(d == 0 ? pcs[0] : pcs[d] - 1));
+        }
+        ++stacks[stack];
+        ++samples;
+    }
+}
+
+uint32_t SamplingProfiler::frameAt(uintptr_t pc) {
+    const auto cached = addressIds.find(pc);
+    if (cached != addressIds.end()) {
+        return cached->second;
+    }
+    Frame frame;
+    frame.library = "[unknown]";
+    frame.function = hexOffset(pc);
+#ifdef SEVENS_PROFILER_SUPPORTED
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(pc), &info) && info.dli_fname) {
+        frame.library = StrategyLibrary::pathAt(reinterpret_cast<void*>(pc));
+        frame.strategy = !frame.library.empty();
+        if (!frame.strategy) {
+            frame.library = info.dli_fname[0] ? fileName(info.dli_fname) : "[unknown]";
+        }
+        frame.function = info.dli_sname ? demangle(info.dli_sname)
+                                        : hexOffset(pc - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    }
+#endif
+    const std::string key = frame.library + "`" + frame.function;
+    auto [entry, added] = frameIds.emplace(key, static_cast<uint32_t>(frames.size()));
+    if (added) {
+        frames.push_back(std::move(frame));
+    }
+    addressIds.emplace(pc, entry->second);
+    return entry->second;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void SamplingProfiler::writeFolded(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto& [stack, count] : stacks) {
+        for (size_t i = 0; i < stack.size(); ++i) {
+            const Frame& frame = frames[stack[i]];
+            file << (i ? ";" : "") << frame.library << '`' << frame.function;
+        }
+        file << ' ' << count << '\n';
+    }
+    if (!file) {
+        throw std::runtime_error("[Profiler] Cannot write " + path);
+    }
+}
+
+void SamplingProfiler::printSummary() const {
+    struct Share {
+        uint64_t self = 0;
+        uint64_t total = 0;
+        bool strategy = false;
+        std::map<std::string, uint64_t> functions; // temps propre par fonction
+    };
+    std::map<std::string, Share> libraries;
+    uint64_t strategySelf = 0;
+    std::set<std::string> seen;
+    for (const auto& [stack, count] : stacks) {
+        if (stack.empty()) {
+            continue;
+        }
+        const Frame& leaf = frames[stack.back()];
+        Share& own = libraries[leaf.library];
+        own.self += count;
+        own.strategy = leaf.strategy;
+        own.functions[leaf.function] += count;
+        strategySelf += leaf.strategy ? count : 0;
+        seen.clear();
+        for (uint32_t id : stack) {
+            if (seen.insert(frames[id].library).second) {
+                libraries[frames[id].library].total += count;
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, const Share*>> order;
+    for (const auto& [library, share] : libraries) {
+        order.emplace_back(library, &share);
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.second->self != b.second->self ? a.second->self > b.second->self : a.second->total > b.second->total;
+    });
+
+    const double all = samples ? static_cast<double>(samples) : 1.0;
+    // Les timers d'horloge CPU n'expirent qu'au tick du noyau : le taux réel peut rester sous `hz`
+    const double seconds = sampledNanos.load() * 1e-9;
+    std::cout << "[Profiler] " << samples << " samples over " << std::fixed << std::setprecision(1) << seconds
+              << " s of CPU of the game threads (" << std::setprecision(0) << (seconds > 0 ? samples / seconds : 0.0)
+              << " per s, " << hz << " asked), " << dropped.load() << " dropped\n";
+    std::cout << "  library                             self%   total%   hottest function (self)\n";
+    for (const auto& [library, share] : order) {
+        std::string hottest;
+        uint64_t hottestSamples = 0;
+        for (const auto& [function, count] : share->functions) {
+            if (count > hottestSamples) {
+                hottest = function;
+                hottestSamples = count;
+            }
+        }
+        if (hottest.size() > 70) {
+            hottest = hottest.substr(0, 67) + "...";
+        }
+        std::cout << "  " << (share->strategy ? "* " : "  ") << std::left << std::setw(32) << library << std::right
+                  << std::setw(7) << std::setprecision(1) << 100.0 * share->self / all
+                  << std::setw(9) << 100.0 * share->total / all << "   " << hottest << "\n";
+    }
+    std::cout << "[Profiler] Strategy libraries (*): " << std::setprecision(1) << 100.0 * strategySelf / all
+              << "% of the sampled CPU\n";
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+ProfiledThread::ProfiledThread() {
+#ifdef SEVENS_PROFILER_SUPPORTED
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    SamplingProfiler* profiler = activeProfiler.load();
+    if (!profiler) {
+        return;
+    }
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return;
+    }
+    void* base = nullptr;
+    size_t size = 0;
+    pthread_attr_getstack(&attributes, &base, &size);
+    pthread_attr_destroy(&attributes);
+
+    sigevent event {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+    timer_t timer;
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+        std::cerr << "[Profiler] Cannot create a sampling timer: " << std::strerror(errno) << "\n";
+        return;
+    }
+    threadStack = {reinterpret_cast<uintptr_t>(base), reinterpret_cast<uintptr_t>(base) + size};
+    const uint64_t period = 1000000000ULL / profiler->getHz();
+    itimerspec interval {};
+    interval.it_interval.tv_sec = static_cast<time_t>(period / 1000000000ULL);
+    interval.it_interval.tv_nsec = static_cast<long>(period % 1000000000ULL);
+    interval.it_value = interval.it_interval;
+    timer_settime(timer, 0, &interval, nullptr);
+    id = nextThreadId++;
+    timers.emplace(id, std::make_pair(timer, threadCpuNanos()));
+#endif
+}
+
+ProfiledThread::~ProfiledThread() {
+#ifdef SEVENS_PROFILER_SUPPORTED
+    if (id < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    const auto timer = timers.find(id);
+    if (timer != timers.end()) { // sinon stop() l'a déjà supprimé
+        timer_delete(timer->second.first);
+        sampledNanos += threadCpuNanos() - timer->second.second;
+        timers.erase(timer);
+    }
+    threadStack = {0, 0};
+#endif
+}
+
+} // namespace sevens
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Sampling CPU profiler ("tournament --profile <file>"): which library, and which function in it,
+ * burns the CPU of the game threads, without rebuilding anything with instrumentation.
+ *
+ * Every ProfiledThread gets a timer on its own CPU clock (timer_create, CLOCK_THREAD_CPUTIME_ID)
+ * that sends it SIGPROF `hz` times per second of CPU it uses (these timers expire on the kernel tick,
+ * so the real rate can stay below, e.g. 250 with HZ=250: the summary prints it). The handler walks
+ * the frame-pointer chain from the interrupted registers, bounded by the stack of the thread, and
+ * copies the return addresses into a preallocated ring of slots: no lock, no allocation, only
+ * atomics, so it is async-signal-safe. A background thread drains the ring every 10 ms and resolves addresses with
+ * dladdr(), while the libraries are still loaded (hot reload included); libraries opened through
+ * StrategyLibrary are named by the path they were loaded from.
+ *
+ * The leaf of a sample (self time) is always exact. Deeper frames need frame pointers: build the
+ * strategy libraries and the engine with -fno-omit-frame-pointer, and link sevens_game with
+ * -rdynamic so dladdr() can name its functions (else "sevens_game`0x1a2b", an offset for addr2line).
+ *
+ * Linux only (x86-64 and AArch64); elsewhere the constructor throws.
+ */
+class SamplingProfiler {
+public:
+    static constexpr uint32_t kMaxDepth = 64;
+
+    // @throws std::runtime_error if sampling is unavailable or another profiler is running.
+    explicit SamplingProfiler(uint64_t hz = 997);
+    ~SamplingProfiler();
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    // Stops the timers of every thread and resolves the last samples (called by the destructor)
+    void stop();
+
+    // Folded stacks, one "root;...;leaf count" line per distinct stack (flamegraph.pl, speedscope).
+    // Frames are "library`function". Call after stop().
+    // @throws std::runtime_error if the file cannot be written.
+    void writeFolded(const std::string& path) const;
+
+    // CPU share of every library (self: the leaf of the sample is in it, total: any frame is) and its
+    // hottest function. Call after stop().
+    void printSummary() const;
+
+    uint64_t getHz() const { return hz; }
+    uint64_t getSamples() const { return samples; }
+
+    // Called by the SIGPROF handler: async-signal-safe, drops the sample if the ring is full
+    void record(const uintptr_t* pcs, uint32_t depth);
+
+private:
+    static constexpr uint64_t kSlots = 4096;
+
+    struct Slot {
+        std::atomic<uint32_t> state{0}; // 0 libre, 1 en écriture (handler), 2 prêt à vider
+        uint32_t depth = 0;
+        uintptr_t pcs[kMaxDepth];
+    };
+
+    struct Frame {
+        std::string library;  // StrategyLibrary path, or file name of any other object
+        std::string function; // demangled symbol, or offset in the library
+        bool strategy = false; // loaded through StrategyLibrary
+    };
+
+    void run();
+    void drain();
+    uint32_t frameAt(uintptr_t pc);
+
+    uint64_t hz;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> cursor{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> stopping{false};
+    bool stopped = false;
+    std::thread thread;
+
+    // Réservés au thread de vidage tant que le profileur tourne
+    std::vector<Frame> frames;
+    std::unordered_map<std::string, uint32_t> frameIds;  // "library`function" -> frames
+    std::unordered_map<uintptr_t, uint32_t> addressIds; // cache de dladdr
+    std::map<std::vector<uint32_t>, uint64_t> stacks;    // racine d'abord
+    uint64_t samples = 0;
+};
+
+/**
+ * Samples the calling thread while it lives, if a SamplingProfiler is running (no-op otherwise).
+ * The timer counts the CPU time of the thread only, so a blocked thread takes no samples.
+ */
+class ProfiledThread {
+public:
+    ProfiledThread();
+    ~ProfiledThread();
+    ProfiledThread(const ProfiledThread&) = delete;
+    ProfiledThread& operator=(const ProfiledThread&) = delete;
+
+private:
+    int64_t id = -1;
+};
+
+} // namespace sevens
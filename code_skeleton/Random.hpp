@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace sevens {
+
+/**
+ * xoshiro256** (Blackman & Vigna): 32 bytes of state, a few cycles per
+ * 64-bit draw, and good high bits. Usable as a URBG. The seed is expanded
+ * with splitmix64, as recommended by the authors.
+ */
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    explicit Xoshiro256(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t value) {
+        for (uint64_t& word : state) {
+            value += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = value;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+};
+
+// 32 random bits from a 32-bit (std::mt19937) or 64-bit (Xoshiro256, XorShift64) generator
+template <class URBG>
+inline uint32_t random32(URBG& rng) {
+    static_assert(URBG::min() == 0 && (URBG::max() == 0xFFFFFFFFu || URBG::max() == std::numeric_limits<uint64_t>::max()),
+                  "random32 needs a generator producing full 32- or 64-bit words");
+    if constexpr (URBG::max() == 0xFFFFFFFFu) {
+        return static_cast<uint32_t>(rng());
+    } else {
+        return static_cast<uint32_t>(rng() >> 32); // bits de poids fort : les meilleurs pour xorshift/xoshiro
+    }
+}
+
+/**
+ * Unbiased integer in [0, range) with Lemire's multiply-shift method:
+ * no division except on the rare rejection path.
+ */
+template <class URBG>
+inline uint32_t boundedRandom(URBG& rng, uint32_t range) {
+    uint64_t product = static_cast<uint64_t>(random32(rng)) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        const uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(random32(rng)) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+/**
+ * Deals `cards` round-robin without shuffling them first: step i draws the
+ * i-th card of the shuffled deck among the cards not dealt yet (Fisher–Yates)
+ * and hands it straight to player i % numPlayers through give(player, card).
+ * The last card needs no draw.
+ */
+template <class Card, class URBG, class Give>
+inline void dealShuffled(Card* cards, uint64_t count, uint64_t numPlayers, URBG& rng, Give&& give) {
+    uint64_t player = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i + 1 < count) {
+            std::swap(cards[i], cards[i + boundedRandom(rng, static_cast<uint32_t>(count - i))]);
+        }
+        give(player, cards[i]);
+        player = player + 1 == numPlayers ? 0 : player + 1;
+    }
+}
+
+} // namespace sevens
@@ -1,5 +1,6 @@
 #include "RandomStrategy.hpp"
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <chrono>
 #include <random>
@@ -39,8 +40,10 @@ int RandomStrategy::selectCardToPlay(
     // int idx = dist(rng);
     // return idx;
 
-    std::vector<int> playableIndices;
-    for (size_t i = 0; i < hand.size(); ++i) {
+    // Tableau fixe plutôt qu'un std::vector : aucune allocation à chaque décision
+    std::array<int, 64> playableIndices;
+    size_t playableCount = 0;
+    for (size_t i = 0; i < hand.size() && playableCount < playableIndices.size(); ++i) {
         const Card& card = hand[i];
         uint64_t suit = card.suit;
         uint64_t rank = card.rank;
@@ -58,15 +61,15 @@ int RandomStrategy::selectCardToPlay(
         }
 
         if (isPlayable) {
-            playableIndices.push_back(static_cast<int>(i));
+            playableIndices[playableCount++] = static_cast<int>(i);
         }
     }
 
-    if (playableIndices.empty()) {
+    if (playableCount == 0) {
         return -1;
     }
 
-    std::uniform_int_distribution<int> dist(0, playableIndices.size() - 1);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(playableCount) - 1);
     return playableIndices[dist(rng)];
 }
 
@@ -0,0 +1,108 @@
+#include "ResourceUsage.hpp"
+#include "AllocationCounter.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace sevens {
+
+void StrategyUsage::merge(const StrategyUsage& other) {
+    decisions += other.decisions;
+    observations += other.observations;
+    cpuNanos += other.cpuNanos;
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+    retainedBytes += other.retainedBytes;
+}
+
+uint64_t threadCpuNanos() {
+#ifndef _WIN32
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#else
+    // Pas d'horloge CPU par thread portable : temps écoulé à la place
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+AccountedStrategy::AccountedStrategy(std::shared_ptr<PlayerStrategy> inner) : inner(std::move(inner)) {}
+
+template <class F>
+auto AccountedStrategy::measure(F&& call) {
+    const AllocationCounts allocBefore = threadAllocations();
+    const uint64_t cpuBefore = threadCpuNanos();
+
+    // Les mesures sont faites même si la stratégie lève une exception
+    struct Record {
+        StrategyUsage& usage;
+        const AllocationCounts& allocBefore;
+        uint64_t cpuBefore;
+        ~Record() {
+            const uint64_t cpuAfter = threadCpuNanos();
+            const AllocationCounts allocAfter = threadAllocations();
+            usage.cpuNanos += cpuAfter - cpuBefore;
+            usage.allocations += allocAfter.allocations - allocBefore.allocations;
+            usage.allocatedBytes += allocAfter.bytes - allocBefore.bytes;
+            usage.retainedBytes += static_cast<int64_t>(allocAfter.bytes - allocBefore.bytes) -
+                                   static_cast<int64_t>(allocAfter.freedBytes - allocBefore.freedBytes);
+        }
+    } record{usage, allocBefore, cpuBefore};
+
+    return call();
+}
+
+void AccountedStrategy::initialize(uint64_t playerID) {
+    measure([&]() { inner->initialize(playerID); });
+}
+
+int AccountedStrategy::selectCardToPlay(
+    const std::vector<Card>& hand,
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) {
+    ++usage.decisions;
+    return measure([&]() { return inner->selectCardToPlay(hand, tableLayout); });
+}
+
+void AccountedStrategy::observeMove(uint64_t playerID, const Card& playedCard) {
+    ++usage.observations;
+    measure([&]() { inner->observeMove(playerID, playedCard); });
+}
+
+void AccountedStrategy::observePass(uint64_t playerID) {
+    ++usage.observations;
+    measure([&]() { inner->observePass(playerID); });
+}
+
+std::string AccountedStrategy::getName() const {
+    return inner->getName();
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void printUsageHeader() {
+    std::cout << "  strategy                     decisions   CPU ms   us/decision   allocs   alloc KB   retained KB\n";
+}
+
+void printUsageLine(const std::string& label, const StrategyUsage& usage, double cpuBudgetMicros) {
+    const double perDecision = usage.decisions ? usage.cpuNanos / 1000.0 / usage.decisions : 0.0;
+    std::cout << "  " << std::left << std::setw(27) << label << std::right
+              << std::setw(11) << usage.decisions
+              << std::setw(9) << std::fixed << std::setprecision(1) << usage.cpuNanos / 1e6
+              << std::setw(14) << std::setprecision(2) << perDecision
+              << std::setw(9) << usage.allocations
+              << std::setw(11) << std::setprecision(1) << usage.allocatedBytes / 1024.0
+              << std::setw(14) << usage.retainedBytes / 1024.0;
+    if (cpuBudgetMicros > 0 && perDecision > cpuBudgetMicros) {
+        std::cout << "   OVER BUDGET";
+    }
+    std::cout << "\n";
+}
+
+} // namespace sevens
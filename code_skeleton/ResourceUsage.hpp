@@ -0,0 +1,61 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace sevens {
+
+/**
+ * Resources consumed inside the calls of one strategy
+ * (selectCardToPlay, observeMove, observePass).
+ */
+struct StrategyUsage {
+    uint64_t decisions = 0;     // selectCardToPlay calls
+    uint64_t observations = 0;  // observeMove / observePass calls
+    uint64_t cpuNanos = 0;      // thread CPU time
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    int64_t retainedBytes = 0;  // allocated - freed during its calls (Linux only)
+
+    void merge(const StrategyUsage& other);
+};
+
+// CPU time consumed by the calling thread, in nanoseconds
+uint64_t threadCpuNanos();
+
+/**
+ * Decorator measuring every call made to the wrapped strategy: thread CPU
+ * time (CLOCK_THREAD_CPUTIME_ID) and heap allocations seen by the global
+ * operator new of AllocationCounter.cpp. The engine is unchanged, it just
+ * plays the wrapper instead of the strategy.
+ */
+class AccountedStrategy : public PlayerStrategy {
+public:
+    explicit AccountedStrategy(std::shared_ptr<PlayerStrategy> inner);
+
+    void initialize(uint64_t playerID) override;
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override;
+    void observeMove(uint64_t playerID, const Card& playedCard) override;
+    void observePass(uint64_t playerID) override;
+    std::string getName() const override;
+
+    const StrategyUsage& getUsage() const { return usage; }
+    void resetUsage() { usage = StrategyUsage{}; }
+
+private:
+    template <class F>
+    auto measure(F&& call);
+
+    std::shared_ptr<PlayerStrategy> inner;
+    StrategyUsage usage;
+};
+
+// One line of the resource report; flags strategies above `cpuBudgetMicros` per decision (0 = no budget)
+void printUsageLine(const std::string& label, const StrategyUsage& usage, double cpuBudgetMicros);
+void printUsageHeader();
+
+} // namespace sevens
@@ -0,0 +1,774 @@
+#include "ResultsStore.hpp"
+#include "CommandLine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEVENS_RESULTS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sevens {
+
+namespace results {
+
+namespace {
+
+uint64_t aligned(uint64_t bytes) { return (bytes + kAlignment - 1) / kAlignment * kAlignment; }
+
+} // namespace
+
+bool plausibleChunk(const ChunkHeader& header, uint64_t available) {
+    return header.magic == kChunkMagic && header.rows > 0 && header.rows <= kChunkRows &&
+           header.bytes <= available && header.bytes == ChunkLayout(header.rows).bytes;
+}
+
+uint64_t completeChunksEnd(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    const uint64_t size = std::filesystem::file_size(path);
+    uint64_t offset = sizeof(FileHeader);
+    ChunkHeader header{};
+    while (offset + sizeof(header) <= size && in.seekg(static_cast<std::streamoff>(offset)) &&
+           in.read(reinterpret_cast<char*>(&header), sizeof(header)) && plausibleChunk(header, size - offset)) {
+        offset += header.bytes;
+    }
+    return std::min(offset, size);
+}
+
+ChunkLayout::ChunkLayout(uint64_t rows) {
+    uint64_t offset = sizeof(ChunkHeader);
+    auto column = [&](uint64_t width) {
+        const uint64_t start = offset;
+        offset += aligned(rows * width);
+        return start;
+    };
+    seed = column(sizeof(uint64_t));
+    rounds = column(sizeof(uint16_t));
+    players = column(sizeof(uint8_t));
+    for (uint64_t s = 0; s < kMaxPlayers; ++s) {
+        strategy[s] = column(sizeof(uint16_t));
+        rank[s] = column(sizeof(uint8_t));
+        points[s] = column(sizeof(uint16_t));
+    }
+    bytes = offset;
+}
+
+} // namespace results
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+ResultsWriter::ResultsWriter(const std::string& path) : path(path) {
+    results::FileHeader header{};
+    {
+        std::ifstream existing(path, std::ios::binary);
+        if (existing && existing.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            if (header.magic != results::kFileMagic) {
+                throw std::runtime_error("[ResultsStore] Not a results file: " + path);
+            }
+        } else {
+            header = results::FileHeader{};
+            header.magic = results::kFileMagic;
+            header.version = 1;
+            header.chunkRows = results::kChunkRows;
+            std::ofstream created(path, std::ios::binary | std::ios::trunc);
+            created.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!created) {
+                throw std::runtime_error("[ResultsStore] Cannot create " + path);
+            }
+        }
+    }
+
+    // Un chunk coupé par un crash serait suivi des nouveaux, et lu avec eux : on l'enlève avant d'ajouter
+    const uint64_t end = results::completeChunksEnd(path);
+    if (end < std::filesystem::file_size(path)) {
+        std::cerr << "[ResultsStore] Dropping an incomplete chunk at offset " << end << " of " << path << "\n";
+        std::filesystem::resize_file(path, end);
+    }
+
+    const std::vector<std::string> names = readStrategyNames(path);
+    for (size_t id = 0; id < names.size(); ++id) {
+        ids.emplace(names[id], static_cast<uint16_t>(id));
+    }
+    file.open(path, std::ios::binary | std::ios::app);
+    namesFile.open(path + ".names", std::ios::app);
+    if (!file || !namesFile) {
+        throw std::runtime_error("[ResultsStore] Cannot open " + path + " for appending");
+    }
+    pending.reserve(results::kChunkRows);
+}
+
+ResultsWriter::~ResultsWriter() {
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+}
+
+uint16_t ResultsWriter::strategyId(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    if (ids.size() >= results::kNoStrategy) {
+        throw std::runtime_error("[ResultsStore] Too many strategy names in " + path);
+    }
+    const auto id = static_cast<uint16_t>(ids.size());
+    ids.emplace(name, id);
+    namesFile << name << "\n" << std::flush; // le dictionnaire doit précéder les lignes qui l'utilisent
+    return id;
+}
+
+void ResultsWriter::append(const GameRecord& record) {
+    pending.push_back(record);
+    if (pending.size() == results::kChunkRows) {
+        flush();
+    }
+}
+
+void ResultsWriter::flush() {
+    if (pending.empty()) {
+        return;
+    }
+    const uint64_t rows = pending.size();
+    const results::ChunkLayout layout(rows);
+    buffer.assign(layout.bytes, 0);
+
+    results::ChunkHeader header{};
+    header.magic = results::kChunkMagic;
+    header.rows = static_cast<uint32_t>(rows);
+    header.bytes = layout.bytes;
+    header.minSeed = std::numeric_limits<uint64_t>::max();
+    header.minRounds = header.minPoints = std::numeric_limits<uint16_t>::max();
+    header.minStrategy.fill(results::kNoStrategy);
+    header.maxStrategy.fill(0);
+    header.minPlayers = std::numeric_limits<uint8_t>::max();
+
+    uint8_t* chunk = buffer.data();
+    for (uint64_t r = 0; r < rows; ++r) {
+        const GameRecord& record = pending[r];
+        std::memcpy(chunk + layout.seed + r * sizeof(uint64_t), &record.seed, sizeof(uint64_t));
+        std::memcpy(chunk + layout.rounds + r * sizeof(uint16_t), &record.rounds, sizeof(uint16_t));
+        chunk[layout.players + r] = record.numPlayers;
+        header.minSeed = std::min(header.minSeed, record.seed);
+        header.maxSeed = std::max(header.maxSeed, record.seed);
+        header.minRounds = std::min(header.minRounds, record.rounds);
+        header.maxRounds = std::max(header.maxRounds, record.rounds);
+        header.minPlayers = std::min(header.minPlayers, record.numPlayers);
+        header.maxPlayers = std::max(header.maxPlayers, record.numPlayers);
+
+        for (uint64_t s = 0; s < kMaxPlayers; ++s) {
+            const bool used = s < record.numPlayers;
+            const uint16_t strategy = used ? record.strategy[s] : results::kNoStrategy;
+            const uint16_t points = used ? record.points[s] : 0;
+            std::memcpy(chunk + layout.strategy[s] + r * sizeof(uint16_t), &strategy, sizeof(uint16_t));
+            std::memcpy(chunk + layout.points[s] + r * sizeof(uint16_t), &points, sizeof(uint16_t));
+            chunk[layout.rank[s] + r] = used ? record.rank[s] : 0;
+            header.minStrategy[s] = std::min(header.minStrategy[s], strategy);
+            header.maxStrategy[s] = std::max(header.maxStrategy[s], strategy);
+            if (used) {
+                header.minPoints = std::min(header.minPoints, points);
+                header.maxPoints = std::max(header.maxPoints, points);
+            }
+        }
+    }
+    std::memcpy(chunk, &header, sizeof(header));
+
+    file.write(reinterpret_cast<const char*>(chunk), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("[ResultsStore] Write failed on " + path);
+    }
+    pending.clear();
+}
+
+std::vector<std::string> readStrategyNames(const std::string& path) {
+    std::vector<std::string> names;
+    std::ifstream namesFile(path + ".names");
+    for (std::string line; std::getline(namesFile, line);) {
+        names.push_back(line);
+    }
+    return names;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/**
+ * Read-only view of a whole file: mmap on POSIX, plain read elsewhere.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info{};
+        if (fd < 0 || fstat(fd, &info) < 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::runtime_error("[ResultsStore] Cannot open " + path);
+        }
+        size = static_cast<uint64_t>(info.st_size);
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("[ResultsStore] mmap failed on " + path);
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL); // lecture en un seul passage
+            data = static_cast<const uint8_t*>(mapped);
+        }
+        close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("[ResultsStore] Cannot open " + path);
+        }
+        copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = copy.data();
+        size = copy.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+
+private:
+#ifdef _WIN32
+    std::vector<uint8_t> copy;
+#endif
+};
+
+// ----- Column kernels: AVX2 when the CPU has it, scalar otherwise (n <= kChunkRows) -----
+
+uint64_t countEqualScalar(const uint8_t* values, uint64_t n, uint8_t value) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        count += values[i] == value;
+    }
+    return count;
+}
+
+uint64_t sumU8Scalar(const uint8_t* values, uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+uint64_t sumU16Scalar(const uint16_t* values, uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+// Same scans through a selection vector (0x00 / 0xFF per row) when a seed range cuts through a chunk
+uint64_t selectSeedsScalar(const uint64_t* seeds, uint64_t n, uint64_t first, uint64_t last, uint8_t* selected) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        const bool inRange = (seeds[i] >= first) & (seeds[i] <= last);
+        selected[i] = static_cast<uint8_t>(-static_cast<int>(inRange)); // 0x00 / 0xFF
+        count += inRange;
+    }
+    return count;
+}
+
+uint64_t countEqualSelectedScalar(const uint8_t* values, const uint8_t* selected, uint64_t n, uint8_t value) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        count += (values[i] == value) & (selected[i] & 1);
+    }
+    return count;
+}
+
+uint64_t sumU8SelectedScalar(const uint8_t* values, const uint8_t* selected, uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        sum += values[i] & selected[i];
+    }
+    return sum;
+}
+
+uint64_t sumU16SelectedScalar(const uint16_t* values, const uint8_t* selected, uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        sum += selected[i] ? values[i] : 0;
+    }
+    return sum;
+}
+
+#ifdef SEVENS_RESULTS_AVX2
+
+__attribute__((target("avx2"))) uint64_t countEqualAvx2(const uint8_t* values, uint64_t n, uint8_t value) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        count += static_cast<uint64_t>(__builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)))));
+    }
+    return count + countEqualScalar(values + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) uint64_t sumU8Avx2(const uint8_t* values, uint64_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumU8Scalar(values + i, n - i);
+}
+
+__attribute__((target("avx2"))) uint64_t sumU16Avx2(const uint16_t* values, uint64_t n) {
+    // madd : paires de u16 (< 2^15 ici, ce sont des points) sommées en i32 ; pas de débordement sur un chunk
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(v, ones));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = 0;
+    for (int32_t lane : lanes) {
+        sum += static_cast<uint64_t>(lane);
+    }
+    return sum + sumU16Scalar(values + i, n - i);
+}
+
+__attribute__((target("avx2"))) uint64_t selectSeedsAvx2(const uint64_t* seeds, uint64_t n, uint64_t first, uint64_t last, uint8_t* selected) {
+    // Pas de comparaison non signée 64 bits en AVX2 : on bascule le bit de signe des deux côtés
+    const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+    const __m256i low = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(first)), sign);
+    const __m256i high = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(last)), sign);
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(seeds + i)), sign);
+        const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(low, v), _mm256_cmpgt_epi64(v, high));
+        const uint32_t bits = ~static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(outside))) & 0xF;
+        for (uint64_t k = 0; k < 4; ++k) {
+            selected[i + k] = static_cast<uint8_t>(-static_cast<int>((bits >> k) & 1));
+        }
+        count += static_cast<uint64_t>(__builtin_popcount(bits));
+    }
+    return count + selectSeedsScalar(seeds + i, n - i, first, last, selected + i);
+}
+
+__attribute__((target("avx2"))) uint64_t countEqualSelectedAvx2(const uint8_t* values, const uint8_t* selected, uint64_t n, uint8_t value) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(selected + i));
+        const __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(v, needle), mask);
+        count += static_cast<uint64_t>(__builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(hit))));
+    }
+    return count + countEqualSelectedScalar(values + i, selected + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) uint64_t sumU8SelectedAvx2(const uint8_t* values, const uint8_t* selected, uint64_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(selected + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_and_si256(v, mask), _mm256_setzero_si256()));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumU8SelectedScalar(values + i, selected + i, n - i);
+}
+
+__attribute__((target("avx2"))) uint64_t sumU16SelectedAvx2(const uint16_t* values, const uint8_t* selected, uint64_t n) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i mask = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(selected + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_and_si256(v, mask), ones));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = 0;
+    for (int32_t lane : lanes) {
+        sum += static_cast<uint64_t>(lane);
+    }
+    return sum + sumU16SelectedScalar(values + i, selected + i, n - i);
+}
+
+bool hasAvx2() {
+    static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return supported;
+}
+
+uint64_t countEqual(const uint8_t* values, uint64_t n, uint8_t value) {
+    return hasAvx2() ? countEqualAvx2(values, n, value) : countEqualScalar(values, n, value);
+}
+uint64_t sumU8(const uint8_t* values, uint64_t n) { return hasAvx2() ? sumU8Avx2(values, n) : sumU8Scalar(values, n); }
+uint64_t sumU16(const uint16_t* values, uint64_t n) { return hasAvx2() ? sumU16Avx2(values, n) : sumU16Scalar(values, n); }
+
+uint64_t selectSeeds(const uint64_t* seeds, uint64_t n, uint64_t first, uint64_t last, uint8_t* selected) {
+    return hasAvx2() ? selectSeedsAvx2(seeds, n, first, last, selected) : selectSeedsScalar(seeds, n, first, last, selected);
+}
+uint64_t countEqualSelected(const uint8_t* values, const uint8_t* selected, uint64_t n, uint8_t value) {
+    return hasAvx2() ? countEqualSelectedAvx2(values, selected, n, value) : countEqualSelectedScalar(values, selected, n, value);
+}
+uint64_t sumU8Selected(const uint8_t* values, const uint8_t* selected, uint64_t n) {
+    return hasAvx2() ? sumU8SelectedAvx2(values, selected, n) : sumU8SelectedScalar(values, selected, n);
+}
+uint64_t sumU16Selected(const uint16_t* values, const uint8_t* selected, uint64_t n) {
+    return hasAvx2() ? sumU16SelectedAvx2(values, selected, n) : sumU16SelectedScalar(values, selected, n);
+}
+
+#else
+
+uint64_t countEqual(const uint8_t* values, uint64_t n, uint8_t value) { return countEqualScalar(values, n, value); }
+uint64_t sumU8(const uint8_t* values, uint64_t n) { return sumU8Scalar(values, n); }
+uint64_t sumU16(const uint16_t* values, uint64_t n) { return sumU16Scalar(values, n); }
+
+uint64_t selectSeeds(const uint64_t* seeds, uint64_t n, uint64_t first, uint64_t last, uint8_t* selected) {
+    return selectSeedsScalar(seeds, n, first, last, selected);
+}
+uint64_t countEqualSelected(const uint8_t* values, const uint8_t* selected, uint64_t n, uint8_t value) {
+    return countEqualSelectedScalar(values, selected, n, value);
+}
+uint64_t sumU8Selected(const uint8_t* values, const uint8_t* selected, uint64_t n) { return sumU8SelectedScalar(values, selected, n); }
+uint64_t sumU16Selected(const uint16_t* values, const uint8_t* selected, uint64_t n) { return sumU16SelectedScalar(values, selected, n); }
+
+#endif // SEVENS_RESULTS_AVX2
+
+// ----- Aggregation -----
+
+struct Tally {
+    uint64_t games = 0;
+    uint64_t wins = 0;
+    uint64_t lastPlaces = 0;
+    uint64_t rankSum = 0;
+    uint64_t points = 0;
+
+    Tally& operator+=(const Tally& other) {
+        games += other.games;
+        wins += other.wins;
+        lastPlaces += other.lastPlaces;
+        rankSum += other.rankSum;
+        points += other.points;
+        return *this;
+    }
+};
+
+struct QueryFilter {
+    int strategy = -1; // only games where this strategy plays
+    uint64_t firstSeed = 0;
+    uint64_t lastSeed = std::numeric_limits<uint64_t>::max();
+};
+
+struct QueryResults {
+    std::vector<Tally> byStrategy;
+    std::array<Tally, kMaxPlayers> bySeat{};
+    std::map<std::vector<uint16_t>, Tally> byOpponents; // opponents of the filtered strategy, sorted ids
+    uint64_t rows = 0;
+    uint64_t chunks = 0;
+    uint64_t skippedChunks = 0;
+    uint64_t bytes = 0;
+};
+
+struct Chunk {
+    const results::ChunkHeader* header;
+    const uint8_t* base;
+    results::ChunkLayout layout;
+
+    const uint64_t* seeds() const { return reinterpret_cast<const uint64_t*>(base + layout.seed); }
+    const uint8_t* players() const { return base + layout.players; }
+    const uint16_t* strategy(uint64_t s) const { return reinterpret_cast<const uint16_t*>(base + layout.strategy[s]); }
+    const uint8_t* rank(uint64_t s) const { return base + layout.rank[s]; }
+    const uint16_t* points(uint64_t s) const { return reinterpret_cast<const uint16_t*>(base + layout.points[s]); }
+};
+
+void addTo(QueryResults& out, uint64_t seat, uint16_t strategy, const Tally& tally) {
+    if (out.byStrategy.size() <= strategy) {
+        out.byStrategy.resize(strategy + 1u);
+    }
+    out.byStrategy[strategy] += tally;
+    out.bySeat[seat] += tally;
+}
+
+// Whole chunk with a fixed line-up: every seat is one column scan.
+// If the seed range cuts through the chunk, the scans go through a selection vector.
+void scanConstantChunk(const Chunk& chunk, const QueryFilter& filter, QueryResults& out, std::vector<uint8_t>& selected) {
+    const uint64_t rows = chunk.header->rows;
+    const uint8_t numPlayers = chunk.header->minPlayers;
+    const auto& lineUp = chunk.header->minStrategy;
+    if (filter.strategy >= 0 &&
+        std::find(lineUp.begin(), lineUp.begin() + numPlayers, filter.strategy) == lineUp.begin() + numPlayers) {
+        ++out.skippedChunks;
+        return;
+    }
+
+    const bool partial = chunk.header->minSeed < filter.firstSeed || chunk.header->maxSeed > filter.lastSeed;
+    uint64_t games = rows;
+    if (partial) {
+        selected.resize(rows);
+        games = selectSeeds(chunk.seeds(), rows, filter.firstSeed, filter.lastSeed, selected.data());
+    }
+
+    for (uint64_t s = 0; s < numPlayers; ++s) {
+        Tally tally;
+        tally.games = games;
+        if (partial) {
+            tally.wins = countEqualSelected(chunk.rank(s), selected.data(), rows, 1);
+            tally.lastPlaces = countEqualSelected(chunk.rank(s), selected.data(), rows, numPlayers);
+            tally.rankSum = sumU8Selected(chunk.rank(s), selected.data(), rows);
+            tally.points = sumU16Selected(chunk.points(s), selected.data(), rows);
+        } else {
+            tally.wins = countEqual(chunk.rank(s), rows, 1);
+            tally.lastPlaces = countEqual(chunk.rank(s), rows, numPlayers);
+            tally.rankSum = sumU8(chunk.rank(s), rows);
+            tally.points = sumU16(chunk.points(s), rows);
+        }
+        addTo(out, s, lineUp[s], tally);
+
+        if (filter.strategy == lineUp[s]) {
+            std::vector<uint16_t> opponents;
+            for (uint64_t o = 0; o < numPlayers; ++o) {
+                if (o != s) {
+                    opponents.push_back(lineUp[o]);
+                }
+            }
+            std::sort(opponents.begin(), opponents.end());
+            out.byOpponents[opponents] += tally;
+        }
+    }
+    out.rows += games;
+}
+
+// Mixed line-ups: row by row
+void scanRows(const Chunk& chunk, const QueryFilter& filter, QueryResults& out) {
+    const uint64_t* seeds = chunk.seeds();
+    const uint8_t* players = chunk.players();
+    std::vector<uint16_t> opponents;
+    for (uint64_t r = 0; r < chunk.header->rows; ++r) {
+        if (seeds[r] < filter.firstSeed || seeds[r] > filter.lastSeed) {
+            continue;
+        }
+        const uint8_t numPlayers = players[r];
+        bool selected = filter.strategy < 0;
+        for (uint64_t s = 0; s < numPlayers && !selected; ++s) {
+            selected = chunk.strategy(s)[r] == filter.strategy;
+        }
+        if (!selected) {
+            continue;
+        }
+        for (uint64_t s = 0; s < numPlayers; ++s) {
+            const uint16_t strategy = chunk.strategy(s)[r];
+            const uint8_t rank = chunk.rank(s)[r];
+            Tally tally;
+            tally.games = 1;
+            tally.wins = rank == 1;
+            tally.lastPlaces = rank == numPlayers;
+            tally.rankSum = rank;
+            tally.points = chunk.points(s)[r];
+            addTo(out, s, strategy, tally);
+
+            if (filter.strategy == strategy) {
+                opponents.clear();
+                for (uint64_t o = 0; o < numPlayers; ++o) {
+                    if (o != s) {
+                        opponents.push_back(chunk.strategy(o)[r]);
+                    }
+                }
+                std::sort(opponents.begin(), opponents.end());
+                out.byOpponents[opponents] += tally;
+            }
+        }
+        ++out.rows;
+    }
+}
+
+QueryResults runQuery(const MappedFile& file, const QueryFilter& filter) {
+    QueryResults out;
+    results::FileHeader fileHeader;
+    if (file.size < sizeof(fileHeader)) {
+        throw std::runtime_error("[ResultsStore] File too small");
+    }
+    std::memcpy(&fileHeader, file.data, sizeof(fileHeader));
+    if (fileHeader.magic != results::kFileMagic) {
+        throw std::runtime_error("[ResultsStore] Not a results file");
+    }
+
+    std::vector<uint8_t> selected;
+    uint64_t offset = sizeof(fileHeader);
+    while (offset + sizeof(results::ChunkHeader) <= file.size) {
+        const auto* header = reinterpret_cast<const results::ChunkHeader*>(file.data + offset);
+        if (!results::plausibleChunk(*header, file.size - offset)) {
+            std::cerr << "[query] Ignoring incomplete chunk at offset " << offset << "\n";
+            break;
+        }
+        const Chunk chunk{header, file.data + offset, results::ChunkLayout(header->rows)};
+        offset += header->bytes;
+        ++out.chunks;
+
+        // Zone maps : on saute les chunks qui ne peuvent pas contenir de ligne retenue
+        bool mayMatch = header->maxSeed >= filter.firstSeed && header->minSeed <= filter.lastSeed;
+        if (mayMatch && filter.strategy >= 0) {
+            bool strategyInRange = false;
+            for (uint64_t s = 0; s < kMaxPlayers; ++s) {
+                strategyInRange |= header->minStrategy[s] <= filter.strategy && filter.strategy <= header->maxStrategy[s];
+            }
+            mayMatch = strategyInRange;
+        }
+        if (!mayMatch) {
+            ++out.skippedChunks;
+            continue;
+        }
+        out.bytes += header->bytes;
+
+        bool constant = header->minPlayers == header->maxPlayers;
+        for (uint64_t s = 0; s < kMaxPlayers; ++s) {
+            constant &= header->minStrategy[s] == header->maxStrategy[s];
+        }
+        if (constant) {
+            scanConstantChunk(chunk, filter, out, selected);
+        } else {
+            scanRows(chunk, filter, out);
+        }
+    }
+    return out;
+}
+
+std::string nameOf(const std::vector<std::string>& names, uint64_t id) {
+    return id < names.size() ? names[id] : "#" + std::to_string(id);
+}
+
+void printTally(const std::string& label, const Tally& tally) {
+    const double games = tally.games ? static_cast<double>(tally.games) : 1.0;
+    std::cout << "  " << std::left << std::setw(40) << label << std::right
+              << std::setw(12) << tally.games
+              << std::setw(8) << std::fixed << std::setprecision(1) << 100.0 * tally.wins / games
+              << std::setw(11) << std::setprecision(2) << tally.rankSum / games
+              << std::setw(8) << std::setprecision(1) << 100.0 * tally.lastPlaces / games
+              << std::setw(13) << std::setprecision(2) << tally.points / games << "\n";
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runQueryMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "[main] Usage: ./sevens_game query <file> [--strategy NAME] [--seeds FIRST:LAST]\n";
+        return 1;
+    }
+    const std::string path = argv[2];
+    const std::vector<std::string> names = readStrategyNames(path);
+    QueryFilter filter;
+    std::string strategyName;
+
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--strategy" && i + 1 < argc) {
+            strategyName = argv[++i];
+            const auto it = std::find(names.begin(), names.end(), strategyName);
+            if (it == names.end()) {
+                std::cerr << "[query] Unknown strategy: " << strategyName << "\n";
+                return 1;
+            }
+            filter.strategy = static_cast<int>(it - names.begin());
+        } else if (arg == "--seeds" && i + 1 < argc) {
+            const std::string range = argv[++i];
+            const size_t colon = range.find(':');
+            if (!cli::parseCount("[query]", arg, range.substr(0, colon), filter.firstSeed)) {
+                return 1;
+            }
+            filter.lastSeed = filter.firstSeed;
+            if (colon != std::string::npos && !cli::parseCount("[query]", arg, range.substr(colon + 1), filter.lastSeed)) {
+                return 1;
+            }
+            if (filter.firstSeed > filter.lastSeed) {
+                std::cerr << "[query] --seeds takes FIRST:LAST with FIRST <= LAST, not " << range << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "[query] Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    try {
+        const MappedFile file(path);
+        const auto start = std::chrono::steady_clock::now();
+        const QueryResults out = runQuery(file, filter);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[query] " << out.rows << " games in " << out.chunks << " chunks (" << out.skippedChunks
+                  << " skipped by min/max), " << std::fixed << std::setprecision(1) << seconds * 1e3 << " ms, "
+                  << out.bytes / seconds / 1e9 << " GB/s\n";
+        const std::string columns = "       games    win%   avg rank  last%   avg points\n";
+
+        std::cout << "[query] By strategy:\n  " << std::left << std::setw(40) << "strategy" << std::right << columns;
+        for (size_t id = 0; id < out.byStrategy.size(); ++id) {
+            if (out.byStrategy[id].games) {
+                printTally(nameOf(names, id), out.byStrategy[id]);
+            }
+        }
+        std::cout << "[query] By seat:\n  " << std::left << std::setw(40) << "seat" << std::right << columns;
+        for (uint64_t s = 0; s < kMaxPlayers; ++s) {
+            if (out.bySeat[s].games) {
+                printTally(std::to_string(s), out.bySeat[s]);
+            }
+        }
+        if (filter.strategy >= 0) {
+            std::cout << "[query] " << strategyName << " by opponent set:\n  " << std::left << std::setw(40)
+                      << "opponents" << std::right << columns;
+            for (const auto& [opponents, tally] : out.byOpponents) {
+                std::string label;
+                for (uint16_t id : opponents) {
+                    label += (label.empty() ? "" : " + ") + nameOf(names, id);
+                }
+                printTally(label, tally);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace sevens
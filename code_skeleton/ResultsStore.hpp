@@ -0,0 +1,122 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * One finished game, as stored in a results file.
+ * Strategies are ids in the name dictionary of the file (see ResultsWriter::strategyId).
+ */
+struct GameRecord {
+    uint64_t seed = 0;
+    uint8_t numPlayers = 0;
+    uint16_t rounds = 0;
+    std::array<uint16_t, kMaxPlayers> strategy{};
+    std::array<uint8_t, kMaxPlayers> rank{};
+    std::array<uint16_t, kMaxPlayers> points{};
+};
+
+/**
+ * Results file layout: append-only, columnar.
+ *
+ *   FileHeader, then chunks of at most kChunkRows games:
+ *   ChunkHeader (row count + min/max of every column, used to skip chunks)
+ *   then one fixed-width array per column, each 64-byte aligned:
+ *     seed u64, rounds u16, players u8, and for every seat s < 7:
+ *     strategy[s] u16 (kNoStrategy if the seat is empty), rank[s] u8, points[s] u16
+ *
+ * Strategy names live in a text sidecar "<file>.names", one per line (id = line number).
+ * A chunk cut short by a crash is ignored by the reader, and cut off by the next writer
+ * before it appends.
+ */
+namespace results {
+
+constexpr uint64_t kFileMagic = 0x3153455253564553ULL; // "SEVSRES1"
+constexpr uint32_t kChunkMagic = 0x4B4E4843;           // "CHNK"
+constexpr uint32_t kChunkRows = 64 * 1024;
+constexpr uint16_t kNoStrategy = 0xFFFF;
+constexpr uint64_t kAlignment = 64;
+
+struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t chunkRows;
+    uint8_t reserved[48];
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t rows;
+    uint64_t bytes; // whole chunk, header included
+    uint64_t minSeed, maxSeed;
+    uint16_t minRounds, maxRounds;
+    uint16_t minPoints, maxPoints;
+    std::array<uint16_t, kMaxPlayers> minStrategy; // per seat
+    std::array<uint16_t, kMaxPlayers> maxStrategy;
+    uint8_t minPlayers, maxPlayers;
+    uint8_t reserved[58];
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(ChunkHeader) == 128, "results headers must stay 64-byte aligned");
+
+// Column offsets inside a chunk of `rows` rows (from the start of the chunk)
+struct ChunkLayout {
+    uint64_t seed, rounds, players;
+    std::array<uint64_t, kMaxPlayers> strategy, rank, points;
+    uint64_t bytes;
+
+    explicit ChunkLayout(uint64_t rows);
+};
+
+// True if `header` starts a complete chunk, with `available` bytes left in the file from it
+bool plausibleChunk(const ChunkHeader& header, uint64_t available);
+
+// End of the last complete chunk of the file at `path` (the size of the file if none is cut short)
+uint64_t completeChunksEnd(const std::string& path);
+
+} // namespace results
+
+/**
+ * Appends games to a results file. Rows are buffered and written one chunk at a time.
+ * Not thread-safe: the tournament serialises its workers around it.
+ */
+class ResultsWriter {
+public:
+    // Creates the file (or reopens it for appending)
+    // @throws std::runtime_error if the file cannot be opened or is not a results file.
+    explicit ResultsWriter(const std::string& path);
+    ~ResultsWriter();
+    ResultsWriter(const ResultsWriter&) = delete;
+    ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+    // Id of a strategy name, added to the dictionary on first use
+    uint16_t strategyId(const std::string& name);
+
+    void append(const GameRecord& record);
+
+    // Writes the buffered rows as a (possibly short) chunk
+    void flush();
+
+private:
+    std::string path;
+    std::ofstream file;
+    std::ofstream namesFile;
+    std::unordered_map<std::string, uint16_t> ids;
+    std::vector<GameRecord> pending;
+    std::vector<uint8_t> buffer;
+};
+
+// Names of the dictionary sidecar of `path`, indexed by strategy id
+std::vector<std::string> readStrategyNames(const std::string& path);
+
+// Entry point of "./sevens_game query <file> [--strategy NAME] [--seeds FIRST:LAST]"
+int runQueryMode(int argc, char* argv[]);
+
+} // namespace sevens
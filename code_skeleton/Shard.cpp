@@ -0,0 +1,361 @@
+#include "Shard.hpp"
+#include "CommandLine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace sevens {
+
+namespace {
+
+constexpr const char* kSpecMagic = "sevens-shard-spec";
+constexpr const char* kResultMagic = "sevens-shard-result";
+constexpr uint64_t kShardVersion = 1;
+
+std::string specPath(const std::string& directory) { return directory + "/tournament.spec"; }
+std::string claimPath(const std::string& directory, uint64_t shard) {
+    return directory + "/shard-" + std::to_string(shard) + ".claim";
+}
+std::string resultPath(const std::string& directory, uint64_t shard) {
+    return directory + "/shard-" + std::to_string(shard) + ".result";
+}
+
+// Écriture dans un fichier temporaire puis rename : un lecteur ne voit jamais de fichier à moitié écrit
+template <class Write>
+void writeAtomically(const std::string& path, Write&& write) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        write(out);
+        if (!out) {
+            throw std::runtime_error("[Shard] Cannot write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("[Shard] Cannot replace " + path);
+    }
+}
+
+// Création exclusive ("x") : sur un système de fichiers partagé, un seul worker obtient le shard
+bool claim(const std::string& directory, uint64_t shard) {
+    std::FILE* file = std::fopen(claimPath(directory, shard).c_str(), "wx");
+    if (!file) {
+        return false;
+    }
+#ifndef _WIN32
+    char host[256] = "?";
+    gethostname(host, sizeof(host) - 1);
+    std::fprintf(file, "%s %ld\n", host, static_cast<long>(getpid()));
+#endif
+    std::fclose(file);
+    return true;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ShardPlan::save(const std::string& directory) const {
+    writeAtomically(specPath(directory), [this](std::ofstream& out) {
+        out << kSpecMagic << " " << kShardVersion << "\n";
+        out << "seed " << seed << "\n";
+        out << "games " << games << "\n";
+        out << "shards " << shards << "\n";
+        out << "stall-limit " << rules.stallLimit << "\n";
+        out << "fast-forward " << rules.fastForward << "\n";
+        for (const auto& library : libraries) {
+            out << "library " << library << "\n";
+        }
+    });
+}
+
+ShardPlan ShardPlan::load(const std::string& directory) {
+    std::ifstream in(specPath(directory));
+    std::string magic, key;
+    uint64_t version = 0;
+    if (!(in >> magic >> version) || magic != kSpecMagic || version != kShardVersion) {
+        throw std::runtime_error("[Shard] " + specPath(directory) + " is not a shard plan.");
+    }
+    ShardPlan plan;
+    in >> key >> plan.seed >> key >> plan.games >> key >> plan.shards >> key >> plan.rules.stallLimit >> key >>
+        plan.rules.fastForward;
+    while (in >> key) {
+        std::string library;
+        std::getline(in >> std::ws, library);
+        plan.libraries.push_back(library);
+    }
+    if (plan.shards == 0 || plan.libraries.size() < kMinPlayers || plan.libraries.size() > kMaxPlayers) {
+        throw std::runtime_error("[Shard] " + specPath(directory) + " is truncated.");
+    }
+    return plan;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void saveShardResults(const std::string& path, const ShardPlan& plan, uint64_t shard, const TournamentResults& results) {
+    writeAtomically(path, [&](std::ofstream& out) {
+        out << kResultMagic << " " << kShardVersion << "\n";
+        out << "range " << plan.seed << " " << plan.firstGame(shard) << " " << plan.gamesOf(shard) << "\n";
+        out << "totals " << results.games << " " << results.rounds << " " << results.stalledRounds << " "
+            << results.skippedCalls << "\n";
+        out << "seats " << results.seats.size() << "\n";
+        for (const SeatStats& stats : results.seats) {
+            const StrategyUsage& usage = stats.usage;
+            out << stats.games << " " << stats.wins << " " << stats.lastPlaces << " " << stats.rankSum << " "
+                << stats.points << " " << usage.decisions << " " << usage.observations << " " << usage.cpuNanos << " "
+                << usage.allocations << " " << usage.allocatedBytes << " " << usage.retainedBytes << " " << stats.name
+                << "\n";
+        }
+    });
+}
+
+TournamentResults loadShardResults(const std::string& path, const ShardPlan& plan, uint64_t shard) {
+    std::ifstream in(path);
+    std::string magic, key;
+    uint64_t version = 0, seed = 0, first = 0, games = 0, seats = 0;
+    if (!(in >> magic >> version) || magic != kResultMagic || version != kShardVersion) {
+        throw std::runtime_error("[Shard] " + path + " is not a shard result.");
+    }
+    in >> key >> seed >> first >> games;
+    if (!in || seed != plan.seed || first != plan.firstGame(shard) || games != plan.gamesOf(shard)) {
+        throw std::runtime_error("[Shard] " + path + " was produced by another plan.");
+    }
+    TournamentResults results;
+    in >> key >> results.games >> results.rounds >> results.stalledRounds >> results.skippedCalls >> key >> seats;
+    if (!in || seats != plan.libraries.size()) {
+        throw std::runtime_error("[Shard] " + path + " does not match the seats of the plan.");
+    }
+    results.seats.resize(seats);
+    for (SeatStats& stats : results.seats) {
+        StrategyUsage& usage = stats.usage;
+        in >> stats.games >> stats.wins >> stats.lastPlaces >> stats.rankSum >> stats.points >> usage.decisions >>
+            usage.observations >> usage.cpuNanos >> usage.allocations >> usage.allocatedBytes >> usage.retainedBytes;
+        std::getline(in >> std::ws, stats.name);
+    }
+    if (!in) {
+        throw std::runtime_error("[Shard] " + path + " is truncated.");
+    }
+    if (results.games != games) {
+        throw std::runtime_error("[Shard] " + path + " holds " + std::to_string(results.games) + " games instead of " +
+                                 std::to_string(games) + ".");
+    }
+    return results;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+const char* kUsage =
+    "[main] Usage: ./sevens_game shard plan <dir> --shards K [--games N] [--seed S] [--stall-limit T] [--fast-forward] lib1 lib2 lib3 ...\n"
+    "       ./sevens_game shard work <dir> [--workers W] [--usage] [--metrics-listen port|socket] [--metrics-json file]\n"
+    "       ./sevens_game shard run <dir> [--processes P]\n"
+    "       ./sevens_game shard merge <dir>\n";
+
+// Joue les shards non réclamés jusqu'à épuisement ; renvoie le nombre de shards joués
+uint64_t workShards(const std::string& directory, uint64_t workers, bool usage, bool withMetrics) {
+    const ShardPlan plan = ShardPlan::load(directory);
+    uint64_t played = 0;
+    for (uint64_t shard = 0; shard < plan.shards; ++shard) {
+        if (std::filesystem::exists(resultPath(directory, shard)) || !claim(directory, shard)) {
+            continue;
+        }
+        TournamentOptions options;
+        options.libraries = plan.libraries;
+        options.seed = plan.seed;
+        options.firstGame = plan.firstGame(shard);
+        options.games = plan.gamesOf(shard);
+        options.workers = workers;
+        options.usage = usage;
+        options.rules = plan.rules;
+        options.metrics = withMetrics;
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            Tournament tournament(options);
+            const TournamentResults results = tournament.run();
+            saveShardResults(resultPath(directory, shard), plan, shard, results);
+        } catch (...) {
+            std::filesystem::remove(claimPath(directory, shard)); // le shard pourra être rejoué
+            throw;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[shard] Shard " << shard << "/" << plan.shards << ": games " << options.firstGame << " to "
+                  << options.firstGame + options.games - 1 << " in " << std::fixed << std::setprecision(1) << seconds
+                  << " s\n";
+        ++played;
+    }
+    return played;
+}
+
+int mergeShards(const std::string& directory) {
+    const ShardPlan plan = ShardPlan::load(directory);
+    TournamentResults total;
+    std::vector<uint64_t> missing;
+    for (uint64_t shard = 0; shard < plan.shards; ++shard) {
+        const std::string path = resultPath(directory, shard);
+        if (!std::filesystem::exists(path)) {
+            missing.push_back(shard);
+            continue;
+        }
+        total.merge(loadShardResults(path, plan, shard));
+    }
+    if (!missing.empty()) {
+        std::cerr << "[shard] " << missing.size() << " of " << plan.shards << " shards have no result yet:";
+        for (uint64_t shard : missing) {
+            std::cerr << " " << shard << (std::filesystem::exists(claimPath(directory, shard)) ? " (claimed)" : "");
+        }
+        std::cerr << "\n";
+        return 1;
+    }
+    std::cout << "[shard] Merged " << plan.shards << " shards of " << directory << ": " << plan.games
+              << " games, seed " << plan.seed << "\n";
+    Tournament::printResults(total);
+    return 0;
+}
+
+// Lance `processes` workers locaux (le même exécutable), attend leur fin puis fusionne
+int runLocal(const char* executable, const std::string& directory, uint64_t processes) {
+#ifndef _WIN32
+    const uint64_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const std::string workers = std::to_string(std::max<uint64_t>(1, cores / processes));
+    std::vector<pid_t> children;
+    for (uint64_t p = 0; p < processes; ++p) {
+        std::vector<std::string> args = {executable, "shard", "work", directory, "--workers", workers};
+        std::vector<char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+        pid_t pid = 0;
+        if (posix_spawnp(&pid, executable, nullptr, nullptr, argv.data(), environ) != 0) {
+            std::cerr << "[shard] Cannot start worker process " << p << "\n";
+            continue;
+        }
+        children.push_back(pid);
+    }
+    bool failed = children.size() != processes;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    if (failed) {
+        std::cerr << "[shard] A worker process failed.\n";
+    }
+    return mergeShards(directory);
+#else
+    (void)executable;
+    (void)directory;
+    (void)processes;
+    std::cerr << "[shard] Local worker processes are not supported on Windows: start \"shard work\" by hand.\n";
+    return 1;
+#endif
+}
+
+} // namespace
+
+int runShardMode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << kUsage;
+        return 1;
+    }
+    const std::string action = argv[2];
+    const std::string directory = argv[3];
+    ShardPlan plan;
+    plan.games = 1000;
+    plan.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    uint64_t workers = 0, processes = std::max(1u, std::thread::hardware_concurrency());
+    bool usage = false;
+    std::string metricsListen, metricsJson;
+
+    for (int i = 4; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--shards" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], plan.shards)) {
+                return 1;
+            }
+        } else if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], plan.games)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], plan.seed)) {
+                return 1;
+            }
+        } else if (arg == "--stall-limit" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], plan.rules.stallLimit)) {
+                return 1;
+            }
+        } else if (arg == "--fast-forward") {
+            plan.rules.fastForward = true;
+        } else if (arg == "--workers" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], workers)) {
+                return 1;
+            }
+        } else if (arg == "--processes" && i + 1 < argc) {
+            if (!cli::parseCount("[shard]", arg, argv[++i], processes)) {
+                return 1;
+            }
+            processes = std::max<uint64_t>(1, processes);
+        } else if (arg == "--usage") {
+            usage = true;
+        } else if (arg == "--metrics-listen" && i + 1 < argc) {
+            metricsListen = argv[++i];
+        } else if (arg == "--metrics-json" && i + 1 < argc) {
+            metricsJson = argv[++i];
+        } else {
+            plan.libraries.push_back(arg);
+        }
+    }
+
+    try {
+        if (action == "plan") {
+            if (plan.shards == 0 || plan.libraries.size() < kMinPlayers || plan.libraries.size() > kMaxPlayers) {
+                std::cerr << kUsage;
+                return 1;
+            }
+            std::filesystem::create_directories(directory);
+            plan.save(directory);
+            std::cout << "[shard] " << directory << ": " << plan.games << " games in " << plan.shards
+                      << " shards, seed " << plan.seed << "\n";
+            return 0;
+        }
+        if (action == "work") {
+            // Un exporteur par processus worker : chaque hôte expose ses propres métriques
+            std::unique_ptr<metrics::Exporter> exporter;
+            if (!metricsListen.empty() || !metricsJson.empty()) {
+                exporter = std::make_unique<metrics::Exporter>(metricsListen, metricsJson, 5);
+            }
+            const uint64_t played = workShards(directory, workers, usage, exporter != nullptr);
+            std::cout << "[shard] No shard left to claim (" << played << " played by this worker)\n";
+            return 0;
+        }
+        if (action == "run") {
+            return runLocal(argv[0], directory, processes);
+        }
+        if (action == "merge") {
+            return mergeShards(directory);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[main] Shard mode failed: " << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << kUsage;
+    return 1;
+}
+
+} // namespace sevens
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Tournament.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * A tournament split into shards that independent processes play, on this host or on
+ * other hosts sharing the directory (NFS, ...). Layout of the shard directory:
+ *
+ *   tournament.spec    libraries, master seed, number of games and shards, round rules
+ *   shard-<i>.claim    created exclusively (O_EXCL) by the worker that takes shard i
+ *   shard-<i>.result   partial results of shard i, written to a temporary file then renamed
+ *
+ * Shard i plays games [i * games / shards, (i + 1) * games / shards) with the same game seeds
+ * as a single "tournament" run. Partial results are integer sums, so the merge is exact: for
+ * strategies that do not read the clock, it prints the same table as the single run.
+ * Library paths are opened as written in the spec, on every worker host.
+ * A worker that dies leaves its claim behind: delete shard-<i>.claim to hand the shard out again.
+ */
+struct ShardPlan {
+    std::vector<std::string> libraries;
+    uint64_t seed = 0;
+    uint64_t games = 0;
+    uint64_t shards = 0;
+    RoundRules rules;
+
+    uint64_t firstGame(uint64_t shard) const { return shard * games / shards; }
+    uint64_t gamesOf(uint64_t shard) const { return firstGame(shard + 1) - firstGame(shard); }
+
+    void save(const std::string& directory) const;
+
+    // @throws std::runtime_error if the directory holds no valid plan.
+    static ShardPlan load(const std::string& directory);
+};
+
+// Partial results of one shard, as text (exact integers, merged with TournamentResults::merge)
+void saveShardResults(const std::string& path, const ShardPlan& plan, uint64_t shard, const TournamentResults& results);
+
+// @throws std::runtime_error if the file is not the result of this shard of this plan.
+TournamentResults loadShardResults(const std::string& path, const ShardPlan& plan, uint64_t shard);
+
+// Entry point of "./sevens_game shard plan|work|run|merge <dir> ..."
+int runShardMode(int argc, char* argv[]);
+
+} // namespace sevens
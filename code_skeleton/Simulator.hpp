@@ -0,0 +1,216 @@
+#pragma once
+
+#include "GameState.hpp"
+#include "HandAnalysis.hpp"
+#include "Random.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+namespace sevens {
+
+/**
+ * Built-in policies as plain functors over the compact state, for Simulator<Policies...>.
+ *
+ *   uint64_t operator()(const GameState& state, uint64_t playable, URBG& rng)
+ *
+ * returns the bit of the chosen card among `playable` (legal moves of state.current),
+ * or 0 to pass. No virtual call and no container: a rollout loop inlines completely.
+ *
+ * The strategy libraries reuse policy::Neighbour: MySmartStrategy plays it, TableStrategy and
+ * NeuralStrategy fall back to it without a table or a network.
+ */
+namespace policy {
+
+// Uniform among playable cards (same draw as randomPick of the batch simulator)
+struct Random {
+    template <class URBG>
+    uint64_t operator()(const GameState&, uint64_t playable, URBG& rng) const {
+        if (!playable) {
+            return 0;
+        }
+        uint64_t k = (static_cast<uint64_t>(random32(rng)) * cardCount(playable)) >> 32;
+        for (; k; --k) {
+            playable &= playable - 1;
+        }
+        return playable & (0 - playable);
+    }
+};
+
+// Highest playable rank, Aces excluded like GreedyStrategy, lowest suit on ties (same as greedyPick)
+struct GreedyHighest {
+    template <class URBG>
+    uint64_t operator()(const GameState&, uint64_t playable, URBG&) const {
+        const uint64_t ranks = (playable | playable >> 16 | playable >> 32 | playable >> 48) & (kSuitMask & ~1ULL);
+        if (!ranks) {
+            return 0;
+        }
+        const uint64_t rank = 63 - static_cast<uint64_t>(__builtin_clzll(ranks));
+        const uint64_t candidates = playable & suitLanes(1ULL << rank);
+        return candidates & (0 - candidates);
+    }
+};
+
+/**
+ * MySmartStrategy's heuristic: rankWeight * rank + chainBonus * cards of my hand this play unlocks
+ * - exposePenalty * unknown cards it makes playable for the opponents.
+ * Best score wins, lowest card index on ties (the order of the hand vector).
+ */
+struct Neighbour {
+    double rankWeight = 1;
+    double chainBonus = 5;
+    double exposePenalty = 2;
+
+    uint64_t pick(uint64_t hand, uint64_t table, uint64_t playable) const {
+        uint64_t best = 0;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (uint64_t rest = playable; rest; rest &= rest - 1) {
+            const uint64_t card = lowestCard(rest);
+            const CardFeatures features = analyzeCard(hand, table, card);
+            const double score = rankWeight * static_cast<double>(card % kSuitStride) + chainBonus * features.chain -
+                                 exposePenalty * features.exposed;
+            if (score > bestScore) {
+                bestScore = score;
+                best = 1ULL << card;
+            }
+        }
+        return best;
+    }
+
+    template <class URBG>
+    uint64_t operator()(const GameState& state, uint64_t playable, URBG&) const {
+        return pick(state.hands[state.current], state.table, playable);
+    }
+};
+
+/**
+ * `Base` with noise: a uniform playable card with probability randomShare / 2^32, else Base's choice.
+ * Gives sampled continuations from a position where Base alone would always play the same line.
+ */
+template <class Base>
+struct Explore {
+    Base base;
+    uint32_t randomShare = 1u << 28; // un coup sur 16 au hasard
+
+    template <class URBG>
+    uint64_t operator()(const GameState& state, uint64_t playable, URBG& rng) const {
+        if (random32(rng) < randomShare) {
+            return Random{}(state, playable, rng);
+        }
+        return base(state, playable, rng);
+    }
+};
+
+} // namespace policy
+
+/**
+ * Sevens simulator with one policy type per seat, fixed at compile time:
+ * Simulator<policy::Random, policy::GreedyHighest, policy::GreedyHighest> plays 3 players.
+ * The seat loop is unrolled and every policy call is a direct, inlineable call.
+ *
+ * Same rules as GameState::apply(), and as Engine a round ends once stallLimit turns in a row
+ * pass without a card played (counted from the start of a rollout; 0 = no limit). With
+ * XorShift64 seeded by batchGameSeed and Random / GreedyHighest seats, play() replays
+ * BatchSimulator::playReference exactly.
+ */
+template <class... Policies>
+class Simulator {
+public:
+    static constexpr uint64_t kPlayers = sizeof...(Policies);
+    static_assert(kPlayers >= kMinPlayers && kPlayers <= kMaxPlayers, "Sevens is played by 3 to 7 players");
+
+    Simulator() = default;
+    explicit Simulator(Policies... policies) : policies(std::move(policies)...) {}
+
+    void setStallLimit(uint64_t value) { stallLimit = value; }
+
+    // Plays `state` until the end of its round (from any position, e.g. a search node), stalled or not; no scoring
+    template <class URBG>
+    void rollout(GameState& state, URBG& rng) const {
+        if (state.isTerminal()) {
+            return;
+        }
+        // On finit le tour entamé, puis on enchaîne des tours complets déroulés siège par siège
+        bool roundOver = false;
+        uint64_t idleTurns = 0;
+        for (uint64_t seat = state.current; seat < kPlayers && !roundOver; ++seat) {
+            roundOver = dispatchTurn(state, seat, idleTurns, rng);
+        }
+        while (!roundOver) {
+            forEachPlayer([&](auto p) {
+                if (!roundOver) {
+                    roundOver = turn<decltype(p)::value>(state, idleTurns, rng);
+                }
+            });
+        }
+    }
+
+    // Penalty points of every player after a rollout of `state` (the state itself is left untouched)
+    template <class URBG>
+    std::array<uint64_t, kMaxPlayers> rolloutScores(GameState state, URBG& rng) const {
+        rollout(state, rng);
+        return state.scores();
+    }
+
+    // Plays a whole game (rounds until someone reaches kEndScore); returns the final points
+    template <class URBG>
+    std::array<uint16_t, kMaxPlayers> play(uint64_t deck, URBG& rng, uint64_t* rounds = nullptr) const {
+        GameState state;
+        state.reset(kPlayers);
+        uint64_t played = 0;
+        while (!state.isGameOver()) {
+            state.deal(deck, rng);
+            rollout(state, rng);
+            state.settleRound();
+            ++played;
+        }
+        if (rounds) {
+            *rounds = played;
+        }
+        return state.points;
+    }
+
+    template <uint64_t Seat>
+    auto& get() { return std::get<Seat>(policies); }
+
+private:
+    template <class F, size_t... I>
+    static void forEachPlayerImpl(F&& f, std::index_sequence<I...>) {
+        (f(std::integral_constant<size_t, I>{}), ...);
+    }
+
+    template <class F>
+    static void forEachPlayer(F&& f) {
+        forEachPlayerImpl(std::forward<F>(f), std::make_index_sequence<kPlayers>{});
+    }
+
+    // One turn of seat P; true if the round is over (P has just emptied their hand, or it stalled)
+    template <size_t P, class URBG>
+    bool turn(GameState& state, uint64_t& idleTurns, URBG& rng) const {
+        const uint64_t chosen = std::get<P>(policies)(state, playableMask(state.hands[P], state.table), rng);
+        state.hands[P] &= ~chosen;
+        state.table |= chosen;
+        state.current = static_cast<uint8_t>(P + 1 == kPlayers ? 0 : P + 1);
+        idleTurns = chosen ? 0 : idleTurns + 1;
+        return state.hands[P] == 0 || (stallLimit && idleTurns >= stallLimit);
+    }
+
+    // Same as turn<P>() for a seat known only at run time (first, partial cycle of a rollout)
+    template <class URBG>
+    bool dispatchTurn(GameState& state, uint64_t seat, uint64_t& idleTurns, URBG& rng) const {
+        bool roundOver = false;
+        forEachPlayer([&](auto p) {
+            if (p == seat) {
+                roundOver = turn<decltype(p)::value>(state, idleTurns, rng);
+            }
+        });
+        return roundOver;
+    }
+
+    std::tuple<Policies...> policies;
+    uint64_t stallLimit = kDefaultStallLimit;
+};
+
+} // namespace sevens
@@ -1,4 +1,7 @@
 #include "StrategyLoader.hpp"
+#include <cstdio>
+#include <map>
+#include <mutex>
 
 #ifdef _WIN32 // Si Windows (32 ou 64 bits)
 #include <windows.h>
@@ -13,7 +16,17 @@ namespace sevens {
 // This must match the signature of the function exported by the strategy libraries
 typedef PlayerStrategy* (*CreateStrategyFunc)();
 
-std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::string& libraryPath) {
+namespace {
+
+// Bibliothèques chargées par open(), par adresse de chargement (pour pathAt, p. ex. le profileur).
+// dlopen() d'un même fichier rend le même mapping : on compte les StrategyLibrary qui le partagent
+std::mutex registryMutex;
+std::map<const void*, std::pair<std::string, uint64_t>> registry;
+
+} // namespace
+
+std::shared_ptr<StrategyLibrary> StrategyLibrary::open(const std::string& libraryPath, bool removeOnUnload,
+                                                        const std::string& sourcePath) {
 
     void* handle = nullptr;
     void* proc = nullptr;
@@ -35,10 +48,6 @@ std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::strin
             std::cerr << "Error finding symbol 'createStrategy' in library: " << libraryPath << " - " << GetLastError() << std::endl;
             throw std::runtime_error("[StrategyLoader] Failed to find symbol 'createStrategy' in library: " + libraryPath);
         }
-
-        // Cast the FARPROC to void* first, then reinterpret_cast to the function pointer type.
-        // This two-step process can sometimes satisfy very strict compilers.
-        auto createFunc = reinterpret_cast<CreateStrategyFunc>(proc); //(static_cast<void*>(proc)); // Two-step cast attempt
     #else 
         // macOS/Linux: Charger la bibliothèque partagée
         // Load the shared object (SO)
@@ -56,31 +65,100 @@ std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::strin
             std::cerr << "Error finding symbol 'createStrategy' in library: " << libraryPath << " - " << dlerror() << std::endl;
             throw std::runtime_error("[StrategyLoader] Failed to find symbol 'createStrategy' in library: " + libraryPath);
         }
-
-        // Cast the function pointer to the correct type
-        // dlsym returns void*, which can be directly cast to the function pointer type
-        auto createFunc = reinterpret_cast<CreateStrategyFunc>(proc);
     #endif 
 
-//     // Create Strategy 
-//     PlayerStrategy* rawStrategy = createFunc();
-//     return std::shared_ptr<PlayerStrategy>(rawStrategy);
-// }
-        // Call the function to create an instance of the strategy
-        PlayerStrategy* strategyInstance = createFunc();
-
-        // Return a shared_ptr to manage the lifetime of the strategy instance
-        // We use a custom deleter to ensure the library is unloaded when the strategy is no longer needed
-        return std::shared_ptr<PlayerStrategy>(strategyInstance, [handle](PlayerStrategy* ptr) {
-            // Delete the strategy instance
-            delete ptr;
-            // Unload the library
+    // Adresse de chargement : le HMODULE sous Windows, la base du mapping donnée par dladdr ailleurs
+    const void* base = handle;
+    #ifndef _WIN32
+        Dl_info info;
+        if (dladdr(proc, &info) && info.dli_fbase) {
+            base = info.dli_fbase;
+        }
+    #endif
+
+    std::shared_ptr<StrategyLibrary> library(new StrategyLibrary());
+    library->handle = handle;
+    // Cast the function pointer to the correct type
+    // dlsym returns void*, which can be directly cast to the function pointer type
+    library->createFunc = reinterpret_cast<CreateStrategyFunc>(proc);
+    library->path = libraryPath;
+    library->removeOnUnload = removeOnUnload;
+    library->base = base;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto& entry = registry[base];
+        entry.first = sourcePath.empty() ? libraryPath : sourcePath;
+        ++entry.second;
+    }
+    return library;
+}
+
+
+StrategyLibrary::~StrategyLibrary() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        const auto entry = registry.find(base);
+        if (entry != registry.end() && --entry->second.second == 0) {
+            registry.erase(entry);
+        }
+    }
+    // Unload the library
     #ifdef _WIN32
-            FreeLibrary(static_cast<HMODULE>(handle));
+        FreeLibrary(static_cast<HMODULE>(handle));
     #else
-            dlclose(handle);
+        dlclose(handle);
     #endif
-        });
+    if (removeOnUnload) {
+        std::remove(path.c_str());
     }
+}
+
+
+std::shared_ptr<PlayerStrategy> StrategyLibrary::create() {
+    // Call the function to create an instance of the strategy
+    PlayerStrategy* strategyInstance = createFunc();
+
+    // Return a shared_ptr to manage the lifetime of the strategy instance
+    // The deleter keeps a reference to the library: it is unloaded only when no strategy needs it anymore
+    auto self = shared_from_this();
+    return std::shared_ptr<PlayerStrategy>(strategyInstance, [self](PlayerStrategy* ptr) {
+        // Delete the strategy instance
+        delete ptr;
+    });
+}
+
+
+void* StrategyLibrary::findSymbol(const std::string& name) const {
+    #ifdef _WIN32
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle), name.c_str()));
+    #else
+        return dlsym(handle, name.c_str());
+    #endif
+}
+
+
+std::string StrategyLibrary::pathAt(const void* address) {
+    const void* base = nullptr;
+    #ifdef _WIN32
+        HMODULE module = nullptr;
+        if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                               static_cast<LPCSTR>(address), &module)) {
+            base = module;
+        }
+    #else
+        Dl_info info;
+        if (dladdr(address, &info)) {
+            base = info.dli_fbase;
+        }
+    #endif
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const auto found = registry.find(base);
+    return found == registry.end() ? std::string() : found->second.first;
+}
+
+
+std::shared_ptr<PlayerStrategy> StrategyLoader::loadFromLibrary(const std::string& libraryPath) {
+    return StrategyLibrary::open(libraryPath)->create();
+}
 
-} // namespace sevens
\ No newline at end of file
+} // namespace sevens
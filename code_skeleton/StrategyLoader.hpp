@@ -15,6 +15,48 @@
 
 namespace sevens {
 
+/**
+ * One loaded strategy library (DLL on Windows, .so on Linux/macOS).
+ * Every strategy created from it holds a reference, so the library is only
+ * unloaded once the last of its strategies has been destroyed.
+ */
+class StrategyLibrary : public std::enable_shared_from_this<StrategyLibrary> {
+public:
+    /**
+     * Loads the library and resolves its `createStrategy` factory.
+     * @param libraryPath The path to the shared library.
+     * @param removeOnUnload Delete the file when the library is unloaded (private copies).
+     * @param sourcePath The file a private copy was made from, reported by pathAt() (default: libraryPath).
+     * @throws std::runtime_error if the library or the strategy function cannot be loaded.
+     */
+    static std::shared_ptr<StrategyLibrary> open(const std::string& libraryPath, bool removeOnUnload = false,
+                                                 const std::string& sourcePath = "");
+
+    ~StrategyLibrary();
+    StrategyLibrary(const StrategyLibrary&) = delete;
+    StrategyLibrary& operator=(const StrategyLibrary&) = delete;
+
+    // Creates a new strategy instance; it keeps this library loaded
+    std::shared_ptr<PlayerStrategy> create();
+
+    // Optional exported symbol, nullptr if the library does not provide it
+    void* findSymbol(const std::string& name) const;
+
+    const std::string& getPath() const { return path; }
+
+    // Source path of the loaded library containing `address` (code or data), "" if it was not loaded by open()
+    static std::string pathAt(const void* address);
+
+private:
+    StrategyLibrary() = default;
+
+    void* handle = nullptr;
+    CreateStrategyFn createFunc = nullptr;
+    std::string path;
+    bool removeOnUnload = false;
+    const void* base = nullptr; // adresse de chargement, clé du registre de pathAt()
+};
+
 /**
  * Utility class for loading player strategies from shared libraries.
  */
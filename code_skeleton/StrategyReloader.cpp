@@ -0,0 +1,165 @@
+#include "StrategyReloader.hpp"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace sevens {
+
+namespace fs = std::filesystem;
+
+StrategyReloader::StrategyReloader(const std::vector<std::string>& libraryPaths, bool watch) : watching(watch) {
+    for (const auto& path : libraryPaths) {
+        bool known = false;
+        for (const auto& entry : entries) {
+            known |= entry.path == path;
+        }
+        if (!known) {
+            Entry entry;
+            entry.path = path;
+            entry.library = load(path, 0);
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    if (watching) {
+#ifdef __linux__
+        watcher = std::thread(&StrategyReloader::watchLoop, this);
+#else
+        std::cerr << "[StrategyReloader] Hot reload is only available on Linux, libraries will not be watched.\n";
+        watching = false;
+#endif
+    }
+}
+
+StrategyReloader::~StrategyReloader() {
+    stopping = true;
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+size_t StrategyReloader::indexOf(const std::string& libraryPath) const {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].path == libraryPath) {
+            return i;
+        }
+    }
+    throw std::runtime_error("[StrategyReloader] Unknown library: " + libraryPath);
+}
+
+std::shared_ptr<StrategyLibrary> StrategyReloader::current(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.at(index).library;
+}
+
+uint64_t StrategyReloader::generation(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.at(index).generation;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<StrategyLibrary> StrategyReloader::load(const std::string& path, uint64_t generation) const {
+    if (!watching) {
+        return StrategyLibrary::open(path);
+    }
+    // Copie privée : dlopen() rendrait l'ancien handle pour un chemin déjà chargé,
+    // et un fichier réécrit en place pendant qu'il est mappé peut faire planter le processus
+    const fs::path source(path);
+    const fs::path copy = fs::temp_directory_path() /
+        (source.stem().string() + ".v" + std::to_string(generation) + "." +
+         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + source.extension().string());
+    fs::copy_file(source, copy, fs::copy_options::overwrite_existing);
+    try {
+        return StrategyLibrary::open(copy.string(), true, path);
+    } catch (...) {
+        fs::remove(copy);
+        throw;
+    }
+}
+
+void StrategyReloader::reload(size_t index) {
+    const uint64_t nextGeneration = generation(index) + 1;
+    try {
+        auto library = load(entries[index].path, nextGeneration);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries[index].library = std::move(library);
+            entries[index].generation = nextGeneration;
+        }
+        ++reloads;
+        std::cout << "[StrategyReloader] Reloaded " << entries[index].path << " (version " << nextGeneration << ")\n";
+    } catch (const std::exception& e) {
+        // Fichier incomplet ou invalide : on garde l'ancienne version
+        std::cerr << "[StrategyReloader] Reload of " << entries[index].path << " failed, keeping the previous version: " << e.what() << "\n";
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void StrategyReloader::watchLoop() {
+#ifdef __linux__
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[StrategyReloader] inotify_init1 failed, libraries will not be watched.\n";
+        return;
+    }
+
+    // On surveille les répertoires : un build remplace souvent le fichier par un rename()
+    std::map<int, std::string> directories;
+    for (const auto& entry : entries) {
+        const fs::path parent = fs::absolute(entry.path).lexically_normal().parent_path();
+        int wd = inotify_add_watch(fd, parent.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd >= 0) {
+            directories[wd] = parent.string();
+        }
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto settleDelay = std::chrono::milliseconds(300); // laisse le linker finir d'écrire
+    std::vector<Clock::time_point> pending(entries.size(), Clock::time_point::max());
+    alignas(inotify_event) char buffer[4096];
+
+    while (!stopping) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) > 0) {
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* cursor = buffer; cursor < buffer + length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+                    cursor += sizeof(inotify_event) + event->len;
+                    if (event->len == 0 || !directories.count(event->wd)) {
+                        continue;
+                    }
+                    const fs::path changed = fs::path(directories[event->wd]) / event->name;
+                    for (size_t i = 0; i < entries.size(); ++i) {
+                        if (fs::absolute(entries[i].path).lexically_normal() == changed) {
+                            pending[i] = Clock::now();
+                        }
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (pending[i] != Clock::time_point::max() && Clock::now() - pending[i] >= settleDelay) {
+                pending[i] = Clock::time_point::max();
+                reload(i);
+            }
+        }
+    }
+    close(fd);
+#endif
+}
+
+} // namespace sevens
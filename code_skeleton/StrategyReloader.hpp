@@ -0,0 +1,64 @@
+#pragma once
+
+#include "StrategyLoader.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Keeps the current version of a set of strategy libraries.
+ *
+ * With watching enabled, a background thread follows the library files
+ * (inotify on Linux). When one is rebuilt, a private copy of the new file is
+ * loaded side by side with the old version and published as the current one.
+ * Callers pick it up at their next game boundary through current(); the old
+ * version stays loaded until the last strategy created from it is destroyed.
+ */
+class StrategyReloader {
+public:
+    /**
+     * @param libraryPaths Libraries to load (duplicates are loaded once).
+     * @param watch Reload the libraries when their file changes.
+     * @throws std::runtime_error if a library cannot be loaded.
+     */
+    StrategyReloader(const std::vector<std::string>& libraryPaths, bool watch);
+    ~StrategyReloader();
+
+    StrategyReloader(const StrategyReloader&) = delete;
+    StrategyReloader& operator=(const StrategyReloader&) = delete;
+
+    // Index of `libraryPath` in the set
+    size_t indexOf(const std::string& libraryPath) const;
+
+    // Current version of library `index` and its generation (incremented at every reload)
+    std::shared_ptr<StrategyLibrary> current(size_t index) const;
+    uint64_t generation(size_t index) const;
+
+    uint64_t getReloadCount() const { return reloads.load(); }
+
+private:
+    struct Entry {
+        std::string path;
+        std::shared_ptr<StrategyLibrary> library;
+        uint64_t generation = 0;
+    };
+
+    std::shared_ptr<StrategyLibrary> load(const std::string& path, uint64_t generation) const;
+    void reload(size_t index);
+    void watchLoop();
+
+    std::vector<Entry> entries;
+    mutable std::mutex mutex;
+    bool watching = false;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> reloads{0};
+    std::thread watcher;
+};
+
+} // namespace sevens
@@ -0,0 +1,139 @@
+#include "PlayerStrategy.hpp"
+#include "HandAnalysis.hpp"
+#include "PolicyTable.hpp"
+#include "Simulator.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Looks its decisions up in a precomputed policy table ("./sevens_game policytable build"),
+ * and falls back to MySmartStrategy's heuristic on states the table does not hold, or in
+ * games whose number of players is not the table's. The table is mapped once per process,
+ * when the first instance is created.
+ *
+ * The number of players is exact at every turn, so a decision still depends only on the
+ * hand and the table within a game: on our first turn only the seats before ours have
+ * moved and the size of our deal gives it (it differs for every player count at a given
+ * seat), and by our next turn every other seat has moved.
+ */
+class TableStrategy : public PlayerStrategy {
+public:
+    explicit TableStrategy(std::shared_ptr<const PolicyTable> table) : table(std::move(table)) {}
+
+    ~TableStrategy() override = default;
+
+    void initialize(uint64_t playerID) override {
+        myID = playerID;
+        seatsSeen = playerID + 1;
+        observed = 0;
+    }
+
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override
+    {
+        if (hand.empty()) {
+            return -1;
+        }
+        const uint64_t handBits = handMask(hand);
+        const uint64_t tableBits = tableMask(tableLayout);
+        const uint64_t playableBits = playableMask(handBits, tableBits);
+        if (!playableBits) {
+            return -1;
+        }
+
+        // Table d'abord (une seule sonde en moyenne), heuristique sinon
+        uint64_t chosen = 0;
+        if (table && cardCount(playableBits) >= 2 && players(hand.size()) == table->getPlayers()) {
+            const int64_t advised = table->lookup(handBits, tableBits);
+            if (advised >= 0) {
+                chosen = playableBits & (1ULL << advised);
+            }
+        }
+        if (!chosen) {
+            chosen = heuristic.pick(handBits, tableBits, playableBits);
+        }
+
+        for (size_t i = 0; i < hand.size(); ++i) {
+            const Card& card = hand[i];
+            if (card.suit < kNumSuits && card.rank < kNumRanks && cardBit(card.suit, card.rank) == chosen) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        (void)playedCard;
+        observe(playerID);
+    }
+
+    void observePass(uint64_t playerID) override {
+        observe(playerID);
+    }
+
+    std::string getName() const override {
+        return "TableStrategy";
+    }
+
+private:
+    void observe(uint64_t playerID) {
+        seatsSeen = std::max(seatsSeen, playerID + 1);
+        ++observed;
+    }
+
+    // Nombre de joueurs de la partie (0 si inconnu)
+    uint64_t players(uint64_t handSize) const {
+        if (observed > myID) {
+            return seatsSeen;
+        }
+        // Premier tour : seuls les sièges 0..myID-1 ont joué, la main est encore la donne
+        for (uint64_t n = std::max(kMinPlayers, myID + 1); n <= kMaxPlayers; ++n) {
+            if (kNumSuits * kNumRanks / n + (myID < kNumSuits * kNumRanks % n) == handSize) {
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    std::shared_ptr<const PolicyTable> table;
+    policy::Neighbour heuristic;
+    uint64_t myID = 0;
+    uint64_t seatsSeen = 1; // plus grand siège observé + 1
+    uint64_t observed = 0;  // coups et passes observés depuis le début de la partie
+};
+
+// Table partagée par toutes les instances : $SEVENS_POLICY_TABLE, sinon policy_table.bin du répertoire courant
+inline std::shared_ptr<const PolicyTable> sharedPolicyTable() {
+    static const std::shared_ptr<const PolicyTable> table = []() -> std::shared_ptr<const PolicyTable> {
+        const char* env = std::getenv("SEVENS_POLICY_TABLE");
+        const std::string path = env && *env ? env : "policy_table.bin";
+        try {
+            return std::make_shared<const PolicyTable>(path);
+        } catch (const std::exception& e) {
+            std::cerr << "[TableStrategy] " << e.what() << ", using the heuristic only.\n";
+            return nullptr;
+        }
+    }();
+    return table;
+}
+
+#ifdef BUILD_SHARED_LIB
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::TableStrategy(sharedPolicyTable());
+}
+
+// Table et heuristique ne regardent que la main et la table : décisions réutilisables
+extern "C" uint64_t strategyIsDeterministic() {
+    return 1;
+}
+#endif
+
+} // namespace sevens
@@ -0,0 +1,506 @@
+#include "Tournament.hpp"
+#include "Checkpoint.hpp"
+#include "CommandLine.hpp"
+#include "CoroutineEngine.hpp"
+#include "Profiler.hpp"
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace sevens {
+
+void SeatStats::add(const GameOutcome& outcome, uint64_t seat) {
+    ++games;
+    wins += outcome.rank[seat] == 1;
+    lastPlaces += outcome.rank[seat] == outcome.numPlayers;
+    rankSum += outcome.rank[seat];
+    points += outcome.points[seat];
+}
+
+void SeatStats::merge(const SeatStats& other) {
+    if (name.empty()) {
+        name = other.name;
+    }
+    games += other.games;
+    wins += other.wins;
+    lastPlaces += other.lastPlaces;
+    rankSum += other.rankSum;
+    points += other.points;
+    usage.merge(other.usage);
+}
+
+void TournamentResults::merge(const TournamentResults& other) {
+    if (seats.size() < other.seats.size()) {
+        seats.resize(other.seats.size());
+    }
+    for (size_t seat = 0; seat < other.seats.size(); ++seat) {
+        seats[seat].merge(other.seats[seat]);
+    }
+    games += other.games;
+    rounds += other.rounds;
+    stalledRounds += other.stalledRounds;
+    skippedCalls += other.skippedCalls;
+    memo.merge(other.memo);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+Tournament::Tournament(const TournamentOptions& options)
+    : options(options), reloader(options.libraries, options.watch) {
+    if (options.libraries.size() < kMinPlayers || options.libraries.size() > kMaxPlayers) {
+        throw std::runtime_error("[Tournament] Number of players must be between 3 and 7.");
+    }
+    // Avant d'ouvrir quoi que ce soit : GameLogWriter tronque le journal existant
+    if (!options.checkpoint.empty() && options.resume && !options.record.empty()) {
+        throw std::runtime_error("[Tournament] A game log cannot be resumed: run --resume without --record.");
+    }
+    for (const auto& path : options.libraries) {
+        seatLibrary.push_back(reloader.indexOf(path));
+    }
+    if (!options.store.empty()) {
+        store = std::make_unique<ResultsWriter>(options.store);
+    }
+    if (!options.record.empty()) {
+        gameLog = std::make_unique<GameLogWriter>(options.record, options.rules);
+    }
+    if (this->options.workers == 0) {
+        this->options.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+#ifndef SEVENS_HAS_COROUTINES
+    if (this->options.inFlight > 0) {
+        std::cerr << "[Tournament] Built without C++20 coroutines, playing one game at a time per worker.\n";
+        this->options.inFlight = 0;
+    }
+#endif
+    if ((gameLog || !options.checkpoint.empty()) && this->options.inFlight > 0) {
+        std::cerr << "[Tournament] --record and --checkpoint only apply to games played one at a time, playing without --in-flight.\n";
+        this->options.inFlight = 0;
+    }
+    if (!options.checkpoint.empty()) {
+        // Blocs assez petits pour perdre peu en cas d'arrêt, assez gros pour ne pas encombrer l'instantané
+        blockSize = std::max<uint64_t>(1, std::min<uint64_t>(256, options.games / (this->options.workers * 64)));
+        checkpoint = std::make_unique<TournamentCheckpoint>(options.checkpoint, options, blockSize);
+        if (options.resume) {
+            if (checkpoint->load()) {
+                blockSize = checkpoint->getBlockSize();
+                resumedBlocks = checkpoint->getCompleted();
+                resumedGames = checkpoint->getResults().games;
+                if (store) {
+                    std::cerr << "[Tournament] Resuming with --store: games played after the last snapshot are stored twice.\n";
+                }
+            } else {
+                std::cerr << "[Tournament] No checkpoint in " << options.checkpoint << " yet, starting from the first game.\n";
+            }
+        }
+    }
+    if (this->options.memoize && this->options.inFlight > 0) {
+        std::cerr << "[Tournament] --memoize only applies to games played one at a time, ignored with --in-flight.\n";
+    }
+}
+
+Tournament::~Tournament() = default;
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+Tournament::LineUp::LineUp(uint64_t numPlayers)
+    : libraries(numPlayers), strategies(numPlayers), accounted(numPlayers), seats(numPlayers, nullptr) {}
+
+// Les mesures d'une instance sont versées dans les statistiques du siège quand elle est remplacée
+void Tournament::LineUp::flushUsage(uint64_t seat, TournamentResults& local) {
+    if (accounted[seat]) {
+        local.seats[seat].usage.merge(accounted[seat]->getUsage());
+        accounted[seat]->resetUsage();
+    }
+}
+
+// Limite de partie : on passe à la dernière version publiée de chaque bibliothèque.
+// L'ancienne instance est détruite ici, et sa bibliothèque déchargée quand plus personne ne l'utilise.
+void Tournament::refresh(LineUp& lineUp, TournamentResults& local) {
+    for (uint64_t seat = 0; seat < lineUp.seats.size(); ++seat) {
+        auto library = reloader.current(seatLibrary[seat]);
+        if (library != lineUp.libraries[seat]) {
+            lineUp.flushUsage(seat, local);
+            if (lineUp.memo.cache) {
+                // Une bibliothèque rechargée peut répondre autrement (et réutiliser l'adresse d'une ancienne)
+                lineUp.memo.cache->clear();
+                const auto deterministic =
+                    reinterpret_cast<StrategyIsDeterministicFn>(library->findSymbol("strategyIsDeterministic"));
+                lineUp.memo.owner[seat] = deterministic && deterministic() ? reinterpret_cast<uintptr_t>(library.get()) : 0;
+            }
+            lineUp.strategies[seat] = library->create();
+            if (options.usage) {
+                lineUp.accounted[seat] = std::make_shared<AccountedStrategy>(lineUp.strategies[seat]);
+                lineUp.strategies[seat] = lineUp.accounted[seat];
+            }
+            if (options.metrics) {
+                const std::string label = lineUp.strategies[seat]->getName() + "-" + std::to_string(seat);
+                lineUp.strategies[seat] = std::make_shared<MeteredStrategy>(lineUp.strategies[seat], label);
+            }
+            lineUp.libraries[seat] = std::move(library);
+            lineUp.seats[seat] = lineUp.strategies[seat].get();
+            local.seats[seat].name = lineUp.strategies[seat]->getName();
+        }
+        // Nouvelle partie : état remis à zéro, le résultat ne dépend pas de la partie précédente du worker
+        lineUp.strategies[seat]->initialize(seat);
+    }
+}
+
+void Tournament::recordGame(const GameOutcome& outcome, uint64_t seed, TournamentResults& local,
+                            const std::vector<int8_t>* moves) {
+    for (uint64_t seat = 0; seat < local.seats.size(); ++seat) {
+        local.seats[seat].add(outcome, seat);
+    }
+    ++local.games;
+    local.rounds += outcome.rounds;
+    local.stalledRounds += outcome.stalledRounds;
+    local.skippedCalls += outcome.skippedCalls;
+    if (options.metrics) {
+        // Tours joués sans appeler la stratégie : MeteredStrategy ne les voit pas, le moteur les compte
+        metrics::GameMetrics& shared = metrics::gameMetrics();
+        shared.games.add();
+        shared.moves.add(outcome.skippedCalls + outcome.cachedCalls);
+        shared.passes.add(outcome.uncalledPasses);
+    }
+
+    if (store) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        GameRecord record;
+        record.seed = seed;
+        record.numPlayers = outcome.numPlayers;
+        record.rounds = outcome.rounds;
+        record.rank = outcome.rank;
+        record.points = outcome.points;
+        for (uint64_t seat = 0; seat < local.seats.size(); ++seat) {
+            record.strategy[seat] = store->strategyId(local.seats[seat].name);
+        }
+        store->append(record);
+    }
+
+    if (gameLog && moves) {
+        LoggedGame logged;
+        logged.seed = seed;
+        logged.numPlayers = outcome.numPlayers;
+        logged.rounds = outcome.rounds;
+        logged.points = outcome.points;
+        logged.moves = *moves;
+        std::lock_guard<std::mutex> lock(gameLogMutex);
+        for (uint64_t seat = 0; seat < local.seats.size(); ++seat) {
+            logged.strategy[seat] = gameLog->strategyId(local.seats[seat].name);
+        }
+        gameLog->append(logged);
+    }
+}
+
+void Tournament::worker(TournamentResults& local) {
+#ifdef SEVENS_HAS_COROUTINES
+    if (options.inFlight > 0) {
+        coroutineWorker(local);
+        return;
+    }
+#endif
+
+    const uint64_t numPlayers = options.libraries.size();
+    LineUp lineUp(numPlayers);
+    local.seats.resize(numPlayers);
+    std::unique_ptr<DecisionCache> cache;
+    if (options.memoize) {
+        cache = std::make_unique<DecisionCache>();
+        lineUp.memo.cache = cache.get();
+    }
+    std::vector<int8_t> moves;
+    std::vector<int8_t>* recording = gameLog ? &moves : nullptr;
+
+    // Avec un point de reprise, chaque bloc a ses propres résultats, remis au checkpoint une fois complet
+    const uint64_t blockCount = (options.games + blockSize - 1) / blockSize;
+    TournamentResults block;
+    for (uint64_t b = nextBlock++; b < blockCount && !failed; b = nextBlock++) {
+        if (b < resumedBlocks.size() && resumedBlocks[b]) {
+            continue;
+        }
+        TournamentResults& target = checkpoint ? block : local;
+        target.seats.resize(numPlayers);
+        const uint64_t end = std::min(options.games, (b + 1) * blockSize);
+        for (uint64_t game = b * blockSize; game < end; ++game) {
+            refresh(lineUp, target);
+            const uint64_t seed = gameSeed(options.seed, options.firstGame + game);
+            Xoshiro256 rng(seed);
+            moves.clear();
+            recordGame(playGame(lineUp.seats, kFullDeck, rng, options.rules, lineUp.memo, recording), seed, target,
+                       recording);
+        }
+        if (checkpoint) {
+            for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+                lineUp.flushUsage(seat, block);
+                block.seats[seat].name = lineUp.strategies[seat]->getName();
+            }
+            checkpoint->complete(b, std::move(block));
+            block = TournamentResults{};
+        }
+    }
+    if (cache) {
+        local.memo.merge(cache->getStats());
+    }
+
+    for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+        lineUp.flushUsage(seat, local);
+    }
+}
+
+#ifdef SEVENS_HAS_COROUTINES
+
+void Tournament::coroutineWorker(TournamentResults& local) {
+    const uint64_t numPlayers = options.libraries.size();
+    std::vector<LineUp> lineUps(options.inFlight, LineUp(numPlayers));
+    local.seats.resize(numPlayers);
+    GameScheduler scheduler;
+
+    // Chaque slot enchaîne ses parties : quand l'une se termine, le slot tire l'indice suivant
+    std::function<void(size_t)> startNext = [&](size_t slot) {
+        const uint64_t game = nextGame++;
+        if (game >= options.games || failed) {
+            return;
+        }
+        refresh(lineUps[slot], local);
+        const uint64_t seed = gameSeed(options.seed, options.firstGame + game);
+        Xoshiro256 rng(seed);
+        scheduler.spawn(playGameAsync(scheduler, lineUps[slot].seats, kFullDeck, rng, options.rules),
+                        [&, slot, seed](const GameOutcome& outcome) {
+                            recordGame(outcome, seed, local);
+                            startNext(slot);
+                        });
+    };
+    for (size_t slot = 0; slot < lineUps.size(); ++slot) {
+        startNext(slot);
+    }
+    scheduler.run();
+
+    for (LineUp& lineUp : lineUps) {
+        for (uint64_t seat = 0; seat < numPlayers; ++seat) {
+            lineUp.flushUsage(seat, local);
+        }
+    }
+}
+
+#endif // SEVENS_HAS_COROUTINES
+
+TournamentResults Tournament::run() {
+    nextGame = 0;
+    nextBlock = 0;
+    failed = false;
+    if (checkpoint) {
+        checkpoint->start(options.checkpointInterval);
+    }
+    std::vector<TournamentResults> partial(options.workers);
+    std::vector<std::thread> threads;
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    for (uint64_t w = 0; w < options.workers; ++w) {
+        threads.emplace_back([this, &partial, &failureMutex, &failure, w]() {
+            ProfiledThread sampled; // sans effet hors de "--profile"
+            metrics::Gauge* active = options.metrics ? &metrics::gameMetrics().activeWorkers : nullptr;
+            if (active) {
+                active->add(1);
+            }
+            try {
+                worker(partial[w]);
+            } catch (...) {
+                // Des résultats partiels passeraient pour complets : l'échec remonte à l'appelant
+                failed = true;
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+            if (active) {
+                active->add(-1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    TournamentResults results;
+    if (checkpoint) {
+        checkpoint->stop(); // dernier instantané : il couvre maintenant toutes les parties jouées
+        results.merge(checkpoint->getResults());
+    }
+    for (const auto& part : partial) {
+        results.merge(part);
+    }
+    if (store) {
+        store->flush();
+    }
+    if (gameLog) {
+        gameLog->flush();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return results;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void Tournament::printResults(const TournamentResults& results, double cpuBudgetMicros) {
+    std::cout << "[Tournament] Results after " << results.games << " games:\n";
+    std::cout << "  seat  strategy                    wins   win%   avg rank   last   avg points\n";
+    for (size_t seat = 0; seat < results.seats.size(); ++seat) {
+        const SeatStats& stats = results.seats[seat];
+        const double games = stats.games ? static_cast<double>(stats.games) : 1.0;
+        std::cout << "  " << std::setw(4) << seat << "  " << std::left << std::setw(26) << stats.name << std::right
+                  << std::setw(6) << stats.wins
+                  << std::setw(7) << std::fixed << std::setprecision(1) << 100.0 * stats.wins / games
+                  << std::setw(11) << std::setprecision(2) << stats.rankSum / games
+                  << std::setw(7) << stats.lastPlaces
+                  << std::setw(13) << std::setprecision(2) << stats.points / games << "\n";
+    }
+    if (results.stalledRounds > 0 || results.skippedCalls > 0) {
+        std::cout << "[Tournament] " << results.stalledRounds << " of " << results.rounds
+                  << " rounds stopped by the stall limit, " << results.skippedCalls
+                  << " forced moves played without calling a strategy\n";
+    }
+    if (results.memo.lookups > 0) {
+        std::cout << "[Tournament] Decision cache: " << results.memo.hits << " hits of " << results.memo.lookups
+                  << " lookups (" << std::setprecision(1) << 100.0 * results.memo.hits / results.memo.lookups
+                  << "%), about " << std::setprecision(3) << results.memo.savedSeconds() << " s of strategy calls saved\n";
+    }
+
+    bool measured = false;
+    for (const SeatStats& stats : results.seats) {
+        measured |= stats.usage.decisions > 0;
+    }
+    if (measured) {
+        std::cout << "[Tournament] Resource usage per strategy:\n";
+        printUsageHeader();
+        for (size_t seat = 0; seat < results.seats.size(); ++seat) {
+            const SeatStats& stats = results.seats[seat];
+            printUsageLine(stats.name + "-" + std::to_string(seat), stats.usage, cpuBudgetMicros);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runTournamentMode(int argc, char* argv[]) {
+    TournamentOptions options;
+    options.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.games)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.seed)) {
+                return 1;
+            }
+        } else if (arg == "--workers" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.workers)) {
+                return 1;
+            }
+        } else if (arg == "--watch") {
+            options.watch = true;
+        } else if (arg == "--usage") {
+            options.usage = true;
+        } else if (arg == "--store" && i + 1 < argc) {
+            options.store = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            options.record = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint = argv[++i];
+        } else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            if (!cli::parseReal("[tournament]", arg, argv[++i], options.checkpointInterval)) {
+                return 1;
+            }
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else if (arg == "--in-flight" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.inFlight)) {
+                return 1;
+            }
+        } else if (arg == "--stall-limit" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.rules.stallLimit)) {
+                return 1;
+            }
+        } else if (arg == "--fast-forward") {
+            options.rules.fastForward = true;
+        } else if (arg == "--memoize") {
+            options.memoize = true;
+        } else if (arg == "--metrics-listen" && i + 1 < argc) {
+            options.metrics = true;
+            options.metricsListen = argv[++i];
+        } else if (arg == "--metrics-json" && i + 1 < argc) {
+            options.metrics = true;
+            options.metricsJson = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            if (!cli::parseReal("[tournament]", arg, argv[++i], options.metricsInterval)) {
+                return 1;
+            }
+        } else if (arg == "--profile" && i + 1 < argc) {
+            options.profile = argv[++i];
+        } else if (arg == "--profile-hz" && i + 1 < argc) {
+            if (!cli::parseCount("[tournament]", arg, argv[++i], options.profileHz)) {
+                return 1;
+            }
+        } else if (arg == "--cpu-budget" && i + 1 < argc) {
+            options.usage = true;
+            if (!cli::parseReal("[tournament]", arg, argv[++i], options.cpuBudgetMicros)) {
+                return 1;
+            }
+        } else {
+            options.libraries.push_back(arg);
+        }
+    }
+
+    if (options.libraries.size() < kMinPlayers || options.libraries.size() > kMaxPlayers) {
+        std::cerr << "[main] Tournament mode requires between 3 and 7 strategy libraries.\n";
+        return 1;
+    }
+    if (options.resume && options.checkpoint.empty()) {
+        std::cerr << "[main] --resume needs the --checkpoint file of the run to continue.\n";
+        return 1;
+    }
+
+    try {
+        Tournament tournament(options);
+        std::unique_ptr<metrics::Exporter> exporter;
+        if (options.metrics) {
+            exporter = std::make_unique<metrics::Exporter>(options.metricsListen, options.metricsJson, options.metricsInterval);
+        }
+        std::unique_ptr<SamplingProfiler> profiler;
+        if (!options.profile.empty()) {
+            profiler = std::make_unique<SamplingProfiler>(options.profileHz);
+        }
+        std::cout << "[main] Tournament: " << options.games << " games, seed " << options.seed
+                  << (options.watch ? ", watching libraries for changes" : "")
+                  << (options.inFlight ? ", " + std::to_string(options.inFlight) + " games in flight per worker" : "")
+                  << (tournament.getResumedGames() ? ", resumed after " + std::to_string(tournament.getResumedGames()) + " games" : "")
+                  << "\n";
+        const auto start = std::chrono::steady_clock::now();
+        const TournamentResults results = tournament.run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Tournament::printResults(results, options.cpuBudgetMicros);
+        std::cout << "[Tournament] " << std::setprecision(0) << (results.games - tournament.getResumedGames()) / seconds
+                  << " games/s\n";
+        if (profiler) {
+            profiler->stop();
+            profiler->printSummary();
+            profiler->writeFolded(options.profile);
+            std::cout << "[Profiler] Folded stacks written to " << options.profile << " (flamegraph.pl, speedscope)\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[main] Tournament failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace sevens
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Engine.hpp"
+#include "GameLog.hpp"
+#include "Metrics.hpp"
+#include "ResourceUsage.hpp"
+#include "ResultsStore.hpp"
+#include "StrategyReloader.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+class TournamentCheckpoint;
+
+/**
+ * Settings of a multi-game tournament ("tournament" mode of sevens_game).
+ */
+struct TournamentOptions {
+    std::vector<std::string> libraries; // one strategy library per seat (3 to 7)
+    uint64_t games = 1000;
+    uint64_t seed = 0;                  // game i is played with gameSeed(seed, firstGame + i)
+    uint64_t firstGame = 0;             // > 0 when this run is one shard of a larger tournament
+    uint64_t workers = 0;               // 0 = one worker per core
+    bool watch = false;                 // hot-reload libraries when they are rebuilt
+    bool usage = false;                 // measure CPU time and allocations of every strategy call
+    double cpuBudgetMicros = 0;         // flag strategies slower than this per decision (0 = none)
+    uint64_t inFlight = 0;              // > 0: games interleaved per worker by the coroutine scheduler
+    std::string store;                  // results file every game is appended to (empty = none)
+    std::string record;                 // game log of every move, for the "analyze" mode (empty = none)
+    std::string checkpoint;             // snapshot file of the run in progress (see Checkpoint.hpp)
+    double checkpointInterval = 30;     // seconds between two snapshots
+    bool resume = false;                // continue the run saved in `checkpoint`
+    RoundRules rules;                   // stall limit and fast-forward of forced moves
+    bool memoize = false;               // cache the decisions of deterministic strategies (see DecisionCache.hpp)
+    bool metrics = false;               // record live metrics (see Metrics.hpp)
+    std::string metricsListen;          // Prometheus endpoint: TCP port on 127.0.0.1 or Unix socket path
+    std::string metricsJson;            // periodic JSON snapshot file
+    double metricsInterval = 5;         // seconds between two snapshots
+    std::string profile;                // folded stacks of the sampling profiler (see Profiler.hpp, empty = none)
+    uint64_t profileHz = 997;           // samples per second of CPU of every worker
+};
+
+/**
+ * Aggregated statistics of one seat. Only sums, so partial results merge exactly.
+ */
+struct SeatStats {
+    std::string name;
+    uint64_t games = 0;
+    uint64_t wins = 0;       // rank 1
+    uint64_t lastPlaces = 0;
+    uint64_t rankSum = 0;
+    uint64_t points = 0;
+    StrategyUsage usage;
+
+    void add(const GameOutcome& outcome, uint64_t seat);
+    void merge(const SeatStats& other);
+};
+
+struct TournamentResults {
+    std::vector<SeatStats> seats;
+    uint64_t games = 0;
+    uint64_t rounds = 0;
+    uint64_t stalledRounds = 0;
+    uint64_t skippedCalls = 0; // strategy calls saved by RoundRules::fastForward
+    DecisionCache::Stats memo;  // decision cache of the workers (--memoize)
+
+    void merge(const TournamentResults& other);
+};
+
+/**
+ * Plays a tournament on several worker threads. Every worker owns its own
+ * strategy instances (strategies are not thread-safe) and keeps them warm
+ * from one game to the next; they are only recreated when the reloader
+ * publishes a new version of their library, i.e. at a game boundary.
+ * Every game starts with initialize(): a strategy that seeds itself there
+ * plays the same game whichever worker (or shard) runs it.
+ *
+ * With inFlight > 0 (C++20 builds), each worker instead keeps that many games
+ * in flight on a GameScheduler, every game slot with its own strategy instances.
+ *
+ * With a checkpoint, games are handed out in blocks whose results go to the snapshot
+ * once complete; a resumed run skips the blocks already in it.
+ */
+class Tournament {
+public:
+    // @throws std::runtime_error on a bad line-up, or a checkpoint of another run.
+    explicit Tournament(const TournamentOptions& options);
+    ~Tournament();
+
+    // Plays every game; rethrows the first exception of a worker once all of them have stopped
+    TournamentResults run();
+
+    // Games already played by the run this one resumes (0 without --resume)
+    uint64_t getResumedGames() const { return resumedGames; }
+
+    static void printResults(const TournamentResults& results, double cpuBudgetMicros = 0);
+
+private:
+    // Strategy instances of one game slot, recreated when their library is reloaded
+    struct LineUp {
+        std::vector<std::shared_ptr<StrategyLibrary>> libraries;
+        std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+        std::vector<std::shared_ptr<AccountedStrategy>> accounted;
+        std::vector<PlayerStrategy*> seats;
+        DecisionMemo memo;
+
+        explicit LineUp(uint64_t numPlayers);
+        void flushUsage(uint64_t seat, TournamentResults& local);
+    };
+
+    void refresh(LineUp& lineUp, TournamentResults& local);
+    void recordGame(const GameOutcome& outcome, uint64_t seed, TournamentResults& local,
+                    const std::vector<int8_t>* moves = nullptr);
+    void worker(TournamentResults& local);
+    void coroutineWorker(TournamentResults& local);
+
+    TournamentOptions options;
+    StrategyReloader reloader;
+    std::vector<size_t> seatLibrary; // seat -> index in the reloader
+    std::atomic<uint64_t> nextGame{0};
+    std::atomic<uint64_t> nextBlock{0};
+    std::atomic<bool> failed{false};     // un worker a échoué : les autres s'arrêtent
+    uint64_t blockSize = 1;              // games per block handed to a worker
+    std::vector<uint8_t> resumedBlocks;  // blocks already played before --resume
+    uint64_t resumedGames = 0;
+    std::unique_ptr<TournamentCheckpoint> checkpoint;
+    std::unique_ptr<ResultsWriter> store;
+    std::mutex storeMutex;
+    std::unique_ptr<GameLogWriter> gameLog;
+    std::mutex gameLogMutex;
+};
+
+// Entry point of "./sevens_game tournament [--games N] [--seed S] [--workers W] [--watch]
+//                 [--usage] [--cpu-budget us] [--in-flight K] [--store file] [--record file] [--stall-limit T] [--fast-forward]
+//                 [--memoize] [--metrics-listen port|socket] [--metrics-json file] [--metrics-interval s]
+//                 [--checkpoint file] [--checkpoint-interval s] [--resume] [--profile file] [--profile-hz N]
+//                 lib1 lib2 lib3 ..."
+int runTournamentMode(int argc, char* argv[]);
+
+} // namespace sevens
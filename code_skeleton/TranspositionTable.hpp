@@ -0,0 +1,219 @@
+#pragma once
+
+#include "GameState.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace sevens {
+
+/**
+ * 64-bit key of a round position for search: every hand, the table and the player to move.
+ * The game score is left out, a round search does not depend on it.
+ */
+inline uint64_t stateHash(const GameState& state) {
+    uint64_t h = splitMix64(state.table ^ (static_cast<uint64_t>(state.current) << 56) ^
+                            (static_cast<uint64_t>(state.numPlayers) << 60));
+    for (uint64_t p = 0; p < state.numPlayers; ++p) {
+        h = splitMix64(h ^ (state.hands[p] + (p + 1) * 0x9E3779B97F4A7C15ULL));
+    }
+    return h;
+}
+
+/**
+ * What a search stores about a position: its value (expected penalty of the player to move,
+ * lower = better), how many samples back it, the best card found (or kNoMove) and the
+ * generation of the search that wrote it. Packed in 64 bits.
+ */
+struct TTEntry {
+    static constexpr uint8_t kNoMove = 0xFF;
+
+    float value = 0;
+    uint16_t visits = 0;
+    uint8_t move = kNoMove;
+    uint8_t generation = 0;
+
+    uint64_t pack() const {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<uint64_t>(bits) | static_cast<uint64_t>(visits) << 32 | static_cast<uint64_t>(move) << 48 |
+               static_cast<uint64_t>(generation) << 56;
+    }
+
+    static TTEntry unpack(uint64_t data) {
+        TTEntry entry;
+        const uint32_t bits = static_cast<uint32_t>(data);
+        std::memcpy(&entry.value, &bits, sizeof(bits));
+        entry.visits = static_cast<uint16_t>(data >> 32);
+        entry.move = static_cast<uint8_t>(data >> 48);
+        entry.generation = static_cast<uint8_t>(data >> 56);
+        return entry;
+    }
+};
+
+/**
+ * Fixed-size transposition table shared by the threads of one search, without any lock.
+ *
+ *   Buckets of 4 slots fill one cache line; a key maps to one bucket.
+ *   A slot holds (key ^ data, data) in two relaxed atomics ("lockless hashing"): a reader
+ *   that sees halves of two different writes gets a check that does not match its key
+ *   and takes it as a miss, so no torn entry is ever returned.
+ *   Replacement: the slot of the same key, else an empty one, else the one from the oldest
+ *   generation, fewest visits first. newSearch() starts a generation, so entries of previous
+ *   searches are evicted before the current ones.
+ *
+ * Statistics are striped per thread like the metrics counters. For sizing: a low hit rate
+ * with many evictions means the table is too small; a full table with few evictions is fine.
+ */
+class TranspositionTable {
+public:
+    static constexpr uint64_t kSlots = 4;
+
+    struct Stats {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;       // entries of the current generation overwritten by another key
+        uint64_t fullBuckets = 0;     // misses on a bucket already holding 4 other keys
+
+        double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+    };
+
+    // Size rounded down to a power of two of buckets (at least one)
+    explicit TranspositionTable(uint64_t megabytes) {
+        buckets = 1;
+        while (buckets * 2 * sizeof(Bucket) <= megabytes << 20) {
+            buckets *= 2;
+        }
+        table = std::make_unique<Bucket[]>(buckets);
+    }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(uint64_t key, TTEntry& out) {
+        Counts& counts = stripe();
+        counts.probes.fetch_add(1, std::memory_order_relaxed);
+        Bucket& bucket = table[key & (buckets - 1)];
+        uint64_t occupied = 0;
+        for (Slot& slot : bucket.slots) {
+            const uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if ((check ^ data) == key) {
+                out = TTEntry::unpack(data);
+                counts.hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            occupied += data != 0;
+        }
+        if (occupied == kSlots) {
+            counts.fullBuckets.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    void store(uint64_t key, TTEntry entry) {
+        Counts& counts = stripe();
+        counts.stores.fetch_add(1, std::memory_order_relaxed);
+        entry.generation = currentGeneration.load(std::memory_order_relaxed);
+        Bucket& bucket = table[key & (buckets - 1)];
+
+        Slot* victim = nullptr;
+        uint64_t victimCost = ~0ULL;
+        for (Slot& slot : bucket.slots) {
+            const uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if (data == 0 || (check ^ data) == key) {
+                victim = &slot;
+                victimCost = 0;
+                break;
+            }
+            // Coût de remplacement : génération récente d'abord, puis nombre de visites
+            const TTEntry old = TTEntry::unpack(data);
+            const uint64_t age = static_cast<uint8_t>(entry.generation - old.generation);
+            const uint64_t cost = age ? 0xFF - age : 0x100 + old.visits;
+            if (cost < victimCost) {
+                victim = &slot;
+                victimCost = cost;
+            }
+        }
+        if (victimCost > 0xFF) {
+            counts.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        const uint64_t data = entry.pack();
+        victim->data.store(data, std::memory_order_relaxed);
+        victim->check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    // Starts a new search: older entries become the first to be replaced
+    void newSearch() { currentGeneration.fetch_add(1, std::memory_order_relaxed); }
+
+    void clear() {
+        for (uint64_t b = 0; b < buckets; ++b) {
+            for (Slot& slot : table[b].slots) {
+                slot.data.store(0, std::memory_order_relaxed);
+                slot.check.store(0, std::memory_order_relaxed);
+            }
+        }
+        for (Counts& counts : stats) {
+            counts.probes = counts.hits = counts.stores = counts.evictions = counts.fullBuckets = 0;
+        }
+    }
+
+    Stats getStats() const {
+        Stats total;
+        for (const Counts& counts : stats) {
+            total.probes += counts.probes.load(std::memory_order_relaxed);
+            total.hits += counts.hits.load(std::memory_order_relaxed);
+            total.stores += counts.stores.load(std::memory_order_relaxed);
+            total.evictions += counts.evictions.load(std::memory_order_relaxed);
+            total.fullBuckets += counts.fullBuckets.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Used slots per thousand, sampled on the first 1000 buckets (at most)
+    uint64_t occupancyPermille() const {
+        const uint64_t sampled = buckets < 1000 ? buckets : 1000;
+        uint64_t used = 0;
+        for (uint64_t b = 0; b < sampled; ++b) {
+            for (const Slot& slot : table[b].slots) {
+                used += slot.data.load(std::memory_order_relaxed) != 0;
+            }
+        }
+        return used * 1000 / (sampled * kSlots);
+    }
+
+    uint64_t getCapacity() const { return buckets * kSlots; }
+    uint64_t getBytes() const { return buckets * sizeof(Bucket); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+    struct alignas(64) Bucket {
+        std::array<Slot, kSlots> slots;
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    struct alignas(64) Counts {
+        std::atomic<uint64_t> probes{0}, hits{0}, stores{0}, evictions{0}, fullBuckets{0};
+    };
+    static constexpr size_t kStripes = 16;
+
+    Counts& stripe() {
+        static std::atomic<size_t> nextStripe{0};
+        thread_local const size_t index = nextStripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return stats[index];
+    }
+
+    uint64_t buckets = 0;
+    std::unique_ptr<Bucket[]> table;
+    std::atomic<uint8_t> currentGeneration{0};
+    std::array<Counts, kStripes> stats;
+};
+
+} // namespace sevens
@@ -0,0 +1,315 @@
+#include "Tuner.hpp"
+#include "CommandLine.hpp"
+#include "Engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+constexpr const char* kCheckpointMagic = "sevens-tune";
+constexpr uint64_t kCheckpointVersion = 1;
+constexpr uint64_t kValidationOffset = 1ULL << 40; // parties de validation : jamais jouées pendant le réglage
+
+double clamp01(double x) { return std::min(1.0, std::max(0.0, x)); }
+
+} // namespace
+
+Tuner::Tuner(const TuneOptions& options) : options(options) {
+    const uint64_t numPlayers = options.opponents.size() + 1;
+    if (numPlayers < kMinPlayers || numPlayers > kMaxPlayers) {
+        throw std::runtime_error("[Tuner] Number of players must be between 3 and 7.");
+    }
+    // c = 0 annule le dénominateur du gradient SPSA : tous les paramètres deviendraient NaN
+    if (!(options.step > 0 && std::isfinite(options.step)) || !(options.perturbation > 0 && std::isfinite(options.perturbation))) {
+        throw std::runtime_error("[Tuner] step and perturbation must be finite and greater than 0.");
+    }
+    tuned = StrategyLibrary::open(options.library);
+    auto describe = reinterpret_cast<StrategyParametersFn>(tuned->findSymbol("strategyParameters"));
+    setParameters = reinterpret_cast<SetStrategyParametersFn>(tuned->findSymbol("setStrategyParameters"));
+    if (!describe || !setParameters) {
+        throw std::runtime_error("[Tuner] " + options.library +
+                                 " does not export strategyParameters / setStrategyParameters.");
+    }
+    const StrategyParameter* specs = nullptr;
+    const uint64_t count = describe(&specs);
+    if (count == 0 || !specs) {
+        throw std::runtime_error("[Tuner] " + options.library + " exposes no parameter.");
+    }
+    parameters.assign(specs, specs + count);
+    for (const StrategyParameter& p : parameters) {
+        theta.push_back(p.max > p.min ? clamp01((p.initial - p.min) / (p.max - p.min)) : 0.0);
+    }
+    for (const auto& path : options.opponents) {
+        opponents.push_back(StrategyLibrary::open(path));
+        const auto deterministic =
+            reinterpret_cast<StrategyIsDeterministicFn>(opponents.back()->findSymbol("strategyIsDeterministic"));
+        opponentOwner.push_back(deterministic && deterministic() ? reinterpret_cast<uintptr_t>(opponents.back().get()) : 0);
+    }
+    if (this->options.threads == 0) {
+        this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<double> Tuner::denormalise(const std::vector<double>& x) const {
+    std::vector<double> values(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        values[i] = parameters[i].min + x[i] * (parameters[i].max - parameters[i].min);
+    }
+    return values;
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+std::pair<double, double> Tuner::evaluate(const std::vector<double>& a, const std::vector<double>& b, uint64_t firstGame,
+                                          uint64_t games) {
+    const uint64_t numPlayers = opponents.size() + 1;
+    const std::vector<double> valuesA = denormalise(a);
+    const std::vector<double> valuesB = denormalise(b);
+    std::atomic<uint64_t> nextGame{0};
+    std::mutex mutex;
+    uint64_t rankA = 0, rankB = 0;
+    std::exception_ptr failure;
+
+    // Chaque thread a ses propres instances (les stratégies ne sont pas thread-safe)
+    auto work = [&]() {
+        try {
+            auto candidateA = tuned->create();
+            auto candidateB = tuned->create();
+            setParameters(candidateA.get(), valuesA.data(), valuesA.size());
+            setParameters(candidateB.get(), valuesB.data(), valuesB.size());
+            std::vector<std::shared_ptr<PlayerStrategy>> others;
+            for (const auto& library : opponents) {
+                others.push_back(library->create());
+            }
+
+            // Les deux candidats rejouent les mêmes donnes : les adversaires déterministes
+            // revoient les mêmes questions, leurs réponses sont gardées en cache
+            DecisionCache cache;
+            DecisionMemo memo;
+            memo.cache = &cache;
+
+            uint64_t localA = 0, localB = 0;
+            std::vector<PlayerStrategy*> seats(numPlayers);
+            for (uint64_t g = nextGame++; g < games; g = nextGame++) {
+                // La stratégie réglée change de siège à chaque partie, les adversaires gardent leur ordre
+                const uint64_t tunedSeat = g % numPlayers;
+                for (const bool first : {true, false}) {
+                    PlayerStrategy* candidate = first ? candidateA.get() : candidateB.get();
+                    for (uint64_t seat = 0, o = 0; seat < numPlayers; ++seat) {
+                        memo.owner[seat] = seat == tunedSeat ? 0 : opponentOwner[o];
+                        seats[seat] = seat == tunedSeat ? candidate : others[o++].get();
+                        seats[seat]->initialize(seat);
+                    }
+                    Xoshiro256 rng(gameSeed(options.seed, firstGame + g)); // même donne pour les deux candidats
+                    (first ? localA : localB) += playGame(seats, kFullDeck, rng, RoundRules{}, memo).rank[tunedSeat];
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            rankA += localA;
+            rankB += localB;
+            memoStats.merge(cache.getStats());
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failure = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint64_t t = 1; t < options.threads; ++t) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return {static_cast<double>(rankA) / games, static_cast<double>(rankB) / games};
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void Tuner::saveCheckpoint(uint64_t iteration) const {
+    // Écriture dans un fichier temporaire puis rename : un arrêt brutal laisse l'ancien point de reprise intact
+    const std::string temporary = options.checkpoint + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << std::setprecision(17);
+        out << kCheckpointMagic << " " << kCheckpointVersion << "\n";
+        out << "seed " << options.seed << "\n";
+        out << "iteration " << iteration << "\n";
+        out << "theta " << theta.size();
+        for (double x : theta) {
+            out << " " << x;
+        }
+        out << "\n";
+        if (!out) {
+            throw std::runtime_error("[Tuner] Cannot write checkpoint " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), options.checkpoint.c_str()) != 0) {
+        throw std::runtime_error("[Tuner] Cannot replace checkpoint " + options.checkpoint);
+    }
+}
+
+uint64_t Tuner::loadCheckpoint() {
+    std::ifstream in(options.checkpoint);
+    std::string magic, key;
+    uint64_t version = 0, iteration = 0, count = 0;
+    if (!(in >> magic >> version) || magic != kCheckpointMagic || version != kCheckpointVersion) {
+        throw std::runtime_error("[Tuner] " + options.checkpoint + " is not a tuning checkpoint.");
+    }
+    in >> key >> options.seed >> key >> iteration >> key >> count;
+    if (!in || count != theta.size()) {
+        throw std::runtime_error("[Tuner] " + options.checkpoint + " does not match the parameters of " + options.library);
+    }
+    for (double& x : theta) {
+        in >> x;
+        x = clamp01(x);
+    }
+    if (!in) {
+        throw std::runtime_error("[Tuner] " + options.checkpoint + " is truncated.");
+    }
+    return iteration;
+}
+
+void Tuner::printVector(const char* label, const std::vector<double>& x) const {
+    const std::vector<double> values = denormalise(x);
+    std::cout << label;
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::cout << " " << parameters[i].name << "=" << std::fixed << std::setprecision(3) << values[i];
+    }
+    std::cout << "\n";
+}
+
+void Tuner::run() {
+    const uint64_t start = options.resume ? loadCheckpoint() : 0;
+    const std::vector<double> initial = theta;
+    const uint64_t numPlayers = opponents.size() + 1;
+    std::cout << "[tune] SPSA on " << parameters.size() << " parameters of " << options.library << ", " << numPlayers
+              << " players, " << options.games << " games per candidate, " << options.threads << " threads, seed "
+              << options.seed << (start ? ", resumed at iteration " + std::to_string(start) : "") << "\n";
+    printVector("[tune] start:", theta);
+
+    // Gains standards de Spall : a_k = a / (k + 1 + A)^0.602, c_k = c / (k + 1)^0.101
+    const double stability = 0.1 * static_cast<double>(options.iterations);
+    for (uint64_t k = start; k < options.iterations; ++k) {
+        const auto begin = std::chrono::steady_clock::now();
+        const double ak = options.step / std::pow(static_cast<double>(k) + 1 + stability, 0.602);
+        const double ck = options.perturbation / std::pow(static_cast<double>(k) + 1, 0.101);
+
+        Xoshiro256 directions(gameSeed(~options.seed, k));
+        std::vector<double> delta(theta.size()), plus(theta.size()), minus(theta.size());
+        for (size_t i = 0; i < theta.size(); ++i) {
+            delta[i] = directions() >> 63 ? 1.0 : -1.0;
+            plus[i] = clamp01(theta[i] + ck * delta[i]);
+            minus[i] = clamp01(theta[i] - ck * delta[i]);
+        }
+
+        const auto [fPlus, fMinus] = evaluate(plus, minus, k * options.games, options.games);
+        for (size_t i = 0; i < theta.size(); ++i) {
+            theta[i] = clamp01(theta[i] - ak * (fPlus - fMinus) / (2 * ck * delta[i]));
+        }
+        saveCheckpoint(k + 1);
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "[tune] iteration " << std::setw(3) << k + 1 << "/" << options.iterations << "  mean rank "
+                  << std::fixed << std::setprecision(3) << fPlus << " / " << fMinus << "  (" << std::setprecision(0)
+                  << 2 * options.games / seconds << " games/s)\n";
+        printVector("[tune]   theta:", theta);
+    }
+
+    // Validation sur des donnes jamais vues : réglé contre point de départ de ce lancement, mêmes parties
+    const uint64_t validationGames = 4 * options.games;
+    const auto [tunedRank, initialRank] = evaluate(theta, initial, kValidationOffset, validationGames);
+    printVector("[tune] tuned:", theta);
+    std::cout << "[tune] validation on " << validationGames << " games: mean rank " << std::fixed
+              << std::setprecision(3) << tunedRank << " tuned vs " << initialRank << " at start (checkpoint "
+              << options.checkpoint << ")\n";
+    if (memoStats.lookups > 0) {
+        std::cout << "[tune] decision cache of deterministic opponents: " << std::setprecision(1)
+                  << 100.0 * memoStats.hits / memoStats.lookups << "% hits of " << memoStats.lookups << " lookups, about "
+                  << std::setprecision(2) << memoStats.savedSeconds() << " s of strategy calls saved\n";
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int runTuneMode(int argc, char* argv[]) {
+    TuneOptions options;
+    options.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<std::string> libraries;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            if (!cli::parseCount("[tune]", arg, argv[++i], options.iterations)) {
+                return 1;
+            }
+        } else if (arg == "--games" && i + 1 < argc) {
+            if (!cli::parseCount("[tune]", arg, argv[++i], options.games)) {
+                return 1;
+            }
+            options.games = std::max<uint64_t>(1, options.games);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!cli::parseCount("[tune]", arg, argv[++i], options.threads)) {
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!cli::parseCount("[tune]", arg, argv[++i], options.seed)) {
+                return 1;
+            }
+        } else if (arg == "--step" && i + 1 < argc) {
+            if (!cli::parseReal("[tune]", arg, argv[++i], options.step)) {
+                return 1;
+            }
+        } else if (arg == "--perturbation" && i + 1 < argc) {
+            if (!cli::parseReal("[tune]", arg, argv[++i], options.perturbation)) {
+                return 1;
+            }
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint = argv[++i];
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else {
+            libraries.push_back(arg);
+        }
+    }
+
+    if (libraries.size() < kMinPlayers || libraries.size() > kMaxPlayers) {
+        std::cerr << "[main] Usage: ./sevens_game tune <lib> <opponent libs...> [--iterations K] [--games N] [--threads T]\n"
+                  << "       [--seed S] [--step a] [--perturbation c] [--checkpoint file] [--resume]\n"
+                  << "       (3 to 7 libraries in total, the first one exporting strategyParameters)\n";
+        return 1;
+    }
+    if (options.step <= 0 || options.perturbation <= 0) {
+        std::cerr << "[tune] --step and --perturbation must be greater than 0.\n";
+        return 1;
+    }
+    options.library = libraries.front();
+    options.opponents.assign(libraries.begin() + 1, libraries.end());
+
+    try {
+        Tuner tuner(options);
+        tuner.run();
+    } catch (const std::exception& e) {
+        std::cerr << "[main] Tuning failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace sevens
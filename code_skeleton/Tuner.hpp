@@ -0,0 +1,73 @@
+#pragma once
+
+#include "DecisionCache.hpp"
+#include "PlayerStrategy.hpp"
+#include "StrategyLoader.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Settings of a tuning run ("tune" mode of sevens_game).
+ */
+struct TuneOptions {
+    std::string library;                // strategy exporting strategyParameters / setStrategyParameters
+    std::vector<std::string> opponents; // the other seats (2 to 6 libraries)
+    uint64_t iterations = 30;
+    uint64_t games = 1000;              // games per candidate and per iteration
+    uint64_t threads = 0;               // 0 = one per core
+    uint64_t seed = 0;
+    double step = 0.02;                 // SPSA gain a (parameters normalised to [0, 1])
+    double perturbation = 0.1;          // SPSA gain c
+    std::string checkpoint = "tune.ckpt";
+    bool resume = false;
+};
+
+/**
+ * SPSA (simultaneous perturbation stochastic approximation) over a strategy's exported weights.
+ *
+ * Every iteration draws one random ±1 direction, plays the same games (same deals, the tuned
+ * strategy rotating through the seats) with theta + c*delta and theta - c*delta, and steps
+ * against the difference of mean ranks: two evaluations per iteration whatever the number
+ * of parameters. Common random numbers make that difference far less noisy than two
+ * independent samples. Games are spread over all cores; the state is checkpointed after
+ * every iteration.
+ */
+class Tuner {
+public:
+    // @throws std::runtime_error if the library has no tuning interface or the line-up is not 3 to 7 players.
+    explicit Tuner(const TuneOptions& options);
+
+    void run();
+
+private:
+    // Real parameter values of a point of [0, 1]^d
+    std::vector<double> denormalise(const std::vector<double>& x) const;
+
+    // Mean rank of the tuned strategy with parameters a and b on the same games (lower = better)
+    std::pair<double, double> evaluate(const std::vector<double>& a, const std::vector<double>& b, uint64_t firstGame,
+                                       uint64_t games);
+
+    void saveCheckpoint(uint64_t iteration) const;
+    uint64_t loadCheckpoint();
+    void printVector(const char* label, const std::vector<double>& x) const;
+
+    TuneOptions options;
+    std::shared_ptr<StrategyLibrary> tuned;
+    std::vector<std::shared_ptr<StrategyLibrary>> opponents;
+    std::vector<uint64_t> opponentOwner; // clé de cache des adversaires déterministes, 0 sinon
+    DecisionCache::Stats memoStats;
+    SetStrategyParametersFn setParameters = nullptr;
+    std::vector<StrategyParameter> parameters;
+    std::vector<double> theta; // normalisé dans [0, 1]
+};
+
+// Entry point of "./sevens_game tune <lib> <opponent libs...> [--iterations K] [--games N] [--threads T]
+//                 [--seed S] [--step a] [--perturbation c] [--checkpoint file] [--resume]"
+int runTuneMode(int argc, char* argv[]);
+
+} // namespace sevens
@@ -0,0 +1,466 @@
+#pragma once
+
+#include "BatchSimulator.hpp"
+#include "GameState.hpp"
+#include "PlayerStrategy.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Card set of any size, in the 16-bit-lane layout of GameState.hpp:
+ * card (row, rank) is bit row * 16 + rank, rows are spread 4 per 64-bit word.
+ * A shift by one never leaves its lane, so every rule works word by word and
+ * CardSet<1> compiles to the plain uint64_t code of the standard game.
+ */
+template <uint64_t Words>
+struct CardSet {
+    std::array<uint64_t, Words> words{};
+
+    static constexpr uint64_t kBits = Words * 64;
+
+    constexpr void set(uint64_t position) { words[position / 64] |= 1ULL << (position % 64); }
+    constexpr bool test(uint64_t position) const { return (words[position / 64] >> (position % 64)) & 1ULL; }
+
+    constexpr bool empty() const {
+        uint64_t any = 0;
+        for (uint64_t w = 0; w < Words; ++w) {
+            any |= words[w];
+        }
+        return any == 0;
+    }
+
+    uint64_t count() const {
+        uint64_t total = 0;
+        for (uint64_t w = 0; w < Words; ++w) {
+            total += cardCount(words[w]);
+        }
+        return total;
+    }
+
+    constexpr CardSet operator&(const CardSet& other) const {
+        CardSet out;
+        for (uint64_t w = 0; w < Words; ++w) {
+            out.words[w] = words[w] & other.words[w];
+        }
+        return out;
+    }
+
+    constexpr CardSet operator|(const CardSet& other) const {
+        CardSet out;
+        for (uint64_t w = 0; w < Words; ++w) {
+            out.words[w] = words[w] | other.words[w];
+        }
+        return out;
+    }
+};
+
+/**
+ * Compile-time description of a Sevens variant.
+ *   Suits suits of Ranks ranks (<= 15), Decks copies of every card,
+ *   StartRank = the "7" put on the table at the start of a round,
+ *   up to MaxPlayers players (<= 16), game over once someone reaches EndScore.
+ *
+ * Copies of a card are the same card: each deck opens its own row of the suit
+ * on the table (row = deck * Suits + suit), and a held card may go on any row
+ * of its suit where it fits (a neighbour down, the card not yet there), the
+ * lowest such row first. The hand keeps the row a copy was dealt from only to
+ * tell the copies apart. With one deck, row = suit and the rule is playableMask().
+ */
+template <uint64_t Suits, uint64_t Ranks, uint64_t Decks = 1, uint64_t MaxPlayers = kMaxPlayers,
+          uint64_t StartRank = Ranks / 2, uint64_t EndScore = kEndScore>
+struct Variant {
+    static_assert(Suits >= 1 && Decks >= 1, "A variant needs at least one suit row");
+    static_assert(Ranks >= 2 && Ranks < kSuitStride, "Ranks must fit in a 16-bit lane with one spare bit");
+    static_assert(StartRank < Ranks, "The start rank must be one of the ranks");
+    static_assert(MaxPlayers >= kMinPlayers && MaxPlayers <= 16, "Variants are played by 3 to 16 players");
+
+    static constexpr uint64_t kSuits = Suits;
+    static constexpr uint64_t kRanks = Ranks;
+    static constexpr uint64_t kDecks = Decks;
+    static constexpr uint64_t kRows = Suits * Decks;
+    static constexpr uint64_t kWords = (kRows + 3) / 4;
+    static constexpr uint64_t kCards = kRows * Ranks;
+    static constexpr uint64_t kMaxPlayers = MaxPlayers;
+    static constexpr uint64_t kStartRank = StartRank;
+    static constexpr uint64_t kEndScore = EndScore;
+
+    using Cards = CardSet<kWords>;
+
+    static constexpr Cards lanes(uint64_t laneBits) {
+        Cards cards;
+        for (uint64_t row = 0; row < kRows; ++row) {
+            cards.words[row / 4] |= laneBits << (row % 4 * kSuitStride);
+        }
+        return cards;
+    }
+
+    static constexpr Cards kFullDeck = lanes((1ULL << Ranks) - 1);
+    static constexpr Cards kStartCards = lanes(1ULL << StartRank);
+
+    // Card positions in ascending order, the order GameState::deal draws from
+    static constexpr std::array<uint16_t, kCards> makePositions() {
+        std::array<uint16_t, kCards> positions{};
+        uint64_t i = 0;
+        for (uint64_t row = 0; row < kRows; ++row) {
+            for (uint64_t rank = 0; rank < Ranks; ++rank) {
+                positions[i++] = static_cast<uint16_t>(row * kSuitStride + rank);
+            }
+        }
+        return positions;
+    }
+
+    static constexpr std::array<uint16_t, kCards> kPositions = makePositions();
+
+    static constexpr uint64_t suitOf(uint64_t position) { return position / kSuitStride % Suits; }
+
+    static constexpr uint64_t lane(const Cards& cards, uint64_t row) {
+        return (cards.words[row / 4] >> (row % 4 * kSuitStride)) & 0xFFFFULL;
+    }
+
+    // Ranks a row can take: a neighbour on the table, the card not there yet (a held start card always fits)
+    static constexpr uint64_t openRanks(uint64_t rowBits) {
+        return (((rowBits << 1) | (rowBits >> 1)) & ((1ULL << Ranks) - 1)) & (~rowBits | (1ULL << StartRank));
+    }
+
+    // Same rule as playableMask(): word by word for one deck, through the rows of each suit otherwise
+    static Cards playable(const Cards& hand, const Cards& table) {
+        Cards out;
+        if constexpr (Decks == 1) {
+            for (uint64_t w = 0; w < kWords; ++w) {
+                const uint64_t t = table.words[w];
+                out.words[w] = hand.words[w] &
+                               ((((t << 1) | (t >> 1)) & kFullDeck.words[w]) | (kStartCards.words[w] & ~t));
+            }
+        } else {
+            std::array<uint64_t, Suits> open{};
+            for (uint64_t row = 0; row < kRows; ++row) {
+                open[row % Suits] |= openRanks(lane(table, row));
+            }
+            for (uint64_t row = 0; row < kRows; ++row) {
+                out.words[row / 4] |= (lane(hand, row) & open[row % Suits]) << (row % 4 * kSuitStride);
+            }
+        }
+        return out;
+    }
+
+    // Table position a card of the hand goes to if playable, otherwise the first row of its suit still missing it
+    static uint64_t target(const Cards& table, uint64_t position) {
+        if constexpr (Decks == 1) {
+            return position;
+        } else {
+            const uint64_t rank = position % kSuitStride;
+            for (uint64_t row = suitOf(position); row < kRows; row += Suits) {
+                if ((openRanks(lane(table, row)) >> rank) & 1ULL) {
+                    return row * kSuitStride + rank;
+                }
+            }
+            for (uint64_t row = suitOf(position); row < kRows; row += Suits) {
+                if (!((lane(table, row) >> rank) & 1ULL)) {
+                    return row * kSuitStride + rank;
+                }
+            }
+            return position;
+        }
+    }
+
+    static std::string describe() {
+        return std::to_string(Decks) + "x" + std::to_string(Suits) + "x" + std::to_string(Ranks) + " (" +
+               std::to_string(kCards) + " cards)";
+    }
+};
+
+// The game of MyGameMapper: one 52-card deck, 7s to start, 3 to 7 players, 50 points
+using StandardVariant = Variant<4, 13>;
+static_assert(StandardVariant::kWords == 1 && StandardVariant::kFullDeck.words[0] == kFullDeck &&
+                  StandardVariant::kStartCards.words[0] == kSevensMask,
+              "The standard variant must match GameState.hpp");
+
+/**
+ * Outcome of a variant game (up to 16 players), ranked like makeOutcome().
+ */
+template <uint64_t MaxPlayers>
+struct VariantOutcome {
+    std::array<uint8_t, MaxPlayers> rank{};
+    std::array<uint16_t, MaxPlayers> points{};
+    uint8_t numPlayers = 0;
+    uint16_t rounds = 0;
+    uint16_t stalledRounds = 0;
+    uint64_t turns = 0;
+};
+
+/**
+ * Sevens engine for a compile-time variant, with the rules of Engine: a round
+ * ends when a hand is empty, or is settled as stalled after rules.stallLimit
+ * turns in a row without a card played.
+ *
+ * Seats are either the built-in policies of the batch simulator, played on card
+ * sets, or PlayerStrategy instances, initialized at every game. Strategies see
+ * every row of the table as a suit of its own (Suits * Decks of them, the same
+ * as the suits with one deck) and each held card on the row it would go to, so
+ * the usual neighbour test tells them which cards are playable; a card that
+ * does not fit is a pass, as in Engine. For StandardVariant,
+ * the policies and a XorShift64 seeded with batchGameSeed replay
+ * BatchSimulator::playReference, and strategies with the generator of playGame
+ * replay playGame.
+ */
+template <class V>
+class VariantEngine {
+public:
+    using Cards = typename V::Cards;
+    using Outcome = VariantOutcome<V::kMaxPlayers>;
+    using Layout = std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>;
+
+    /**
+     * @param policies One built-in policy per player.
+     * @throws std::runtime_error if the number of players is not between 3 and V::kMaxPlayers.
+     */
+    explicit VariantEngine(const std::vector<BatchPolicy>& policies, const RoundRules& rules = {})
+        : numPlayers(policies.size()), rules(rules) {
+        checkPlayers();
+        std::copy(policies.begin(), policies.end(), this->policies.begin());
+    }
+
+    /**
+     * @param strategies One strategy per player, not owned.
+     * @throws std::runtime_error if the number of players is not between 3 and V::kMaxPlayers.
+     */
+    explicit VariantEngine(const std::vector<PlayerStrategy*>& strategies, const RoundRules& rules = {})
+        : numPlayers(strategies.size()), rules(rules) {
+        checkPlayers();
+        std::copy(strategies.begin(), strategies.end(), this->strategies.begin());
+        hasStrategies = true;
+    }
+
+    template <class URBG>
+    Outcome play(URBG& rng) {
+        points.fill(0);
+        turns = 0;
+        stalledRounds = 0;
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            if (strategies[p]) {
+                strategies[p]->initialize(p);
+            }
+        }
+        uint64_t rounds = 0;
+        bool gameOver = false;
+        while (!gameOver) {
+            playRound(rng);
+            ++rounds;
+            gameOver = std::any_of(points.begin(), points.begin() + numPlayers,
+                                   [](uint16_t p) { return p >= V::kEndScore; });
+        }
+        return outcome(rounds);
+    }
+
+    // Number of turns of the last game
+    uint64_t getTurns() const { return turns; }
+
+private:
+    void checkPlayers() const {
+        if (numPlayers < kMinPlayers || numPlayers > V::kMaxPlayers) {
+            throw std::runtime_error("[VariantEngine] Number of players must be between 3 and " +
+                                     std::to_string(V::kMaxPlayers) + ".");
+        }
+    }
+
+    template <class URBG>
+    void playRound(URBG& rng) {
+        std::array<uint16_t, V::kCards> cards = V::kPositions;
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            hands[p] = Cards{};
+        }
+        dealShuffled(cards.data(), V::kCards, numPlayers, rng, [this](uint64_t player, uint16_t card) { hands[player].set(card); });
+        table = V::kStartCards;
+        if (hasStrategies) {
+            layout.clear();
+            for (uint64_t row = 0; row < V::kRows; ++row) {
+                layout[row][V::kStartRank] = true;
+            }
+        }
+
+        uint64_t idleTurns = 0;
+        for (uint64_t current = 0;; current = current + 1 == numPlayers ? 0 : current + 1) {
+            ++turns;
+            const Cards playable = V::playable(hands[current], table);
+            int64_t chosen = -1;
+            if (strategies[current]) {
+                chosen = askStrategy(current, playable);
+            } else {
+                chosen = policies[current] == BatchPolicy::Greedy ? pickGreedy(playable) : pickRandom(playable, rng);
+            }
+            idleTurns = chosen >= 0 ? 0 : idleTurns + 1;
+            if (chosen >= 0) {
+                const uint64_t position = static_cast<uint64_t>(chosen);
+                hands[current].words[position / 64] &= ~(1ULL << (position % 64));
+                const uint64_t placed = V::target(table, position);
+                table.set(placed);
+                notify(current, static_cast<int64_t>(placed));
+                if (hands[current].empty()) {
+                    break;
+                }
+            } else {
+                notify(current, -1);
+            }
+            if (rules.stallLimit && idleTurns >= rules.stallLimit) {
+                ++stalledRounds; // manche bloquée : comptée comme une manche normale
+                break;
+            }
+        }
+
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            points[p] = static_cast<uint16_t>(points[p] + hands[p].count());
+        }
+    }
+
+    // Position chosen by the strategy of `player` if it is playable; -1 = pass
+    int64_t askStrategy(uint64_t player, const Cards& playable) {
+        if (rules.fastForward && playable.count() <= 1) {
+            return onlyCard(playable); // aucun choix : la stratégie n'est pas appelée
+        }
+        handCards.clear();
+        handPositions.clear();
+        for (uint64_t w = 0; w < V::kWords; ++w) {
+            for (uint64_t rest = hands[player].words[w]; rest; rest &= rest - 1) {
+                const uint64_t position = w * 64 + lowestCard(rest);
+                const uint64_t shown = V::target(table, position);
+                handCards.emplace_back(shown / kSuitStride, shown % kSuitStride);
+                handPositions.push_back(position);
+            }
+        }
+        const int index = strategies[player]->selectCardToPlay(handCards, layout);
+        if (index < 0 || static_cast<size_t>(index) >= handPositions.size() || !playable.test(handPositions[index])) {
+            return -1;
+        }
+        return static_cast<int64_t>(handPositions[index]);
+    }
+
+    // Only playable card (or -1), for a fast-forwarded turn
+    static int64_t onlyCard(const Cards& playable) {
+        for (uint64_t w = 0; w < V::kWords; ++w) {
+            if (playable.words[w]) {
+                return static_cast<int64_t>(w * 64 + lowestCard(playable.words[w]));
+            }
+        }
+        return -1;
+    }
+
+    // `position` = table position of the card played, -1 = pass
+    void notify(uint64_t player, int64_t position) {
+        if (!hasStrategies) {
+            return;
+        }
+        Card card;
+        if (position >= 0) {
+            card = Card(static_cast<uint64_t>(position) / kSuitStride, static_cast<uint64_t>(position) % kSuitStride);
+            layout[card.suit][card.rank] = true;
+        }
+        for (uint64_t p = 0; p < numPlayers; ++p) {
+            if (p != player && strategies[p]) {
+                if (position >= 0) {
+                    strategies[p]->observeMove(player, card);
+                } else {
+                    strategies[p]->observePass(player);
+                }
+            }
+        }
+    }
+
+    // Highest playable rank except the Ace (like greedyPick), lowest row on ties; -1 = pass
+    static int64_t pickGreedy(const Cards& playable) {
+        uint64_t ranks = 0;
+        for (uint64_t w = 0; w < V::kWords; ++w) {
+            const uint64_t word = playable.words[w];
+            ranks |= word | word >> 16 | word >> 32 | word >> 48;
+        }
+        ranks &= ((1ULL << V::kRanks) - 1) & ~1ULL;
+        if (!ranks) {
+            return -1;
+        }
+        const uint64_t rank = 63 - static_cast<uint64_t>(__builtin_clzll(ranks));
+        for (uint64_t w = 0; w < V::kWords; ++w) {
+            const uint64_t candidates = playable.words[w] & suitLanes(1ULL << rank);
+            if (candidates) {
+                return static_cast<int64_t>(w * 64 + lowestCard(candidates));
+            }
+        }
+        return -1;
+    }
+
+    // Uniform among playable cards, same draw as randomPick; -1 = pass
+    template <class URBG>
+    static int64_t pickRandom(const Cards& playable, URBG& rng) {
+        const uint64_t count = playable.count();
+        if (!count) {
+            return -1;
+        }
+        const uint64_t draw = static_cast<uint64_t>(rng()) >> 32;
+        uint64_t k = (draw * count) >> 32;
+        for (uint64_t w = 0; w < V::kWords; ++w) {
+            uint64_t word = playable.words[w];
+            const uint64_t inWord = cardCount(word);
+            if (k < inWord) {
+                for (; k; --k) {
+                    word &= word - 1;
+                }
+                return static_cast<int64_t>(w * 64 + lowestCard(word));
+            }
+            k -= inWord;
+        }
+        return -1;
+    }
+
+    Outcome outcome(uint64_t rounds) const {
+        Outcome result;
+        result.numPlayers = static_cast<uint8_t>(numPlayers);
+        result.rounds = static_cast<uint16_t>(rounds);
+        result.stalledRounds = static_cast<uint16_t>(stalledRounds);
+        result.turns = turns;
+        std::copy(points.begin(), points.end(), result.points.begin());
+
+        // Dernier = plus de points (plus petit ID à égalité), les autres par points croissants (tri stable)
+        uint64_t lastPlaceID = 0;
+        for (uint64_t p = 1; p < numPlayers; ++p) {
+            if (points[p] > points[lastPlaceID]) {
+                lastPlaceID = p;
+            }
+        }
+        std::array<uint8_t, V::kMaxPlayers> order{};
+        std::iota(order.begin(), order.begin() + numPlayers, 0);
+        std::stable_sort(order.begin(), order.begin() + numPlayers,
+                         [&](uint8_t a, uint8_t b) { return points[a] < points[b]; });
+        uint8_t next = 1;
+        for (uint64_t i = 0; i < numPlayers; ++i) {
+            if (order[i] != lastPlaceID) {
+                result.rank[order[i]] = next++;
+            }
+        }
+        result.rank[lastPlaceID] = static_cast<uint8_t>(numPlayers);
+        return result;
+    }
+
+    uint64_t numPlayers;
+    RoundRules rules;
+    std::array<BatchPolicy, V::kMaxPlayers> policies{};
+    std::array<PlayerStrategy*, V::kMaxPlayers> strategies{}; // nullptr : politique intégrée
+    std::array<Cards, V::kMaxPlayers> hands{};
+    std::array<uint16_t, V::kMaxPlayers> points{};
+    Cards table;
+    uint64_t turns = 0;
+    uint64_t stalledRounds = 0;
+    bool hasStrategies = false;
+
+    // Vues passées aux stratégies
+    std::vector<Card> handCards;
+    std::vector<uint64_t> handPositions;
+    Layout layout;
+};
+
+} // namespace sevens
@@ -1,8 +1,19 @@
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
 #include "StrategyLoader.hpp"
 #include "MyGameMapper.hpp"
+#include "Tournament.hpp"
+#include "MatchServer.hpp"
+#include "ResultsStore.hpp"
+#include "PolicyTable.hpp"
+#include "Tuner.hpp"
+#include "Shard.hpp"
+#include "Analyzer.hpp"
+#include "Dataset.hpp"
+#include "ResourceUsage.hpp"
+#include "CommandLine.hpp"
 
 #ifdef STATIC_BUILD 
 // vérifie si la macro STATIC_BUILD a été définie avant la compilation.
@@ -10,6 +21,7 @@
 // Sinon, le code après #else est pris en compte
 #include "RandomStrategy.hpp"
 #include "GreedyStrategy.hpp"
+#include "Benchmarks.hpp"
 #endif
 
 #include "PlayerStrategy.hpp"
@@ -71,24 +83,47 @@ int main(int argc, char* argv[]) {
         #endif
     }
     else if (mode == "competition") {
-        int numPlayers=argc-2;
+        // --store <file> : la partie est ajoutée au fichier de résultats (voir le mode query)
+        // --stall-limit <turns>, --fast-forward : voir sevens::RoundRules
+        std::vector<std::string> libPaths;
+        std::string storePath;
+        sevens::RoundRules rules;
+        for (int i = 2; i < argc; ++i) {
+            if (std::string(argv[i]) == "--store" && i + 1 < argc) {
+                storePath = argv[++i];
+            } else if (std::string(argv[i]) == "--stall-limit" && i + 1 < argc) {
+                if (!sevens::cli::parseCount("[main]", "--stall-limit", argv[++i], rules.stallLimit)) {
+                    return 1;
+                }
+            } else if (std::string(argv[i]) == "--fast-forward") {
+                rules.fastForward = true;
+            } else {
+                libPaths.push_back(argv[i]);
+            }
+        }
+
+        int numPlayers=static_cast<int>(libPaths.size());
         if (numPlayers < 3 || numPlayers > 7) {
             std::cerr << "[main] Competition mode requires between 3 and 7 strategy libraries.\n";
             return 1;
         }
 
-        std::cout << "[main] Starting competition with " << (argc - 2) << " players...\n";
+        std::cout << "[main] Starting competition with " << numPlayers << " players...\n";
     
         //sevens::MyGameMapper mapper;
+        std::vector<std::shared_ptr<sevens::AccountedStrategy>> accountedStrategies;
 
-        for (int i = 2; i < argc; ++i) {
-            std::string libPath = argv[i];
+        for (int i = 0; i < numPlayers; ++i) {
+            std::string libPath = libPaths[i];
             std::cout << "[main] Loading strategy from " << libPath << "...\n";
 
             try {
                 auto strategy = sevens::StrategyLoader::loadFromLibrary(libPath);
                 if (strategy) {
-                    mapper.registerStrategy(i - 2, strategy); // i - 2 car player 0 = argv[2]
+                    // Chaque appel à la stratégie est mesuré (temps CPU, allocations)
+                    auto accounted = std::make_shared<sevens::AccountedStrategy>(strategy);
+                    accountedStrategies.push_back(accounted);
+                    mapper.registerStrategy(i, accounted);
                 } else {
                     std::cerr << "[main] Failed to load strategy from " << libPath << "\n";
                 }
@@ -102,15 +137,92 @@ int main(int argc, char* argv[]) {
             return 1; 
         }
 
+        const uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        mapper.seed(seed);
+        mapper.setRoundRules(rules);
         auto results = mapper.compute_and_display_game(mapper.getRegisteredPlayerCount()); //argc - 2); // Nombre de joueurs = nombre de libs
         std::cout << "[main] Competition Results:\n";
 
         for (const auto& result : results) {
             std::cout << "  " << mapper.getPlayerStrategies().at(result.first)->getName() << "-" << result.first << " -> Final Rank " << result.second << "\n";
         }
+
+        if (mapper.getStalledRounds() > 0 || mapper.getSkippedCalls() > 0) {
+            std::cout << "[main] " << mapper.getStalledRounds() << " of " << mapper.getRoundsPlayed()
+                      << " rounds stopped by the stall limit, " << mapper.getSkippedCalls()
+                      << " forced moves played without calling a strategy\n";
+        }
+
+        std::cout << "[main] Resource usage per strategy:\n";
+        sevens::printUsageHeader();
+        for (size_t i = 0; i < accountedStrategies.size(); ++i) {
+            sevens::printUsageLine(accountedStrategies[i]->getName() + "-" + std::to_string(i), accountedStrategies[i]->getUsage(), 0);
+        }
+
+        if (!storePath.empty()) {
+            try {
+                sevens::ResultsWriter store(storePath);
+                sevens::GameRecord record;
+                record.seed = seed;
+                record.numPlayers = static_cast<uint8_t>(numPlayers);
+                record.rounds = static_cast<uint16_t>(mapper.getRoundsPlayed());
+                for (const auto& result : results) {
+                    record.strategy[result.first] = store.strategyId(mapper.getPlayerStrategies().at(result.first)->getName());
+                    record.rank[result.first] = static_cast<uint8_t>(result.second);
+                    record.points[result.first] = mapper.getGameState().points[result.first];
+                }
+                store.append(record);
+                std::cout << "[main] Result appended to " << storePath << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << "[main] " << e.what() << "\n";
+            }
+        }
+    }
+    else if (mode == "tournament") {
+        return sevens::runTournamentMode(argc, argv);
+    }
+    else if (mode == "shard") {
+        return sevens::runShardMode(argc, argv);
+    }
+    else if (mode == "analyze") {
+        return sevens::runAnalyzeMode(argc, argv);
+    }
+    else if (mode == "dataset") {
+        return sevens::runDatasetMode(argc, argv);
+    }
+    else if (mode == "query") {
+        return sevens::runQueryMode(argc, argv);
+    }
+    else if (mode == "policytable") {
+        return sevens::runPolicyTableMode(argc, argv);
+    }
+    else if (mode == "tune") {
+        return sevens::runTuneMode(argc, argv);
+    }
+    else if (mode == "serve") {
+        return sevens::runServeMode(argc, argv);
+    }
+    else if (mode == "request") {
+        return sevens::runRequestMode(argc, argv);
+    }
+    else if (mode == "alloccheck") {
+        #ifdef STATIC_BUILD
+            return sevens::runAllocationCheck(argc, argv);
+        #else
+            std::cerr << "[main] Alloccheck mode is not available without STATIC_BUILD.\n";
+            return 1;
+        #endif
+    }
+    else if (mode == "bench") {
+        #ifdef STATIC_BUILD
+            return sevens::runBenchmarks(argc, argv);
+        #else
+            std::cerr << "[main] Bench mode is not available without STATIC_BUILD.\n";
+            return 1;
+        #endif
     }else{
         std::cerr << "[main] Unknown mode: " << mode << std::endl;
-        std::cerr << "Available modes : internal, demo, competition\n";
+        std::cerr << "Available modes : internal, demo, competition, tournament, shard, analyze, dataset, serve, request, query, policytable, tune, bench, alloccheck\n";
         std::cerr << "Exiting ...\n";
         return 1;
     }